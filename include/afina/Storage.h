@@ -1,10 +1,40 @@
 #ifndef AFINA_STORAGE_H
 #define AFINA_STORAGE_H
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 
 namespace Afina {
 
+/**
+ * # Metadata stored along with the value
+ */
+struct ItemHeader {
+    // Opaque client flags
+    uint32_t flags;
+
+    // Unique version of the item, changes on every update. 0 if storage doesn't track versions
+    uint64_t cas;
+
+    // Number of bytes in the value
+    std::size_t size;
+};
+
+/**
+ * # Read-only item pinned in memory
+ * Value stays valid as long as the view is alive, even if the item gets updated, deleted or evicted
+ * meanwhile, so it could be sent to the network right from the storage memory without holding any lock
+ */
+struct ItemView {
+    ItemHeader header;
+
+    // header.size bytes of the value
+    std::shared_ptr<const char> value;
+};
+
 /**
  *
  */
@@ -84,6 +114,156 @@ public:
      * @param value output parameter to copy value to
      */
     virtual bool Get(const std::string &key, std::string &value) = 0;
+
+    /**
+     * Same as Put, PutIfAbsent and Set, but association keeps client flags and expires in ttl seconds.
+     * Once it is expired, storage behaves as if the key was never stored. Zero ttl means association
+     * never expires, negative one means it is expired already.
+     *
+     * Default implementations ignore flags and ttl, so storage without metadata support keeps
+     * association until it is evicted and reports zero flags and versions
+     *
+     * @param key to be associated with value
+     * @param value to be assigned for the key
+     * @param flags opaque client flags returned along with the value
+     * @param ttl number of seconds association lives
+     * @param stored_cas optional output parameter for ItemHeader::cas of the stored association
+     */
+    virtual bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas = nullptr) {
+        return report_cas(stored_cas, 0, Put(key, value));
+    }
+    virtual bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                             uint64_t *stored_cas = nullptr) {
+        return report_cas(stored_cas, 0, PutIfAbsent(key, value));
+    }
+    virtual bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas = nullptr) {
+        return report_cas(stored_cas, 0, Set(key, value));
+    }
+
+    /**
+     * Changes time to live of the existing association, see Put above. Returns false if there is no
+     * association for the key
+     *
+     * Default implementation only checks that association exists
+     *
+     * @param key to change ttl for
+     * @param ttl new number of seconds association lives
+     */
+    virtual bool Touch(const std::string &key, int32_t ttl);
+
+    /**
+     * Adds data to the end or to the beginning of the existing value. Flags and ttl of the association
+     * are kept. Returns false if there is no association for the key
+     *
+     * Default implementation copies value out and puts it back with the same flags, so it is not atomic.
+     * Remaining ttl can't be read through this interface, association updated by it never expires
+     *
+     * @param key to update value of
+     * @param data bytes to add
+     * @param stored_cas optional output parameter for ItemHeader::cas of the updated association
+     */
+    virtual bool Append(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr);
+    virtual bool Prepend(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr);
+
+    // Outcome of the update which could fail for different reasons
+    enum class UpdateResult { Stored, NotFound, Exists, NotNumber };
+
+    /**
+     * Treats existing value as decimal 64-bit unsigned number and adds delta to it. Increment wraps
+     * around on overflow, decrement stops at zero. Flags and ttl of the association are kept
+     *
+     * Default implementation copies value out and puts it back with the same flags, so it is not atomic.
+     * Remaining ttl can't be read through this interface, association updated by it never expires
+     *
+     * @param key to update value of
+     * @param delta number to add or subtract
+     * @param value output parameter for the new value
+     * @param stored_cas optional output parameter for ItemHeader::cas of the updated association
+     * @return Stored, NotFound or NotNumber if existing value isn't a number
+     */
+    virtual UpdateResult Increment(const std::string &key, uint64_t delta, uint64_t &value,
+                                   uint64_t *stored_cas = nullptr);
+    virtual UpdateResult Decrement(const std::string &key, uint64_t delta, uint64_t &value,
+                                   uint64_t *stored_cas = nullptr);
+
+    /**
+     * Same as Set but only if the association wasn't updated since its ItemHeader::cas was read
+     *
+     * Default implementation compares versions and sets value separately, so it is not atomic.
+     * Storage that doesn't track versions reports zero cas, so zero cas matches any value
+     *
+     * @param key to be associated with value
+     * @param value to be assigned for the key
+     * @param flags opaque client flags returned along with the value
+     * @param ttl number of seconds association lives
+     * @param cas version of the association seen by the client
+     * @param stored_cas optional output parameter for the new version of the association
+     * @return Stored, NotFound or Exists if association has another version
+     */
+    virtual UpdateResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t flags,
+                                        int32_t ttl, uint64_t cas, uint64_t *stored_cas = nullptr);
+
+    // Gets header and value bytes of the item, see Get below
+    using ItemReader = std::function<void(const ItemHeader &header, const char *value)>;
+
+    /**
+     * Retrive item for the given key
+     * If there is an association for the given key then method calls reader with metadata and value
+     * of the item and returns true. Value is passed as is, without copying, so reader could serialize
+     * it right away. Storage could be locked during the call, reader must not access it
+     *
+     * Default implementation copies value out by Get and reports zero flags
+     *
+     * @param key to retrive item for
+     * @param reader callback to pass item to
+     */
+    virtual bool Get(const std::string &key, const ItemReader &reader) {
+        std::string value;
+        if (!Get(key, value)) {
+            return false;
+        }
+        reader(ItemHeader{0, 0, value.size()}, value.data());
+        return true;
+    }
+
+    /**
+     * Retrive pinned item for the given key
+     * If there is an association for the given key then method makes view point to the item and
+     * returns true, otherwise view isn't changed
+     *
+     * Default implementation copies value into the view
+     *
+     * @param key to retrive item for
+     * @param view output parameter to point to the item
+     */
+    virtual bool Get(const std::string &key, ItemView &view) {
+        std::shared_ptr<std::string> copy;
+        auto read = [&copy, &view](const ItemHeader &header, const char *value) {
+            copy = std::make_shared<std::string>(value, header.size);
+            view.header = header;
+        };
+        if (!Get(key, ItemReader(read))) {
+            return false;
+        }
+        view.value = std::shared_ptr<const char>(copy, copy->data());
+        return true;
+    }
+
+protected:
+    // Writes version of the stored association to the output parameter of the update if it succeeded and
+    // caller asked for it, returns whether it succeeded
+    static bool report_cas(uint64_t *stored_cas, uint64_t cas, bool stored) {
+        if (stored && stored_cas != nullptr) {
+            *stored_cas = cas;
+        }
+        return stored;
+    }
+    static UpdateResult report_cas(uint64_t *stored_cas, uint64_t cas, UpdateResult result) {
+        report_cas(stored_cas, cas, result == UpdateResult::Stored);
+        return result;
+    }
 };
 
 } // namespace Afina
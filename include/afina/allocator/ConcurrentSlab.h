@@ -0,0 +1,150 @@
+#ifndef AFINA_ALLOCATOR_CONCURRENT_SLAB_H
+#define AFINA_ALLOCATOR_CONCURRENT_SLAB_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <afina/concurrency/CoreLocal.h>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Slab allocator for many threads
+ * Same size classes as Slab, but built the way tarantool's slab_cache/mempool are: each core keeps
+ * its own cache (magazine) of free chunks per class, so alloc/free are served without any shared
+ * state most of the time. Caches talk to shared structures only in batches:
+ * - empty cache takes batch of chunks freed by other cores from the class depot, or a whole fresh
+ *   page from the page pool which is then cut into chunks
+ * - cache with too many chunks gives batch of them back to the class depot
+ *
+ * Both depots and page pool are lock-free stacks, so threads never wait for each other.
+ *
+ * Pages once assigned to a class stay there, and up to 2 * batch chunks per class could be kept in
+ * each core cache, so try_alloc could fail while some memory is still free in other caches.
+ *
+ * Allocator instance doesn't take ownership of wrapped memmory and do not delete it
+ * on destruction. So caller must take care of resource cleaup after allocator stop
+ * being needs
+ *
+ * That is thread safe implementation
+ */
+class ConcurrentSlab {
+public:
+    /**
+     * @param base start of the memory area to allocate from, up to 32Gb
+     * @param size number of bytes in the area
+     * @param min_chunk size of the smallest class
+     * @param factor growth factor between neighbour classes, must be > 1
+     * @param page_size number of bytes in the page, clamped to the area size
+     * @param batch number of chunks moved between core cache and shared depot at once
+     * @param cores number of core caches, 0 means number of cores in the system
+     */
+    ConcurrentSlab(void *base, size_t size, size_t min_chunk = 48, double factor = 1.25, size_t page_size = 1 << 16,
+                   size_t batch = 32, size_t cores = 0);
+
+    /**
+     * Returns pointer to the chunk that is able to keep N bytes. Throws AllocError with
+     * AllocErrorType::NoMemory if there is no chunk available
+     * @param N size_t
+     */
+    void *alloc(size_t N);
+
+    /**
+     * Same as alloc, but returns nullptr instead of exception
+     * @param N size_t
+     */
+    void *try_alloc(size_t N) noexcept;
+
+    /**
+     * Returns chunk back to the cache of the current core. Throws AllocError with
+     * AllocErrorType::InvalidFree if pointer doesn't belong to the area
+     * @param p pointer returned by alloc
+     */
+    void free(void *p);
+
+    /**
+     * Number of bytes allocation of N bytes really occupies, 0 if such allocation never succeeds
+     * @param N size_t
+     */
+    size_t chunk_size(size_t N) const;
+
+    /**
+     * Largest allocation that could ever succeed
+     */
+    inline size_t max_alloc() const { return _classes.empty() ? 0 : _classes.back().size; }
+
+private:
+    static const uint32_t npos = UINT32_MAX;
+
+    // Size class, immutable after construction
+    struct klass {
+        // Size of each chunk in the class
+        size_t size;
+
+        // Number of chunks page of the class consists of
+        uint32_t per_page;
+    };
+
+    // Free chunks of one class, linked through the first word of the chunk
+    struct chunk_list {
+        void *head;
+        size_t count;
+    };
+
+    // Cache of one core, list per class
+    struct cache {
+        explicit cache(size_t classes) : lists(classes, chunk_list{nullptr, 0}) {}
+        std::vector<chunk_list> lists;
+    };
+
+    // Returns index of the smallest class that fits N bytes, or _classes.size() if there is none
+    size_t _class_for(size_t N) const;
+
+    // Fills empty list of class k from the depot or from fresh page
+    bool _refill(size_t k, chunk_list &list);
+
+    // Lock-free stack operations. Head keeps modification counter in the upper half, so that element
+    // popped and pushed back in between doesn't break compare-and-swap (ABA). Lower half keeps
+    // reference of the element, 0 means empty stack
+    typedef std::atomic<uint32_t> *(ConcurrentSlab::*next_of)(uint32_t ref);
+    void _push(std::atomic<uint64_t> &head, uint32_t ref, next_of next);
+    uint32_t _pop(std::atomic<uint64_t> &head, next_of next);
+
+    // Page reference is its number + 1, link to the next page is kept outside of the area
+    std::atomic<uint32_t> *_page_next(uint32_t ref);
+
+    // Batch reference is offset of its first chunk in 8 bytes units + 1, link to the next batch
+    // is kept in the second word of the first chunk
+    std::atomic<uint32_t> *_batch_next(uint32_t ref);
+    inline uint32_t _batch_ref(void *p) const { return uint32_t((static_cast<char *>(p) - _start) / 8 + 1); }
+    inline char *_batch_ptr(uint32_t ref) const { return _start + size_t(ref - 1) * 8; }
+
+    inline char *_page_start(uint32_t pg) const { return _start + size_t(pg) * _page_size; }
+
+    char *_start;
+    size_t _page_size;
+    uint32_t _pages;
+    size_t _batch;
+    std::vector<klass> _classes;
+
+    // For each page: class it belongs to, npos while page is in the pool; and link in the pool
+    std::unique_ptr<std::atomic<uint32_t>[]> _page_class;
+    std::unique_ptr<std::atomic<uint32_t>[]> _page_links;
+
+    // Pages that are not assigned to any class
+    std::atomic<uint64_t> _free_pages;
+
+    // For each class: batches of free chunks given back by core caches
+    std::unique_ptr<std::atomic<uint64_t>[]> _depots;
+
+    Concurrency::CoreLocal<cache> _caches;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_CONCURRENT_SLAB_H
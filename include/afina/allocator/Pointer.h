@@ -7,6 +7,13 @@ namespace Allocator {
 // to avoid expensive macros calculations and increase compile speed
 class Simple;
 
+/**
+ * Handle to the memory allocated by Simple. Allocator might move memory block during defragmentation,
+ * so handle doesn't keep address itself but refers to the allocator's table slot that does. Copies of
+ * the handle refer to the same slot.
+ *
+ * Default constructed or freed handle points to nothing, get() returns nullptr
+ */
 class Pointer {
 public:
     Pointer();
@@ -17,7 +24,15 @@ public:
     Pointer &operator=(const Pointer &);
     Pointer &operator=(Pointer &&);
 
-    void *get() const { return 0; }
+    void *get() const { return _slot != nullptr ? *_slot : nullptr; }
+
+private:
+    friend class Simple;
+
+    explicit Pointer(void **slot) : _slot(slot) {}
+
+    // Slot of the allocator's table where current address of the block is kept
+    void **_slot;
 };
 
 } // namespace Allocator
@@ -15,9 +15,16 @@ class Pointer;
  * Wraps given memory area and provides defagmentation allocator interface on
  * the top of it.
  *
+ * Blocks are placed one after another from the beginning of the area, each with a small header.
+ * Table of handle slots grows down from the end of the area, each slot keeps current address of
+ * some block. Clients hold Pointer objects referring to slots, so allocator is free to move blocks
+ * as long as it updates slots.
+ *
  * Allocator instance doesn't take ownership of wrapped memmory and do not delete it
  * on destruction. So caller must take care of resource cleaup after allocator stop
  * being needs
+ *
+ * That is NOT thread safe implementaiton!!
  */
 // TODO: Implements interface to allow usage as C++ allocators
 class Simple {
@@ -25,37 +32,83 @@ public:
     Simple(void *base, const size_t size);
 
     /**
-     * TODO: semantics
+     * Allocates block of at least N bytes using first fit strategy and returns handle to it.
+     * Throws AllocError with AllocErrorType::NoMemory if there is no free space of the required size,
+     * note that allocator doesn't defragment itself, call defrag() and retry if needed
      * @param N size_t
      */
     Pointer alloc(size_t N);
 
     /**
-     * TODO: semantics
+     * Changes size of the block p refers to, preserving its content up to the smaller of old and new
+     * sizes. Block is changed in place if possible: shrink always happens in place, grow does when the
+     * following space is free. Otherwise block moves, p keeps to be valid. Empty p gets new block.
+     *
+     * Throws AllocError with AllocErrorType::NoMemory if there is no space, p stays untouched then
      * @param p Pointer
      * @param N size_t
      */
     void realloc(Pointer &p, size_t N);
 
     /**
-     * TODO: semantics
+     * Releases block p refers to, after that p and all its copies points to nothing. Freeing empty
+     * pointer does nothing. Throws AllocError with AllocErrorType::InvalidFree if p doesn't belong
+     * to this allocator
      * @param p Pointer
      */
     void free(Pointer &p);
 
     /**
-     * TODO: semantics
+     * Moves all allocated blocks to the beginning of the area one after another, so all free space
+     * forms a single piece at the end. All pointers remain valid but addresses they return change
      */
     void defrag();
 
     /**
-     * TODO: semantics
+     * Prints layout of the area: blocks and table
      */
     std::string dump() const;
 
+    /**
+     * Size of the largest block that could be allocated without defragmentation
+     */
+    size_t largest_free() const;
+
+    /**
+     * Total number of free bytes, that is the largest block that could be allocated after defrag
+     */
+    size_t total_free() const;
+
 private:
+    // Header of each block in the area
+    struct block;
+
+    block *_first() const;
+    block *_next(block *b) const;
+
+    // Returns free slot of the table, extending table if necessary, or nullptr if there is no room
+    void **_take_slot();
+
+    // Finds place for N bytes: first fit among free blocks, then the end of the heap. nullptr if none
+    block *_place(size_t N, size_t reserve);
+
+    // Cuts tail of the block into separate free block if it is large enough to be useful
+    void _split(block *b, size_t N);
+
+    // Merges sequence of free blocks started at b into one
+    void _merge_free(block *b);
+
     void *_base;
     const size_t _base_len;
+
+    // End of the last block in the area, all space after that is free up to the table
+    char *_top;
+
+    // Lowest slot of the table, table occupies [_table, end of the area)
+    void **_table;
+
+    // Number of table slots that are not used by any block
+    size_t _free_slots;
 };
 
 } // namespace Allocator
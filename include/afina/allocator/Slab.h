@@ -0,0 +1,143 @@
+#ifndef AFINA_ALLOCATOR_SLAB_H
+#define AFINA_ALLOCATOR_SLAB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Slab allocator
+ * Wraps given memory area and splits it into pages of equal size. Each page, once needed, gets
+ * assigned to some size class and then cut into chunks of that class size. Sizes of classes start at
+ * min_chunk and grow geometrically by factor, the last class is the whole page.
+ *
+ * Area smaller than 16 pages gets smaller pages (down to 1 KB), otherwise few classes would take all
+ * of them and the rest could get memory only once some page is completely released.
+ *
+ * Request of N bytes is served by a chunk of the smallest class that fits N, so per-chunk overhead
+ * is predictable and the area never fragments: freed chunk could be reused by any allocation of the
+ * same class. Page which has no allocated chunks left returns back to the shared pool and could be
+ * reassigned to any other class.
+ *
+ * Allocator instance doesn't take ownership of wrapped memmory and do not delete it
+ * on destruction. So caller must take care of resource cleaup after allocator stop
+ * being needs
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class Slab {
+public:
+    /**
+     * @param base start of the memory area to allocate from
+     * @param size number of bytes in the area
+     * @param min_chunk size of the smallest class
+     * @param factor growth factor between neighbour classes, must be > 1
+     * @param page_size largest number of bytes in the page, see above
+     */
+    Slab(void *base, size_t size, size_t min_chunk = 48, double factor = 1.25, size_t page_size = 1 << 20);
+
+    /**
+     * Returns pointer to the chunk that is able to keep N bytes. Throws AllocError with
+     * AllocErrorType::NoMemory if there is no free chunk in class and no free page left
+     * @param N size_t
+     */
+    void *alloc(size_t N);
+
+    /**
+     * Same as alloc, but returns nullptr instead of exception. Suitable for paths where running out
+     * of memory is expected, for example caches that evict entries until allocation succeeds
+     * @param N size_t
+     */
+    void *try_alloc(size_t N) noexcept;
+
+    /**
+     * Returns chunk back to its class. Throws AllocError with AllocErrorType::InvalidFree if
+     * pointer doesn't belong to the area
+     * @param p pointer returned by alloc
+     */
+    void free(void *p);
+
+    /**
+     * Number of bytes allocation of N bytes really occupies, 0 if such allocation never succeeds
+     * @param N size_t
+     */
+    size_t chunk_size(size_t N) const;
+
+    /**
+     * Largest allocation that could ever succeed
+     */
+    inline size_t max_alloc() const { return _classes.empty() ? 0 : _classes.back().size; }
+
+    /**
+     * Number of bytes in allocated chunks
+     */
+    inline size_t used() const { return _used; }
+
+    /**
+     * Prints pages and classes usage
+     */
+    std::string dump() const;
+
+private:
+    static const uint32_t npos = UINT32_MAX;
+
+    // Meta information for the page, kept out of the area so that chunks stay aligned
+    struct page {
+        // Size class page belongs to, npos if page is free
+        uint32_t klass;
+
+        // Number of allocated chunks in the page
+        uint32_t used;
+
+        // Number of chunks ever cut from the page
+        uint32_t carved;
+
+        // Neighbours in the list of partially used pages of the class, or in the free pages list
+        uint32_t prev, next;
+
+        // Head of list of freed chunks in the page
+        void *free_chunks;
+    };
+
+    // Size class
+    struct klass {
+        // Size of each chunk in the class
+        size_t size;
+
+        // Number of chunks page of the class consists of
+        uint32_t per_page;
+
+        // Head of list of pages having free chunks
+        uint32_t partial;
+
+        // Number of pages assigned to the class
+        uint32_t pages;
+    };
+
+    // Returns index of the smallest class that fits N bytes, or _classes.size() if there is none
+    size_t _class_for(size_t N) const;
+
+    void _list_push(uint32_t &head, uint32_t pg);
+    void _list_remove(uint32_t &head, uint32_t pg);
+
+    inline char *_page_start(uint32_t pg) const { return _start + size_t(pg) * _page_size; }
+
+    char *_start;
+    size_t _page_size;
+    std::vector<page> _pages;
+    std::vector<klass> _classes;
+
+    // Pages that are not assigned to any class
+    uint32_t _free_pages;
+
+    size_t _used;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_SLAB_H
@@ -1,10 +1,130 @@
 #ifndef AFINA_CONCURRENCY_CORE_LOCAL_H
 #define AFINA_CONCURRENCY_CORE_LOCAL_H
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include <sched.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class CoreLocal {};
+/**
+ * # Per core value
+ * Keeps one instance of T for each CPU core. Thread asks for the instance of the core it is running
+ * on right now, so threads on different cores never touch the same memory and the instance is almost
+ * always hot in the local cache.
+ *
+ * Thread could be migrated to another core while it holds the instance, so each instance is guarded by
+ * tiny spin lock. It is uncontended almost all the time; if it is taken anyway, neighbour instance is
+ * used instead. Thus T must not rely on being used by the same core all the time, only on exclusive
+ * access while Guard is alive.
+ */
+template <typename T> class CoreLocal {
+private:
+    static const size_t cache_line = 64;
+
+    struct alignas(cache_line) slot {
+        std::atomic_flag busy;
+        T value;
+
+        template <typename... Args> slot(Args &&... args) : value(std::forward<Args>(args)...) { busy.clear(); }
+    };
+
+public:
+    /**
+     * Exclusive access to one of instances, released on destruction
+     */
+    class Guard {
+    public:
+        Guard(Guard &&other) : _slot(other._slot) { other._slot = nullptr; }
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+        ~Guard() {
+            if (_slot != nullptr) {
+                _slot->busy.clear(std::memory_order_release);
+            }
+        }
+
+        inline T &operator*() const { return _slot->value; }
+        inline T *operator->() const { return &_slot->value; }
+
+    private:
+        friend class CoreLocal;
+        explicit Guard(slot *s) : _slot(s) {}
+
+        slot *_slot;
+    };
+
+    /**
+     * @param size number of instances, 0 means number of cores in the system
+     * @param args passed to constructor of each instance
+     */
+    template <typename... Args> explicit CoreLocal(size_t size, const Args &... args) {
+        _size = size > 0 ? size : std::max(1u, std::thread::hardware_concurrency());
+
+        // operator new doesn't respect over-aligned types before c++17
+        _raw.reset(new char[_size * sizeof(slot) + cache_line]);
+        uintptr_t addr = reinterpret_cast<uintptr_t>(_raw.get());
+        _slots = reinterpret_cast<slot *>((addr + cache_line - 1) & ~uintptr_t(cache_line - 1));
+        for (size_t i = 0; i < _size; i++) {
+            new (&_slots[i]) slot(args...);
+        }
+    }
+
+    CoreLocal(const CoreLocal &) = delete;
+    CoreLocal &operator=(const CoreLocal &) = delete;
+
+    ~CoreLocal() {
+        for (size_t i = 0; i < _size; i++) {
+            _slots[i].~slot();
+        }
+    }
+
+    /**
+     * Returns instance of the current core
+     */
+    Guard local() {
+        int cpu = sched_getcpu();
+        size_t start = cpu < 0 ? 0 : size_t(cpu) % _size;
+        for (;;) {
+            for (size_t i = 0; i < _size; i++) {
+                slot *s = &_slots[(start + i) % _size];
+                if (!s->busy.test_and_set(std::memory_order_acquire)) {
+                    return Guard(s);
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * Returns instance with the given index, waits until it gets released by others
+     */
+    Guard at(size_t i) {
+        slot *s = &_slots[i];
+        while (s->busy.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        return Guard(s);
+    }
+
+    /**
+     * Number of instances
+     */
+    inline size_t size() const { return _size; }
+
+private:
+    size_t _size;
+    std::unique_ptr<char[]> _raw;
+    slot *_slots;
+};
 
 } // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,69 @@
+#ifndef AFINA_CONCURRENCY_SHARED_MUTEX_H
+#define AFINA_CONCURRENCY_SHARED_MUTEX_H
+
+#include <stdexcept>
+
+#include <pthread.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Mutex supporting both unique (write) and shared (read) ownership
+ * C++11 has no std::shared_mutex, this one wraps pthread rwlock. Uncontended lock_shared is a single
+ * atomic increment, so readers don't serialize each other. Writers are preferred: once writer waits,
+ * new readers wait too, so constant stream of reads can't starve updates.
+ *
+ * Could be used with std::unique_lock/std::lock_guard for exclusive ownership and SharedLock for
+ * shared one
+ */
+class SharedMutex {
+public:
+    SharedMutex() {
+        pthread_rwlockattr_t attr;
+        pthread_rwlockattr_init(&attr);
+        pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+        int err = pthread_rwlock_init(&_lock, &attr);
+        pthread_rwlockattr_destroy(&attr);
+        if (err != 0) {
+            throw std::runtime_error("Failed to init rwlock");
+        }
+    }
+    ~SharedMutex() { pthread_rwlock_destroy(&_lock); }
+
+    SharedMutex(const SharedMutex &) = delete;
+    SharedMutex &operator=(const SharedMutex &) = delete;
+
+    // Exclusive ownership
+    inline void lock() { pthread_rwlock_wrlock(&_lock); }
+    inline bool try_lock() { return pthread_rwlock_trywrlock(&_lock) == 0; }
+    inline void unlock() { pthread_rwlock_unlock(&_lock); }
+
+    // Shared ownership
+    inline void lock_shared() { pthread_rwlock_rdlock(&_lock); }
+    inline bool try_lock_shared() { return pthread_rwlock_tryrdlock(&_lock) == 0; }
+    inline void unlock_shared() { pthread_rwlock_unlock(&_lock); }
+
+private:
+    pthread_rwlock_t _lock;
+};
+
+/**
+ * # RAII wrapper for shared ownership, same as std::lock_guard is for exclusive one
+ */
+template <typename Mutex> class SharedLock {
+public:
+    explicit SharedLock(Mutex &m) : _m(m) { _m.lock_shared(); }
+    ~SharedLock() { _m.unlock_shared(); }
+
+    SharedLock(const SharedLock &) = delete;
+    SharedLock &operator=(const SharedLock &) = delete;
+
+private:
+    Mutex &_m;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_SHARED_MUTEX_H
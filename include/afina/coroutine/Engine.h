@@ -42,6 +42,9 @@ private:
         // To include routine in the different lists, such as "alive", "blocked", e.t.c
         struct context *prev = nullptr;
         struct context *next = nullptr;
+
+        // Routine is in the "blocked" list
+        bool is_blocked = false;
     } context;
 
     /**
@@ -87,9 +90,14 @@ protected:
 
     static void null_unblocker(Engine &) {}
 
+    /**
+     * Moves routine from one list to the head of another
+     */
+    static void Move(context *ctx, context *&from, context *&to);
+
 public:
     Engine(unblocker_func unblocker = null_unblocker)
-        : StackBottom(0), cur_routine(nullptr), alive(nullptr), _unblocker(unblocker) {}
+        : StackBottom(0), cur_routine(nullptr), alive(nullptr), blocked(nullptr), _unblocker(unblocker) {}
     Engine(Engine &&) = delete;
     Engine(const Engine &) = delete;
 
@@ -121,7 +129,8 @@ public:
     void block(void *coro = nullptr);
 
     /**
-     * Put coroutine back to list of alive, so that it could be scheduled later
+     * Put coroutine back to list of alive, so that it could be scheduled later. Does nothing if coroutine
+     * isn't blocked
      */
     void unblock(void *coro);
 
@@ -146,7 +155,9 @@ public:
         idle_ctx = new context();
         idle_ctx->Low = idle_ctx->Hight = StackBottom;
         if (setjmp(idle_ctx->Environment) > 0) {
-            if (alive == nullptr) {
+            // Either routine is done or it got blocked and there is no one else to run. Unblocker is the one
+            // who knows when blocked routines could go on, for example once epoll reports their sockets
+            if (alive == nullptr && blocked != nullptr) {
                 _unblocker(*this);
             }
 
@@ -168,7 +179,7 @@ public:
      */
     template <typename... Ta> void *run(void (*func)(Ta...), Ta &&... args) {
         char currentBottom;
-        run_impl(&currentBottom, func, std::forward<Ta>(args)...);
+        return run_impl(&currentBottom, func, std::forward<Ta>(args)...);
     }
 
     template <typename... Ta> void *run_impl(char *currentBottom, void (*func)(Ta...), Ta &&... args) {
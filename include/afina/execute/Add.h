@@ -23,7 +23,7 @@ public:
     Add(const std::string &key, uint32_t flags, int32_t expire) : InsertCommand(key, flags, expire) {}
     ~Add() {}
 
-    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
 };
 
 } // namespace Execute
@@ -0,0 +1,56 @@
+#ifndef AFINA_EXECUTE_ARITHMETIC_COMMAND_H
+#define AFINA_EXECUTE_ARITHMETIC_COMMAND_H
+
+#include <cstdint>
+#include <string>
+
+#include "Command.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Basic class for incr and decr
+ * Value of the item is decimal representation of 64-bit unsigned number, command changes it in the
+ * storage atomically. Increment wraps around on overflow, decrement stops at zero.
+ *
+ * Command must write result to the output, which could be:
+ * - new value of the item
+ * - "NOT_FOUND" to indicate the item with this key was not found
+ * - "CLIENT_ERROR ..." if value of the item isn't a number
+ */
+class ArithmeticCommand : public Command {
+public:
+    ArithmeticCommand(const std::string &key, uint64_t delta, bool decrement)
+        : _key(key), _delta(delta), _decrement(decrement), _create(false), _initial(0), _expire(0) {}
+    ~ArithmeticCommand() {}
+
+    inline const std::string &key() const { return _key; }
+    inline uint64_t delta() const { return _delta; }
+
+    /**
+     * Missing item gets created with the initial value instead of NOT_FOUND response, that is what
+     * binary protocol does
+     */
+    void CreateMissing(uint64_t initial, int32_t expire) {
+        _create = true;
+        _initial = initial;
+        _expire = expire;
+    }
+
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
+
+protected:
+    const std::string _key;
+    const uint64_t _delta;
+    const bool _decrement;
+
+    bool _create;
+    uint64_t _initial;
+    int32_t _expire;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_ARITHMETIC_COMMAND_H
@@ -3,6 +3,8 @@
 
 #include <string>
 
+#include "Response.h"
+
 namespace Afina {
 
 class Storage;
@@ -10,15 +12,16 @@ class Storage;
 namespace Execute {
 
 /**
- *
- *
+ * # Parsed request
+ * Execute runs the request against the storage and reports the outcome to out, which encodes it in the
+ * protocol of the request
  */
 class Command {
 public:
     Command() {}
     virtual ~Command() {}
 
-    virtual void Execute(Storage &storage, const std::string &args, std::string &out) = 0;
+    virtual void Execute(Storage &storage, const std::string &args, Response &out) = 0;
 };
 
 } // namespace Execute
@@ -0,0 +1,25 @@
+#ifndef AFINA_EXECUTE_DECR_H
+#define AFINA_EXECUTE_DECR_H
+
+#include <cstdint>
+#include <string>
+
+#include "ArithmeticCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Decrement value for the key
+ * Delta is subtracted from the value of the item, see ArithmeticCommand
+ */
+class Decr : public ArithmeticCommand {
+public:
+    Decr(const std::string &key, uint64_t delta) : ArithmeticCommand(key, delta, true) {}
+    ~Decr() {}
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_DECR_H
@@ -18,13 +18,14 @@ namespace Execute {
  * the items have been transmitted, the server sends the string
  *
  * Each item sent by the server looks like this:
- * VALUE <key> <bytes>\r\n
+ * VALUE <key> <flags> <bytes>\r\n
  * <data>\r\n
  * VALUE ....
  * END
  *
- * Where <key> is the key for the value, <bytes> is the number of bytes in the
- * value and <data> is the value text
+ * Where <key> is the key for the value, <flags> are the ones given when the
+ * value was stored, <bytes> is the number of bytes in the value and <data> is
+ * the value text
  *
  * If some of the keys appearing in a retrieval request are not sent back
  * by the server in the item list this means that the server does not
@@ -34,15 +35,18 @@ namespace Execute {
  */
 class Get : public Command {
 public:
-    Get(const std::vector<std::string> &keys) : _keys(keys) {}
+    Get(const std::vector<std::string> &keys) : _keys(keys), _cas(false) {}
     ~Get() {}
 
     inline const std::vector<std::string> &keys() const { return _keys; }
 
-    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
 
-private:
+protected:
     std::vector<std::string> _keys;
+
+    // Items are sent with their versions
+    bool _cas;
 };
 
 } // namespace Execute
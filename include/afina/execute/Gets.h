@@ -0,0 +1,28 @@
+#ifndef AFINA_EXECUTE_GETS_H
+#define AFINA_EXECUTE_GETS_H
+
+#include <string>
+#include <vector>
+
+#include "Get.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Retrive values along with their versions
+ * Same as Get, but each item sent by the server has unique version of the item which could be passed
+ * to the Cas command later:
+ * VALUE <key> <flags> <bytes> <cas unique>\r\n
+ * <data>\r\n
+ */
+class Gets : public Get {
+public:
+    Gets(const std::vector<std::string> &keys) : Get(keys) { _cas = true; }
+    ~Gets() {}
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_GETS_H
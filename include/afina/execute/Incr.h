@@ -0,0 +1,25 @@
+#ifndef AFINA_EXECUTE_INCR_H
+#define AFINA_EXECUTE_INCR_H
+
+#include <cstdint>
+#include <string>
+
+#include "ArithmeticCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Increment value for the key
+ * Delta is added to the value of the item, see ArithmeticCommand
+ */
+class Incr : public ArithmeticCommand {
+public:
+    Incr(const std::string &key, uint64_t delta) : ArithmeticCommand(key, delta, false) {}
+    ~Incr() {}
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_INCR_H
@@ -9,6 +9,12 @@
 namespace Afina {
 namespace Execute {
 
+/**
+ * Expiration time of the command converted to ttl of Afina::Storage. Same as in memcached, expire time up
+ * to 30 days is number of seconds from now and anything larger is absolute unix time
+ */
+int32_t expire_ttl(int32_t expire);
+
 /**
  * # Basic class for all insert commands
  *
@@ -22,6 +28,9 @@ public:
     inline const uint32_t flags() const { return _flags; }
     inline const int32_t expire() const { return _expire; }
 
+    // Expiration time converted to ttl of Afina::Storage, see expire_ttl
+    inline int32_t ttl() const { return expire_ttl(_expire); }
+
 protected:
     const std::string _key;
     const uint32_t _flags;
@@ -24,7 +24,7 @@ public:
     Replace(const std::string &key, uint32_t flags, int32_t expire) : InsertCommand(key, flags, expire) {}
     ~Replace() {}
 
-    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
 };
 
 } // namespace Execute
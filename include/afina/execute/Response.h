@@ -0,0 +1,143 @@
+#ifndef AFINA_EXECUTE_RESPONSE_H
+#define AFINA_EXECUTE_RESPONSE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/uio.h>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Output of the connection
+ * Commands report outcome here and network layer sends the response with one writev.
+ *
+ * Commands don't know the protocol of the request: they report results (Result, Value, Miss, End) and
+ * the encoder writes them down. Without encoder set results are written in memcached text protocol,
+ * other protocols install their own encoder for the time of the command.
+ *
+ * Text is accumulated in a single buffer, large values are not copied but referenced by pinned views
+ * of the storage items, so the response is a list of segments pointing either into the buffer or into
+ * the item memory. Buffers keep their capacity after Clear, so once connection warmed up, building
+ * response makes no heap allocations.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class Response {
+public:
+    // Values of this size and smaller are copied into the buffer instead of being referenced
+    static const std::size_t copy_threshold = 512;
+
+    // Outcome of the command that has no data to return
+    enum class Status : uint8_t { Stored, NotStored, Exists, NotFound, Deleted, Touched, NotNumber, Ok };
+
+    /**
+     * # Protocol of the response
+     * Writes results reported by commands into the response
+     */
+    class Encoder {
+    public:
+        virtual ~Encoder() {}
+
+        virtual void Result(Response &out, Status status, uint64_t cas) = 0;
+        virtual void Value(Response &out, const std::string &key, const ItemView &item, bool cas) = 0;
+        virtual void Miss(Response &out, const std::string &key) = 0;
+        virtual void Number(Response &out, uint64_t number, uint64_t cas) = 0;
+        virtual void End(Response &out) = 0;
+    };
+
+    Response(std::size_t capacity = 4096) : _encoder(nullptr) { _buffer.reserve(capacity); }
+
+    Response(const Response &) = delete;
+    Response &operator=(const Response &) = delete;
+
+    // Appends bytes to the response
+    Response &Append(const char *data, std::size_t size);
+    Response &Append(const std::string &str) { return Append(str.data(), str.size()); }
+
+    // Appends literal, size is known at compile time
+    template <std::size_t N> Response &Append(const char (&str)[N]) { return Append(str, N - 1); }
+
+    // Appends decimal representation of the number
+    Response &Append(uint64_t number);
+
+    // Appends value of the item, large one is kept pinned until it is sent
+    Response &Append(const ItemView &view);
+
+    // Encoder of the results reported from now on, nullptr means text protocol
+    inline void SetEncoder(Encoder *encoder) { _encoder = encoder; }
+
+    // Command finished without data to return, cas is the version of the item it has stored if any. Text
+    // protocol doesn't send it
+    void Result(Status status, uint64_t cas = 0);
+
+    // Item found for the key, cas tells if client asked for its version
+    void Value(const std::string &key, const ItemView &item, bool cas = false);
+
+    // There is no item for the key
+    void Miss(const std::string &key);
+
+    // New value of the counter and the version of the item it is stored in
+    void Number(uint64_t number, uint64_t cas = 0);
+
+    // All the items are reported
+    void End();
+
+    // Everything appended since the last Clear or Consume is sent
+    inline bool Empty() const { return _size == 0; }
+
+    // Number of bytes to be sent
+    inline std::size_t Size() const { return _size; }
+
+    /**
+     * Segments to be passed to writev. Pointers are valid until the next modification of the response,
+     * number of segments could exceed IOV_MAX
+     */
+    const struct iovec *Iov();
+    std::size_t IovCount() const { return _segments.size() - _first; }
+
+    // Drops first n bytes that were sent already
+    void Consume(std::size_t n);
+
+    // Drops everything
+    void Clear();
+
+    // Copy of the whole response, for tests mostly
+    std::string str() const;
+
+private:
+    // Range of the buffer if data is nullptr, pinned value otherwise
+    struct segment {
+        const char *data;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    Encoder *_encoder;
+
+    std::string _buffer;
+    std::vector<segment> _segments;
+    std::vector<std::shared_ptr<const char>> _pins;
+    std::vector<struct iovec> _iov;
+
+    // Index of the first segment not sent yet
+    std::size_t _first = 0;
+    std::size_t _size = 0;
+};
+
+/**
+ * Writes decimal representation of the number to out, which must have room for 20 chars. Returns
+ * pointer past the last written char
+ */
+char *format_uint(uint64_t number, char *out);
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_RESPONSE_H
@@ -0,0 +1,25 @@
+#ifndef AFINA_LOGGING_TRACE_H
+#define AFINA_LOGGING_TRACE_H
+
+#include <spdlog/logger.h>
+
+/**
+ * # Tracing of the hot paths
+ * AFINA_TRACE(logger, fmt, args...) writes message at trace level. Release builds don't define
+ * AFINA_TRACE_ON, so the call is compiled out together with its arguments. Otherwise it costs one
+ * check of the logger level, arguments are evaluated only if trace is enabled for the logger
+ */
+#ifdef AFINA_TRACE_ON
+#define AFINA_TRACE(logger, ...)                                                                                       \
+    do {                                                                                                               \
+        if ((logger)->should_log(spdlog::level::trace)) {                                                              \
+            (logger)->trace(__VA_ARGS__);                                                                              \
+        }                                                                                                              \
+    } while (false)
+#else
+#define AFINA_TRACE(logger, ...)                                                                                       \
+    do {                                                                                                               \
+    } while (false)
+#endif
+
+#endif // AFINA_LOGGING_TRACE_H
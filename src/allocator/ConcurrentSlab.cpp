@@ -0,0 +1,204 @@
+#include <afina/allocator/ConcurrentSlab.h>
+
+#include <algorithm>
+
+#include <afina/allocator/Error.h>
+
+namespace Afina {
+namespace Allocator {
+
+static const size_t align = 8;
+
+static inline size_t align_up(size_t n) { return (n + align - 1) & ~(align - 1); }
+
+// Chunk references are 32 bits in 8 bytes units
+static const size_t max_area = size_t(UINT32_MAX - 1) * align;
+
+// See ConcurrentSlab.h
+ConcurrentSlab::ConcurrentSlab(void *base, size_t size, size_t min_chunk, double factor, size_t page_size,
+                               size_t batch, size_t cores)
+    : _pages(0), _batch(std::max(batch, size_t(1))), _free_pages(0), _caches(cores, size_t(0)) {
+    // Make chunks aligned no matter what caller gives us
+    uintptr_t addr = reinterpret_cast<uintptr_t>(base);
+    uintptr_t start = align_up(addr);
+    size = (size > start - addr) ? size - (start - addr) : 0;
+    size = std::min(size, max_area);
+    _start = reinterpret_cast<char *>(start);
+
+    _page_size = align_up(page_size) > size ? (size & ~(align - 1)) : align_up(page_size);
+    if (_page_size == 0) {
+        return;
+    }
+
+    // Pages, in the beginning all are in the pool
+    _pages = size / _page_size;
+    _page_class.reset(new std::atomic<uint32_t>[_pages]);
+    _page_links.reset(new std::atomic<uint32_t>[_pages]);
+    for (uint32_t pg = _pages; pg > 0; pg--) {
+        _page_class[pg - 1].store(npos, std::memory_order_relaxed);
+        _push(_free_pages, pg, &ConcurrentSlab::_page_next);
+    }
+
+    // Classes, geometric progression while page keeps at least two chunks, then whole page. Chunk in
+    // the depot keeps two links, so it can't be less than two words
+    for (size_t chunk = std::max(align_up(min_chunk), 2 * align); chunk <= _page_size / 2;) {
+        _classes.push_back(klass{chunk, uint32_t(_page_size / chunk)});
+        chunk = std::max(align_up(size_t(chunk * factor)), chunk + align);
+    }
+    _classes.push_back(klass{_page_size, 1});
+
+    _depots.reset(new std::atomic<uint64_t>[_classes.size()]);
+    for (size_t k = 0; k < _classes.size(); k++) {
+        _depots[k].store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < _caches.size(); i++) {
+        _caches.at(i)->lists.assign(_classes.size(), chunk_list{nullptr, 0});
+    }
+}
+
+// See ConcurrentSlab.h
+void *ConcurrentSlab::alloc(size_t N) {
+    void *result = try_alloc(N);
+    if (result == nullptr) {
+        throw AllocError(AllocErrorType::NoMemory, "No free chunk for " + std::to_string(N) + " bytes");
+    }
+    return result;
+}
+
+// See ConcurrentSlab.h
+void *ConcurrentSlab::try_alloc(size_t N) noexcept {
+    size_t k = _class_for(N);
+    if (k == _classes.size()) {
+        return nullptr;
+    }
+
+    auto local = _caches.local();
+    chunk_list &list = local->lists[k];
+    if (list.head == nullptr && !_refill(k, list)) {
+        return nullptr;
+    }
+
+    void *result = list.head;
+    list.head = *static_cast<void **>(result);
+    list.count--;
+    return result;
+}
+
+// See ConcurrentSlab.h
+void ConcurrentSlab::free(void *ptr) {
+    char *p = static_cast<char *>(ptr);
+    if (p < _start || p >= _page_start(_pages)) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer doesn't belong to the area");
+    }
+
+    uint32_t k = _page_class[(p - _start) / _page_size].load(std::memory_order_relaxed);
+    if (k == npos) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer belongs to free page");
+    }
+
+    auto local = _caches.local();
+    chunk_list &list = local->lists[k];
+    *reinterpret_cast<void **>(p) = list.head;
+    list.head = p;
+    list.count++;
+
+    // Cache keeps up to two batches, so that alloc/free sequence on the border doesn't move
+    // the same batch back and forth
+    if (list.count < 2 * _batch) {
+        return;
+    }
+
+    void *first = list.head;
+    void *last = first;
+    for (size_t i = 1; i < _batch; i++) {
+        last = *static_cast<void **>(last);
+    }
+    list.head = *static_cast<void **>(last);
+    list.count -= _batch;
+    *static_cast<void **>(last) = nullptr;
+    _push(_depots[k], _batch_ref(first), &ConcurrentSlab::_batch_next);
+}
+
+// See ConcurrentSlab.h
+size_t ConcurrentSlab::chunk_size(size_t N) const {
+    size_t k = _class_for(N);
+    return k == _classes.size() ? 0 : _classes[k].size;
+}
+
+size_t ConcurrentSlab::_class_for(size_t N) const {
+    // Classes are sorted by size, binary search the first one that fits
+    size_t lo = 0, hi = _classes.size();
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (_classes[mid].size < N) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool ConcurrentSlab::_refill(size_t k, chunk_list &list) {
+    // Chunks freed on other cores are preferred over a fresh page
+    uint32_t ref = _pop(_depots[k], &ConcurrentSlab::_batch_next);
+    if (ref != 0) {
+        list.head = _batch_ptr(ref);
+        list.count = _batch;
+        return true;
+    }
+
+    ref = _pop(_free_pages, &ConcurrentSlab::_page_next);
+    if (ref == 0) {
+        return false;
+    }
+
+    uint32_t pg = ref - 1;
+    _page_class[pg].store(k, std::memory_order_relaxed);
+
+    // Whole page goes into the cache, extra chunks are spilled to the depot by free() later
+    const klass &cls = _classes[k];
+    char *start = _page_start(pg);
+    for (uint32_t i = cls.per_page; i > 0; i--) {
+        char *chunk = start + size_t(i - 1) * cls.size;
+        *reinterpret_cast<void **>(chunk) = list.head;
+        list.head = chunk;
+    }
+    list.count = cls.per_page;
+    return true;
+}
+
+void ConcurrentSlab::_push(std::atomic<uint64_t> &head, uint32_t ref, next_of next) {
+    std::atomic<uint32_t> *link = (this->*next)(ref);
+    uint64_t old = head.load(std::memory_order_relaxed);
+    uint64_t desired;
+    do {
+        link->store(uint32_t(old), std::memory_order_relaxed);
+        desired = ((old >> 32) + 1) << 32 | ref;
+    } while (!head.compare_exchange_weak(old, desired, std::memory_order_release, std::memory_order_relaxed));
+}
+
+uint32_t ConcurrentSlab::_pop(std::atomic<uint64_t> &head, next_of next) {
+    uint64_t old = head.load(std::memory_order_acquire);
+    uint64_t desired;
+    do {
+        uint32_t ref = uint32_t(old);
+        if (ref == 0) {
+            return 0;
+        }
+
+        // Element could be taken by someone else at this moment and its link is garbage, but then
+        // counter in the head is changed as well and CAS fails
+        desired = ((old >> 32) + 1) << 32 | (this->*next)(ref)->load(std::memory_order_relaxed);
+    } while (!head.compare_exchange_weak(old, desired, std::memory_order_acquire, std::memory_order_acquire));
+    return uint32_t(old);
+}
+
+std::atomic<uint32_t> *ConcurrentSlab::_page_next(uint32_t ref) { return &_page_links[ref - 1]; }
+
+std::atomic<uint32_t> *ConcurrentSlab::_batch_next(uint32_t ref) {
+    return reinterpret_cast<std::atomic<uint32_t> *>(_batch_ptr(ref) + sizeof(void *));
+}
+
+} // namespace Allocator
+} // namespace Afina
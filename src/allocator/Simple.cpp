@@ -1,40 +1,286 @@
 #include <afina/allocator/Simple.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+#include <afina/allocator/Error.h>
 #include <afina/allocator/Pointer.h>
 
 namespace Afina {
 namespace Allocator {
 
-Simple::Simple(void *base, size_t size) : _base(base), _base_len(size) {}
+static const size_t align = sizeof(void *);
+
+static inline uintptr_t align_up(uintptr_t n) { return (n + align - 1) & ~(align - 1); }
+static inline uintptr_t align_down(uintptr_t n) { return n & ~(align - 1); }
+
+// See Simple.h
+struct Simple::block {
+    // Number of bytes available to the client, always aligned
+    size_t size;
+
+    // Table slot pointing to this block, nullptr for free blocks
+    void **slot;
+
+    inline char *data() { return reinterpret_cast<char *>(this + 1); }
+};
+
+Simple::Simple(void *base, size_t size) : _base(base), _base_len(size), _free_slots(0) {
+    _top = reinterpret_cast<char *>(_first());
+    _table = reinterpret_cast<void **>(align_down(reinterpret_cast<uintptr_t>(base) + size));
+}
 
 /**
- * TODO: semantics
+ * First fit among free blocks, so small allocations tend to fill holes at the beginning of the area
+ * and the end of heap stays available for growing blocks
  * @param N size_t
  */
-Pointer Simple::alloc(size_t N) { return Pointer(); }
+Pointer Simple::alloc(size_t N) {
+    N = std::max(align_up(N), align);
+
+    // New block needs slot, reserve space for it if table has no free ones. Even a hole inside the heap
+    // is no use if the table can't grow
+    size_t reserve = _free_slots > 0 ? 0 : sizeof(void *);
+    if (_top + reserve > reinterpret_cast<char *>(_table)) {
+        throw AllocError(AllocErrorType::NoMemory, "No free slot for " + std::to_string(N) + " bytes");
+    }
+    block *b = _place(N, reserve);
+    if (b == nullptr) {
+        throw AllocError(AllocErrorType::NoMemory, "No free block for " + std::to_string(N) + " bytes");
+    }
+
+    b->slot = _take_slot();
+    *b->slot = b->data();
+    return Pointer(b->slot);
+}
 
 /**
- * TODO: semantics
+ * Shrink and grow into free neighbours happen in place, otherwise block gets moved
  * @param p Pointer
  * @param N size_t
  */
-void Simple::realloc(Pointer &p, size_t N) {}
+void Simple::realloc(Pointer &p, size_t N) {
+    if (p.get() == nullptr) {
+        p = alloc(N);
+        return;
+    }
+
+    N = std::max(align_up(N), align);
+    block *b = reinterpret_cast<block *>(static_cast<char *>(p.get()) - sizeof(block));
+    if (N <= b->size) {
+        _split(b, N);
+        return;
+    }
+
+    // Count free space right after the block
+    size_t avail = b->size;
+    block *next = _next(b);
+    while (reinterpret_cast<char *>(next) < _top && next->slot == nullptr) {
+        avail += sizeof(block) + next->size;
+        next = _next(next);
+    }
+
+    if (reinterpret_cast<char *>(next) == _top && reinterpret_cast<char *>(_table) - b->data() >= N) {
+        // Block is the last one, so it could take space up to the table
+        b->size = N;
+        _top = b->data() + N;
+        return;
+    } else if (avail >= N) {
+        b->size = avail;
+        _split(b, N);
+        return;
+    }
+
+    // Move block, it keeps its slot so all handles stay valid
+    block *nb = _place(N, 0);
+    if (nb == nullptr) {
+        throw AllocError(AllocErrorType::NoMemory, "No free block for " + std::to_string(N) + " bytes");
+    }
+    std::memcpy(nb->data(), b->data(), b->size);
+    nb->slot = b->slot;
+    *nb->slot = nb->data();
+
+    b->slot = nullptr;
+    _merge_free(b);
+}
 
 /**
- * TODO: semantics
+ * Block becomes free and merged with free blocks follows it, slot goes back to the table
  * @param p Pointer
  */
-void Simple::free(Pointer &p) {}
+void Simple::free(Pointer &p) {
+    if (p.get() == nullptr) {
+        p._slot = nullptr;
+        return;
+    }
+
+    char *data = static_cast<char *>(p.get());
+    if (data < reinterpret_cast<char *>(_first()) + sizeof(block) || data >= _top ||
+        p._slot < _table || reinterpret_cast<char *>(p._slot) >= static_cast<char *>(_base) + _base_len) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer doesn't belong to the allocator");
+    }
+
+    block *b = reinterpret_cast<block *>(data - sizeof(block));
+    b->slot = nullptr;
+    *p._slot = nullptr;
+    p._slot = nullptr;
+    _free_slots++;
+    _merge_free(b);
+}
 
 /**
- * TODO: semantics
+ * Slides allocated blocks down, so holes between them disappear
  */
-void Simple::defrag() {}
+void Simple::defrag() {
+    char *dst = reinterpret_cast<char *>(_first());
+    for (block *b = _first(); reinterpret_cast<char *>(b) < _top;) {
+        block *next = _next(b);
+        if (b->slot != nullptr) {
+            size_t total = sizeof(block) + b->size;
+            if (reinterpret_cast<char *>(b) != dst) {
+                std::memmove(dst, b, total);
+                block *moved = reinterpret_cast<block *>(dst);
+                *moved->slot = moved->data();
+            }
+            dst += total;
+        }
+        b = next;
+    }
+    _top = dst;
+
+    // Unused slots at the bottom of the table are not needed anymore
+    while (_free_slots > 0 && *_table == nullptr) {
+        _table++;
+        _free_slots--;
+    }
+}
 
 /**
- * TODO: semantics
+ * Each block printed as [used:N] or [free:N], then table usage
  */
-std::string Simple::dump() const { return ""; }
+std::string Simple::dump() const {
+    std::stringstream out;
+    for (block *b = _first(); reinterpret_cast<char *>(b) < _top; b = _next(b)) {
+        out << (b->slot != nullptr ? "[used:" : "[free:") << b->size << "]";
+    }
+    out << "[top:" << reinterpret_cast<char *>(_table) - _top << "]";
+
+    size_t slots = (static_cast<char *>(_base) + _base_len - reinterpret_cast<char *>(_table)) / sizeof(void *);
+    out << " table: " << slots << " slots, " << _free_slots << " free";
+    return out.str();
+}
+
+// See Simple.h
+size_t Simple::largest_free() const {
+    size_t result = 0;
+    size_t run = 0;
+    for (block *b = _first(); reinterpret_cast<char *>(b) < _top; b = _next(b)) {
+        if (b->slot == nullptr) {
+            run += (run > 0 ? sizeof(block) : 0) + b->size;
+            result = std::max(result, run);
+        } else {
+            run = 0;
+        }
+    }
+
+    size_t top = reinterpret_cast<char *>(_table) - _top;
+    size_t reserve = sizeof(block) + (_free_slots > 0 ? 0 : sizeof(void *));
+    return std::max(result, top > reserve ? top - reserve : 0);
+}
+
+// See Simple.h
+size_t Simple::total_free() const {
+    size_t used = 0;
+    for (block *b = _first(); reinterpret_cast<char *>(b) < _top; b = _next(b)) {
+        if (b->slot != nullptr) {
+            used += sizeof(block) + b->size;
+        }
+    }
+
+    size_t space = reinterpret_cast<char *>(_table) - reinterpret_cast<char *>(_first()) - used;
+    size_t reserve = sizeof(block) + (_free_slots > 0 ? 0 : sizeof(void *));
+    return space > reserve ? space - reserve : 0;
+}
+
+Simple::block *Simple::_first() const {
+    return reinterpret_cast<block *>(align_up(reinterpret_cast<uintptr_t>(_base)));
+}
+
+Simple::block *Simple::_next(block *b) const { return reinterpret_cast<block *>(b->data() + b->size); }
+
+void **Simple::_take_slot() {
+    if (_free_slots > 0) {
+        char *end = static_cast<char *>(_base) + _base_len;
+        for (void **s = _table; reinterpret_cast<char *>(s) < end; s++) {
+            if (*s == nullptr) {
+                _free_slots--;
+                return s;
+            }
+        }
+    }
+
+    if (reinterpret_cast<char *>(_table - 1) < _top) {
+        return nullptr;
+    }
+    _table--;
+    *_table = nullptr;
+    return _table;
+}
+
+Simple::block *Simple::_place(size_t N, size_t reserve) {
+    for (block *b = _first(); reinterpret_cast<char *>(b) < _top; b = _next(b)) {
+        if (b->slot != nullptr) {
+            continue;
+        }
+
+        _merge_free(b);
+        if (reinterpret_cast<char *>(b) >= _top) {
+            // It was the last one, now it is part of the top space
+            break;
+        }
+        if (b->size >= N) {
+            _split(b, N);
+            return b;
+        }
+    }
+
+    // Nothing suitable inside, cut new block from the top
+    if (_top + sizeof(block) + N + reserve > reinterpret_cast<char *>(_table)) {
+        return nullptr;
+    }
+    block *b = reinterpret_cast<block *>(_top);
+    b->size = N;
+    b->slot = nullptr;
+    _top += sizeof(block) + N;
+    return b;
+}
+
+void Simple::_split(block *b, size_t N) {
+    if (b->size < N + sizeof(block) + align) {
+        return;
+    }
+
+    block *rest = reinterpret_cast<block *>(b->data() + N);
+    rest->size = b->size - N - sizeof(block);
+    rest->slot = nullptr;
+    b->size = N;
+    _merge_free(rest);
+}
+
+void Simple::_merge_free(block *b) {
+    block *next = _next(b);
+    while (reinterpret_cast<char *>(next) < _top && next->slot == nullptr) {
+        b->size += sizeof(block) + next->size;
+        next = _next(next);
+    }
+
+    // Free block at the end of heap is just a top space
+    if (reinterpret_cast<char *>(next) >= _top) {
+        _top = reinterpret_cast<char *>(b);
+    }
+}
 
 } // namespace Allocator
 } // namespace Afina
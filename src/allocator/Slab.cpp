@@ -0,0 +1,192 @@
+#include <afina/allocator/Slab.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include <afina/allocator/Error.h>
+
+namespace Afina {
+namespace Allocator {
+
+static const size_t align = 8;
+
+static inline size_t align_up(size_t n) { return (n + align - 1) & ~(align - 1); }
+
+// Small area is still cut into several pages, so that each class in use could get one of them
+static const size_t min_pages = 16;
+static const size_t min_page_size = 1024;
+
+// See Slab.h
+Slab::Slab(void *base, size_t size, size_t min_chunk, double factor, size_t page_size)
+    : _free_pages(npos), _used(0) {
+    // Make chunks aligned no matter what caller gives us
+    uintptr_t addr = reinterpret_cast<uintptr_t>(base);
+    uintptr_t start = align_up(addr);
+    size = (size > start - addr) ? size - (start - addr) : 0;
+    _start = reinterpret_cast<char *>(start);
+
+    _page_size = std::min(align_up(page_size), std::max((size / min_pages) & ~(align - 1), min_page_size));
+    _page_size = _page_size > size ? (size & ~(align - 1)) : _page_size;
+    if (_page_size == 0) {
+        return;
+    }
+
+    // Pages, in the beginning all are free
+    _pages.resize(size / _page_size);
+    for (uint32_t i = _pages.size(); i > 0; i--) {
+        page &pg = _pages[i - 1];
+        pg.klass = npos;
+        pg.used = pg.carved = 0;
+        pg.free_chunks = nullptr;
+        _list_push(_free_pages, i - 1);
+    }
+
+    // Classes, geometric progression while page keeps at least two chunks, then whole page
+    for (size_t chunk = align_up(min_chunk); chunk <= _page_size / 2;) {
+        _classes.push_back(klass{chunk, uint32_t(_page_size / chunk), npos, 0});
+        chunk = std::max(align_up(size_t(chunk * factor)), chunk + align);
+    }
+    _classes.push_back(klass{_page_size, 1, npos, 0});
+}
+
+// See Slab.h
+void *Slab::alloc(size_t N) {
+    void *result = try_alloc(N);
+    if (result == nullptr) {
+        throw AllocError(AllocErrorType::NoMemory, "No free chunk for " + std::to_string(N) + " bytes");
+    }
+    return result;
+}
+
+// See Slab.h
+void *Slab::try_alloc(size_t N) noexcept {
+    size_t k = _class_for(N);
+    if (k == _classes.size()) {
+        return nullptr;
+    }
+    klass &cls = _classes[k];
+
+    // Class has no room left, take fresh page from the pool
+    if (cls.partial == npos) {
+        if (_free_pages == npos) {
+            return nullptr;
+        }
+        uint32_t pg = _free_pages;
+        _list_remove(_free_pages, pg);
+        _pages[pg].klass = k;
+        _list_push(cls.partial, pg);
+        cls.pages++;
+    }
+
+    uint32_t pg = cls.partial;
+    page &p = _pages[pg];
+    void *result;
+    if (p.free_chunks != nullptr) {
+        result = p.free_chunks;
+        p.free_chunks = *reinterpret_cast<void **>(result);
+    } else {
+        result = _page_start(pg) + size_t(p.carved) * cls.size;
+        p.carved++;
+    }
+
+    if (++p.used == cls.per_page) {
+        _list_remove(cls.partial, pg);
+    }
+    _used += cls.size;
+    return result;
+}
+
+// See Slab.h
+void Slab::free(void *ptr) {
+    char *p = static_cast<char *>(ptr);
+    if (p < _start || p >= _page_start(_pages.size())) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer doesn't belong to the area");
+    }
+
+    uint32_t pg = (p - _start) / _page_size;
+    page &pi = _pages[pg];
+    if (pi.klass == npos || pi.used == 0) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer belongs to free page");
+    }
+    klass &cls = _classes[pi.klass];
+
+    *reinterpret_cast<void **>(p) = pi.free_chunks;
+    pi.free_chunks = p;
+    _used -= cls.size;
+
+    if (pi.used-- == cls.per_page) {
+        _list_push(cls.partial, pg);
+    }
+
+    // Page is empty, let other classes to use it
+    if (pi.used == 0) {
+        _list_remove(cls.partial, pg);
+        cls.pages--;
+        pi.klass = npos;
+        pi.carved = 0;
+        pi.free_chunks = nullptr;
+        _list_push(_free_pages, pg);
+    }
+}
+
+// See Slab.h
+size_t Slab::chunk_size(size_t N) const {
+    size_t k = _class_for(N);
+    return k == _classes.size() ? 0 : _classes[k].size;
+}
+
+// See Slab.h
+std::string Slab::dump() const {
+    size_t free_pages = 0;
+    for (uint32_t pg = _free_pages; pg != npos; pg = _pages[pg].next) {
+        free_pages++;
+    }
+
+    std::stringstream out;
+    out << "pages: " << _pages.size() << " x " << _page_size << " bytes, free: " << free_pages << std::endl;
+    for (auto &cls : _classes) {
+        if (cls.pages > 0) {
+            out << "class " << cls.size << ": pages " << cls.pages << std::endl;
+        }
+    }
+    out << "used: " << _used << " bytes" << std::endl;
+    return out.str();
+}
+
+size_t Slab::_class_for(size_t N) const {
+    // Classes are sorted by size, binary search the first one that fits
+    size_t lo = 0, hi = _classes.size();
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (_classes[mid].size < N) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void Slab::_list_push(uint32_t &head, uint32_t pg) {
+    _pages[pg].prev = npos;
+    _pages[pg].next = head;
+    if (head != npos) {
+        _pages[head].prev = pg;
+    }
+    head = pg;
+}
+
+void Slab::_list_remove(uint32_t &head, uint32_t pg) {
+    page &p = _pages[pg];
+    if (p.prev != npos) {
+        _pages[p.prev].next = p.next;
+    } else {
+        head = p.next;
+    }
+    if (p.next != npos) {
+        _pages[p.next].prev = p.prev;
+    }
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -62,5 +62,58 @@ void Engine::sched(void *routine_) {
     Restore(*(context *)routine_);
 }
 
+void Engine::block(void *routine_) {
+    context *routine = routine_ != nullptr ? static_cast<context *>(routine_) : cur_routine;
+    if (routine == nullptr || routine->is_blocked) {
+        return;
+    }
+    Move(routine, alive, blocked);
+    routine->is_blocked = true;
+    if (routine != cur_routine) {
+        return;
+    }
+
+    // Current routine can't go on, it gets control back once unblocked and scheduled
+    Store(*cur_routine);
+    if (setjmp(cur_routine->Environment)) {
+        return;
+    }
+
+    // Nobody else to run, idle context asks unblocker to wait for someone to get unblocked
+    if (alive == nullptr) {
+        cur_routine = nullptr;
+        Restore(*idle_ctx);
+    }
+    cur_routine = alive;
+    Restore(*alive);
+}
+
+void Engine::unblock(void *routine_) {
+    context *routine = static_cast<context *>(routine_);
+    if (routine == nullptr || !routine->is_blocked) {
+        return;
+    }
+    Move(routine, blocked, alive);
+    routine->is_blocked = false;
+}
+
+void Engine::Move(context *ctx, context *&from, context *&to) {
+    if (ctx->prev != nullptr) {
+        ctx->prev->next = ctx->next;
+    } else if (from == ctx) {
+        from = ctx->next;
+    }
+    if (ctx->next != nullptr) {
+        ctx->next->prev = ctx->prev;
+    }
+
+    ctx->prev = nullptr;
+    ctx->next = to;
+    if (to != nullptr) {
+        to->prev = ctx;
+    }
+    to = ctx;
+}
+
 } // namespace Coroutine
 } // namespace Afina
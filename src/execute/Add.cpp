@@ -1,16 +1,18 @@
 #include <afina/Storage.h>
 #include <afina/execute/Add.h>
 
-#include <iostream>
-
 namespace Afina {
 namespace Execute {
 
 // memcached protocol:  "add" means "store this data, but only if the server *doesn't* already
 // hold data for this key".
-void Add::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::cout << "Add(" << _key << ")" << args << std::endl;
-    out = storage.PutIfAbsent(_key, args) ? "STORED" : "NOT_STORED";
+void Add::Execute(Storage &storage, const std::string &args, Response &out) {
+    uint64_t cas = 0;
+    if (storage.PutIfAbsent(_key, args, _flags, ttl(), &cas)) {
+        out.Result(Response::Status::Stored, cas);
+    } else {
+        out.Result(Response::Status::NotStored);
+    }
 }
 
 } // namespace Execute
@@ -1,21 +1,18 @@
 #include <afina/Storage.h>
 #include <afina/execute/Append.h>
 
-#include <iostream>
-
 namespace Afina {
 namespace Execute {
 
 // memcached protocol: "append" means "add this data to an existing key after existing data".
-void Append::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::cout << "Append(" << _key << ")" << args << std::endl;
-    std::string value;
-    if (!storage.Get(_key, value)) {
-        out.assign("NOT_STORED");
-        return;
+void Append::Execute(Storage &storage, const std::string &args, Response &out) {
+    // Item keeps its own flags and expiration time, ones of the command are ignored
+    uint64_t cas = 0;
+    if (storage.Append(_key, args, &cas)) {
+        out.Result(Response::Status::Stored, cas);
+    } else {
+        out.Result(Response::Status::NotStored);
     }
-    storage.Put(_key, value + args);
-    out.assign("STORED");
 }
 
 } // namespace Execute
@@ -0,0 +1,39 @@
+#include <afina/Storage.h>
+#include <afina/execute/ArithmeticCommand.h>
+#include <afina/execute/InsertCommand.h>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "incr" and "decr" are used to change data for some item in-place, incrementing or
+// decrementing it.
+void ArithmeticCommand::Execute(Storage &storage, const std::string &args, Response &out) {
+    uint64_t value = 0, cas = 0;
+    auto result = _decrement ? storage.Decrement(_key, _delta, value, &cas)
+                             : storage.Increment(_key, _delta, value, &cas);
+
+    // Someone else could create the item first, then it is updated as usual
+    if (result == Storage::UpdateResult::NotFound && _create) {
+        if (storage.PutIfAbsent(_key, std::to_string(_initial), 0, expire_ttl(_expire), &cas)) {
+            out.Number(_initial, cas);
+            return;
+        }
+        result = _decrement ? storage.Decrement(_key, _delta, value, &cas)
+                            : storage.Increment(_key, _delta, value, &cas);
+    }
+
+    switch (result) {
+    case Storage::UpdateResult::Stored:
+        out.Number(value, cas);
+        break;
+    case Storage::UpdateResult::NotNumber:
+        out.Result(Response::Status::NotNumber);
+        break;
+    default:
+        out.Result(Response::Status::NotFound);
+        break;
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
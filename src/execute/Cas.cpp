@@ -0,0 +1,25 @@
+#include <afina/Storage.h>
+#include <afina/execute/Cas.h>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "cas" is a check and set operation which means "store this data but only if no one
+// else has updated since I last fetched it."
+void Cas::Execute(Storage &storage, const std::string &args, Response &out) {
+    uint64_t stored_cas = 0;
+    switch (storage.CompareAndSwap(_key, args, _flags, ttl(), _cas, &stored_cas)) {
+    case Storage::UpdateResult::Stored:
+        out.Result(Response::Status::Stored, stored_cas);
+        break;
+    case Storage::UpdateResult::Exists:
+        out.Result(Response::Status::Exists);
+        break;
+    default:
+        out.Result(Response::Status::NotFound);
+        break;
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
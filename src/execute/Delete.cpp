@@ -0,0 +1,17 @@
+#include <afina/Storage.h>
+#include <afina/execute/Delete.h>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "delete" means "remove the item with this key".
+void Delete::Execute(Storage &storage, const std::string &args, Response &out) {
+    if (storage.Delete(_key)) {
+        out.Result(Response::Status::Deleted);
+    } else {
+        out.Result(Response::Status::NotFound);
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
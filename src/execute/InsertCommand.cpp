@@ -0,0 +1,21 @@
+#include <afina/execute/InsertCommand.h>
+
+#include <ctime>
+
+namespace Afina {
+namespace Execute {
+
+// Larger expire times are absolute
+static const int32_t max_relative_expire = 60 * 60 * 24 * 30;
+
+// See InsertCommand.h
+int32_t expire_ttl(int32_t expire) {
+    if (expire <= max_relative_expire) {
+        return expire < 0 ? -1 : expire;
+    }
+    int64_t left = int64_t(expire) - int64_t(std::time(nullptr));
+    return left > 0 ? int32_t(left) : -1;
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,19 @@
+#include <afina/Storage.h>
+#include <afina/execute/Prepend.h>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "prepend" means "add this data to an existing key before existing data".
+void Prepend::Execute(Storage &storage, const std::string &args, Response &out) {
+    // Item keeps its own flags and expiration time, ones of the command are ignored
+    uint64_t cas = 0;
+    if (storage.Prepend(_key, args, &cas)) {
+        out.Result(Response::Status::Stored, cas);
+    } else {
+        out.Result(Response::Status::NotStored);
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -1,22 +1,18 @@
 #include <afina/Storage.h>
 #include <afina/execute/Replace.h>
 
-#include <iostream>
-
 namespace Afina {
 namespace Execute {
 
 // memcached protocol:  "replace" means "store this data, but only if the server *does*
 // already hold data for this key".
 
-void Replace::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::cout << "Replace(" << _key << "): " << args << std::endl;
-    std::string value;
-    if (storage.Get(_key, value)) {
-        storage.Set(_key, args);
-        out = "STORED";
+void Replace::Execute(Storage &storage, const std::string &args, Response &out) {
+    uint64_t cas = 0;
+    if (storage.Set(_key, args, _flags, ttl(), &cas)) {
+        out.Result(Response::Status::Stored, cas);
     } else {
-        out = "NOT_STORED";
+        out.Result(Response::Status::NotStored);
     }
 }
 
@@ -0,0 +1,210 @@
+#include <afina/execute/Response.h>
+
+#include <cstring>
+
+namespace Afina {
+namespace Execute {
+
+// Pairs of digits for numbers 00..99
+static const char digit_pairs[201] = "00010203040506070809"
+                                     "10111213141516171819"
+                                     "20212223242526272829"
+                                     "30313233343536373839"
+                                     "40414243444546474849"
+                                     "50515253545556575859"
+                                     "60616263646566676869"
+                                     "70717273747576777879"
+                                     "80818283848586878889"
+                                     "90919293949596979899";
+
+// See Response.h
+char *format_uint(uint64_t number, char *out) {
+    char buf[20];
+    char *p = buf + sizeof(buf);
+    while (number >= 100) {
+        unsigned pair = unsigned(number % 100) * 2;
+        number /= 100;
+        *--p = digit_pairs[pair + 1];
+        *--p = digit_pairs[pair];
+    }
+    if (number >= 10) {
+        unsigned pair = unsigned(number) * 2;
+        *--p = digit_pairs[pair + 1];
+        *--p = digit_pairs[pair];
+    } else {
+        *--p = char('0' + number);
+    }
+    std::size_t len = buf + sizeof(buf) - p;
+    std::memcpy(out, p, len);
+    return out + len;
+}
+
+// See Response.h
+Response &Response::Append(const char *data, std::size_t size) {
+    if (size == 0) {
+        return *this;
+    }
+    if (_segments.size() == _first || _segments.back().data != nullptr) {
+        _segments.push_back(segment{nullptr, _buffer.size(), 0});
+    }
+    _buffer.append(data, size);
+    _segments.back().size += size;
+    _size += size;
+    return *this;
+}
+
+// See Response.h
+Response &Response::Append(uint64_t number) {
+    char buf[20];
+    return Append(buf, format_uint(number, buf) - buf);
+}
+
+// See Response.h
+Response &Response::Append(const ItemView &view) {
+    if (view.header.size <= copy_threshold) {
+        return Append(view.value.get(), view.header.size);
+    }
+    _pins.push_back(view.value);
+    _segments.push_back(segment{view.value.get(), 0, view.header.size});
+    _size += view.header.size;
+    return *this;
+}
+
+// See Response.h
+void Response::Result(Status status, uint64_t cas) {
+    if (_encoder != nullptr) {
+        return _encoder->Result(*this, status, cas);
+    }
+    switch (status) {
+    case Status::Stored:
+        Append("STORED\r\n");
+        break;
+    case Status::NotStored:
+        Append("NOT_STORED\r\n");
+        break;
+    case Status::Exists:
+        Append("EXISTS\r\n");
+        break;
+    case Status::NotFound:
+        Append("NOT_FOUND\r\n");
+        break;
+    case Status::Deleted:
+        Append("DELETED\r\n");
+        break;
+    case Status::Touched:
+        Append("TOUCHED\r\n");
+        break;
+    case Status::NotNumber:
+        Append("CLIENT_ERROR cannot increment or decrement non-numeric value\r\n");
+        break;
+    case Status::Ok:
+        Append("OK\r\n");
+        break;
+    }
+}
+
+/* memcached protocol:
+
+Each item sent by the server looks like this:
+
+VALUE <key> <flags> <bytes> [<cas unique>]\r\n
+<data block>\r\n
+
+After all the items have been transmitted, the server sends the string
+"END\r\n"
+to indicate the end of response.
+
+*/
+
+// See Response.h
+void Response::Value(const std::string &key, const ItemView &item, bool cas) {
+    if (_encoder != nullptr) {
+        return _encoder->Value(*this, key, item, cas);
+    }
+    Append("VALUE ").Append(key).Append(" ").Append(uint64_t(item.header.flags)).Append(" ");
+    Append(uint64_t(item.header.size));
+    if (cas) {
+        Append(" ").Append(item.header.cas);
+    }
+    Append("\r\n").Append(item).Append("\r\n");
+}
+
+// See Response.h
+void Response::Miss(const std::string &key) {
+    if (_encoder != nullptr) {
+        return _encoder->Miss(*this, key);
+    }
+}
+
+// See Response.h
+void Response::Number(uint64_t number, uint64_t cas) {
+    if (_encoder != nullptr) {
+        return _encoder->Number(*this, number, cas);
+    }
+    Append(number).Append("\r\n");
+}
+
+// See Response.h
+void Response::End() {
+    if (_encoder != nullptr) {
+        return _encoder->End(*this);
+    }
+    Append("END\r\n");
+}
+
+// See Response.h
+const struct iovec *Response::Iov() {
+    _iov.clear();
+    for (std::size_t i = _first; i < _segments.size(); i++) {
+        const segment &s = _segments[i];
+        const char *base = s.data != nullptr ? s.data : _buffer.data() + s.offset;
+        _iov.push_back(iovec{const_cast<char *>(base), s.size});
+    }
+    return _iov.data();
+}
+
+// See Response.h
+void Response::Consume(std::size_t n) {
+    if (n >= _size) {
+        Clear();
+        return;
+    }
+    _size -= n;
+    while (n > 0) {
+        segment &s = _segments[_first];
+        if (n < s.size) {
+            if (s.data != nullptr) {
+                s.data += n;
+            } else {
+                s.offset += n;
+            }
+            s.size -= n;
+            break;
+        }
+        n -= s.size;
+        _first++;
+    }
+}
+
+// See Response.h
+void Response::Clear() {
+    _buffer.clear();
+    _segments.clear();
+    _pins.clear();
+    _first = 0;
+    _size = 0;
+}
+
+// See Response.h
+std::string Response::str() const {
+    std::string result;
+    result.reserve(_size);
+    for (std::size_t i = _first; i < _segments.size(); i++) {
+        const segment &s = _segments[i];
+        result.append(s.data != nullptr ? s.data : _buffer.data() + s.offset, s.size);
+    }
+    return result;
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -1,16 +1,14 @@
 #include <afina/Storage.h>
 #include <afina/execute/Set.h>
 
-#include <iostream>
-
 namespace Afina {
 namespace Execute {
 
 // memcached protocol: "set" means "store this data".
-void Set::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::cout << "Set(" << _key << "): " << args << std::endl;
-    storage.Put(_key, args);
-    out = "STORED";
+void Set::Execute(Storage &storage, const std::string &args, Response &out) {
+    uint64_t cas = 0;
+    storage.Put(_key, args, _flags, ttl(), &cas);
+    out.Result(Response::Status::Stored, cas);
 }
 
 } // namespace Execute
@@ -1,14 +1,10 @@
 #include <afina/Storage.h>
 #include <afina/execute/Stats.h>
 
-#include <iostream>
-#include <iterator>
-#include <sstream>
-
 namespace Afina {
 namespace Execute {
 
-void Stats::Execute(Storage &storage, const std::string &args, std::string &out) { out.assign("END"); }
+void Stats::Execute(Storage &storage, const std::string &args, Response &out) { out.End(); }
 
 } // namespace Execute
 } // namespace Afina
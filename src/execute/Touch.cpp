@@ -0,0 +1,18 @@
+#include <afina/Storage.h>
+#include <afina/execute/InsertCommand.h>
+#include <afina/execute/Touch.h>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "touch" is used to update the expiration time of an existing item without fetching it.
+void Touch::Execute(Storage &storage, const std::string &args, Response &out) {
+    if (storage.Touch(_key, expire_ttl(_expire))) {
+        out.Result(Response::Status::Touched);
+    } else {
+        out.Result(Response::Status::NotFound);
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -15,14 +15,19 @@
 #include <afina/network/Server.h>
 
 #include "logging/ServiceImpl.h"
+#include "network/io_uring/ServerImpl.h"
 #include "network/mt_blocking/ServerImpl.h"
 #include "network/mt_nonblocking/ServerImpl.h"
 #include "network/st_blocking/ServerImpl.h"
 #include "network/st_coroutine/ServerImpl.h"
 #include "network/st_nonblocking/ServerImpl.h"
 
+#include "storage/ClockLRU.h"
+#include "storage/CompactLRU.h"
+#include "storage/SharedLockLRU.h"
 #include "storage/SimpleLRU.h"
 #include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TinyLFU.h"
 #include "storage/StripedLockLRU.h"
 
 using namespace Afina;
@@ -52,12 +57,36 @@ public:
             storage_type = options["storage"].as<std::string>();
         }
 
+        // Total size of the storage, striped storages split it between shards
+        size_t memory = 64 << 20;
+        if (options.count("memory") > 0) {
+            memory = options["memory"].as<size_t>();
+        }
+
+        // 0 lets striped storages choose shards count themselves
+        size_t shards = 0;
+        if (options.count("shards") > 0) {
+            shards = options["shards"].as<size_t>();
+        }
+
         if (storage_type == "st_lru") {
-            storage = std::make_shared<Afina::Backend::SimpleLRU>();
+            storage = std::make_shared<Afina::Backend::SimpleLRU>(memory);
         } else if (storage_type == "mt_lru") {
-            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>();
+            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>(memory);
         } else if (storage_type == "striped_lru") {
-            storage = std::make_shared<Afina::Backend::StripedLockLRU>();
+            storage = std::make_shared<Afina::Backend::StripedLockLRU>(memory, shards);
+        } else if (storage_type == "compact_lru") {
+            storage = std::make_shared<Afina::Backend::CompactLRU>(memory);
+        } else if (storage_type == "striped_compact_lru") {
+            storage = std::make_shared<Afina::Backend::StripedCompactLRU>(memory, shards);
+        } else if (storage_type == "rw_lru") {
+            storage = std::make_shared<Afina::Backend::SharedLockLRU>(memory);
+        } else if (storage_type == "striped_rw_lru") {
+            storage = std::make_shared<Afina::Backend::StripedSharedLockLRU>(memory, shards);
+        } else if (storage_type == "clock") {
+            storage = std::make_shared<Afina::Backend::ClockLRU>(memory);
+        } else if (storage_type == "tinylfu") {
+            storage = std::make_shared<Afina::Backend::TinyLFU>(memory);
         } else {
             throw std::runtime_error("Unknown storage type");
         }
@@ -76,6 +105,10 @@ public:
             server = std::make_shared<Afina::Network::STnonblock::ServerImpl>(storage, logService);
         } else if (network_type == "mt_nonblock") {
             server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService);
+        } else if (network_type == "mt_reuseport") {
+            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService, true);
+        } else if (network_type == "io_uring") {
+            server = std::make_shared<Afina::Network::IOuring::ServerImpl>(storage, logService);
         } else if (network_type == "st_coroutine") {
             server = std::make_shared<Afina::Network::STcoroutine::ServerImpl>(storage, logService);
         } else {
@@ -134,6 +167,9 @@ int main(int argc, char **argv) {
         // TODO: use custom cxxopts::value to print options possible values in help message
         // and simplify validation below
         options.add_options()("s,storage", "Type of storage service to use", cxxopts::value<std::string>());
+        options.add_options()("memory", "Size of the storage in bytes", cxxopts::value<size_t>());
+        options.add_options()("shards", "Number of shards for striped storages, power of two",
+                              cxxopts::value<size_t>());
         options.add_options()("n,network", "Type of network service to use", cxxopts::value<std::string>());
         options.add_options()("h,help", "Print usage info");
         options.parse(argc, argv);
@@ -149,7 +185,12 @@ int main(int argc, char **argv) {
 
     // Start boot sequence
     Application app;
-    app.Configure(options);
+    try {
+        app.Configure(options);
+    } catch (std::exception &ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
 
     // POSIX specific staff
     {
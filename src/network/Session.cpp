@@ -0,0 +1,99 @@
+#include "Session.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/uio.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Trace.h>
+
+namespace Afina {
+namespace Network {
+
+// See Session.h
+bool Session::Process(const char *input, std::size_t size) {
+    std::size_t pos = 0;
+    try {
+        while (pos < size) {
+            // There is no command yet
+            if (!_command) {
+                std::size_t parsed = 0;
+                bool found = _parser.Parse(input + pos, size - pos, parsed);
+                pos += parsed;
+                if (!found) {
+                    // Beginning of the command is kept by parser
+                    break;
+                }
+
+                _command = _parser.Build(_arg_remains);
+                AFINA_TRACE(_logger, "Command {} {} ({} keys), {} bytes of argument", _parser.Name(),
+                            _parser.Keys().empty() ? std::string() : _parser.Keys().front().str(),
+                            _parser.Keys().size(), _arg_remains);
+                if (_arg_remains > 0) {
+                    _arg_remains += _parser.Trailer();
+                }
+            }
+
+            // There is command, but we still wait for argument to arrive...
+            if (_arg_remains > 0) {
+                std::size_t to_read = std::min(_arg_remains, size - pos);
+                _argument.append(input + pos, to_read);
+                pos += to_read;
+                _arg_remains -= to_read;
+                if (_arg_remains > 0) {
+                    break;
+                }
+                _argument.resize(_argument.size() - _parser.Trailer());
+            }
+
+            // There is command & argument - RUN! Response goes to the output along with others
+            _command->Execute(*_storage, _argument, _output);
+
+            // Prepare for the next command
+            _command.reset();
+            _argument.clear();
+            _parser.Reset();
+        }
+    } catch (std::runtime_error &ex) {
+        _error = ex.what();
+        return false;
+    }
+    return true;
+}
+
+// See Session.h
+bool Session::Flush(int socket) {
+    while (!_output.Empty()) {
+        std::size_t iovcnt = std::min(_output.IovCount(), std::size_t(IOV_MAX));
+        ssize_t sent = writev(socket, _output.Iov(), iovcnt);
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return false;
+            } else if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Failed to send response: ") + strerror(errno));
+        }
+        _output.Consume(sent);
+    }
+    return true;
+}
+
+// See Session.h
+void Session::Reset() {
+    _parser.Reset();
+    _command.reset();
+    _arg_remains = 0;
+    _argument.clear();
+    _output.Clear();
+    _error.clear();
+}
+
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,86 @@
+#ifndef AFINA_NETWORK_SESSION_H
+#define AFINA_NETWORK_SESSION_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
+
+#include "protocol/Parser.h"
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+class Storage;
+
+namespace Network {
+
+/**
+ * # Protocol state of the connection
+ * Same for every network mode: server reads whatever socket has, passes it to Process and then sends
+ * the output with Flush.
+ *
+ * Process walks input with a cursor and executes every complete command found there, responses are
+ * accumulated in the output. So a burst of pipelined commands costs one read and one writev no matter
+ * how many commands it has, and input is never moved around. Command which didn't fit into the input
+ * is kept and continued by the next Process call.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class Session {
+public:
+    Session(std::shared_ptr<Afina::Storage> storage, std::shared_ptr<spdlog::logger> logger)
+        : _storage(std::move(storage)), _logger(std::move(logger)), _arg_remains(0) {}
+
+    Session(const Session &) = delete;
+    Session &operator=(const Session &) = delete;
+
+    /**
+     * Parses and executes all commands of the input. Returns false if input is broken, output still has
+     * responses of the commands before the broken one, see Error
+     */
+    bool Process(const char *input, std::size_t size);
+
+    // Why input got rejected
+    inline const std::string &Error() const { return _error; }
+
+    // Responses to be sent
+    inline Execute::Response &Output() { return _output; }
+
+    /**
+     * Sends output with as few writev calls as possible. Returns true once everything is sent, false if
+     * the socket is nonblocking and would block, rest of the output is kept then. Throws on socket error
+     */
+    bool Flush(int socket);
+
+    // Drops everything, so that session could serve new connection
+    void Reset();
+
+private:
+    std::shared_ptr<Afina::Storage> _storage;
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Parse state of the stream
+    Protocol::Parser _parser;
+
+    // Last command parsed out of stream
+    std::unique_ptr<Execute::Command> _command;
+
+    // How many bytes to read from stream to get command argument
+    std::size_t _arg_remains;
+
+    // Argument collected so far
+    std::string _argument;
+
+    Execute::Response _output;
+    std::string _error;
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_SESSION_H
@@ -0,0 +1,52 @@
+#include "Utils.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+
+// See Utils.h
+int listen_socket(uint16_t port, bool reuseport, bool nonblocking) {
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    int server_socket = socket(PF_INET, SOCK_STREAM | (nonblocking ? SOCK_NONBLOCK : 0), IPPROTO_TCP);
+    if (server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    if (setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1 ||
+        setsockopt(server_socket, SOL_SOCKET, SO_KEEPALIVE, &opts, sizeof(opts)) == -1 ||
+        (reuseport && setsockopt(server_socket, SOL_SOCKET, SO_REUSEPORT, &opts, sizeof(opts)) == -1)) {
+        std::string error = strerror(errno);
+        close(server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + error);
+    }
+
+    if (bind(server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        std::string error = strerror(errno);
+        close(server_socket);
+        throw std::runtime_error("Socket bind() failed: " + error);
+    }
+
+    if (listen(server_socket, SOMAXCONN) == -1) {
+        std::string error = strerror(errno);
+        close(server_socket);
+        throw std::runtime_error("Socket listen() failed: " + error);
+    }
+    return server_socket;
+}
+
+} // namespace Network
+} // namespace Afina
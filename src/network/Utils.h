@@ -0,0 +1,18 @@
+#ifndef AFINA_NETWORK_UTILS_H
+#define AFINA_NETWORK_UTILS_H
+
+#include <cstdint>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * Opens TCP socket listening on the port of any address. With reuseport set many sockets could be bound to
+ * the same port, kernel spreads connections between them. Socket is closed if any step fails
+ */
+int listen_socket(uint16_t port, bool reuseport, bool nonblocking);
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_UTILS_H
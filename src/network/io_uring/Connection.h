@@ -0,0 +1,56 @@
+#ifndef AFINA_NETWORK_IO_URING_CONNECTION_H
+#define AFINA_NETWORK_IO_URING_CONNECTION_H
+
+#include <cstring>
+#include <memory>
+
+#include <sys/socket.h>
+
+#include "network/Session.h"
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+namespace IOuring {
+
+/**
+ * # Client connection served by worker
+ * Connection has at most one request in the ring at a time: either receive, waiting for the commands,
+ * or send of the responses. So while responses are sent, output of the session is left untouched and
+ * nothing new is read, slow reader never makes the queue grow. Receive takes a buffer from the worker's
+ * buffer ring only once data arrives, idle connection holds protocol state of the unfinished command
+ * only.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class Connection {
+public:
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> logger)
+        : _socket(s), _logger(logger), _session(ps, logger), _alive(true) {
+        std::memset(&_message, 0, sizeof(_message));
+    }
+
+    inline bool isAlive() const { return _alive; }
+
+private:
+    friend class Worker;
+
+    int _socket;
+    std::shared_ptr<spdlog::logger> _logger;
+    Session _session;
+
+    // Connection is closed once its send is complete
+    bool _alive;
+
+    // Send in flight, points to the output of the session
+    struct msghdr _message;
+};
+
+} // namespace IOuring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_IO_URING_CONNECTION_H
@@ -0,0 +1,212 @@
+#include "Ring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+namespace IOuring {
+
+namespace {
+
+int io_uring_setup(unsigned entries, struct io_uring_params *params) {
+    return syscall(__NR_io_uring_setup, entries, params);
+}
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+int io_uring_register(int fd, unsigned opcode, void *arg, unsigned nargs) {
+    return syscall(__NR_io_uring_register, fd, opcode, arg, nargs);
+}
+
+void *map(int fd, std::size_t size, off_t offset) {
+    void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    if (ptr == MAP_FAILED) {
+        throw std::runtime_error("Failed to map io_uring: " + std::string(strerror(errno)));
+    }
+    return ptr;
+}
+
+} // namespace
+
+// See Ring.h
+Ring::Ring(unsigned entries) : _sq_ptr(MAP_FAILED), _cq_ptr(MAP_FAILED), _sqes(nullptr) {
+    // Completions are posted in task context only when thread enters kernel anyway, older kernels don't
+    // know the flag
+    std::memset(&_params, 0, sizeof(_params));
+    _params.flags = IORING_SETUP_COOP_TASKRUN;
+    _fd = io_uring_setup(entries, &_params);
+    if (_fd < 0 && errno == EINVAL) {
+        std::memset(&_params, 0, sizeof(_params));
+        _fd = io_uring_setup(entries, &_params);
+    }
+    if (_fd < 0) {
+        throw std::runtime_error("Failed to setup io_uring: " + std::string(strerror(errno)));
+    }
+
+    try {
+        _sq_size = _params.sq_off.array + _params.sq_entries * sizeof(unsigned);
+        _cq_size = _params.cq_off.cqes + _params.cq_entries * sizeof(struct io_uring_cqe);
+        if (_params.features & IORING_FEAT_SINGLE_MMAP) {
+            _sq_size = _cq_size = std::max(_sq_size, _cq_size);
+        }
+        _sq_ptr = map(_fd, _sq_size, IORING_OFF_SQ_RING);
+        _cq_ptr = (_params.features & IORING_FEAT_SINGLE_MMAP) ? _sq_ptr : map(_fd, _cq_size, IORING_OFF_CQ_RING);
+        _sqes = static_cast<struct io_uring_sqe *>(
+            map(_fd, _params.sq_entries * sizeof(struct io_uring_sqe), IORING_OFF_SQES));
+    } catch (std::runtime_error &) {
+        _unmap();
+        throw;
+    }
+
+    char *sq = static_cast<char *>(_sq_ptr);
+    _sq_head = reinterpret_cast<unsigned *>(sq + _params.sq_off.head);
+    _sq_tail = reinterpret_cast<unsigned *>(sq + _params.sq_off.tail);
+    _sq_mask = *reinterpret_cast<unsigned *>(sq + _params.sq_off.ring_mask);
+    _sq_pending = 0;
+
+    // Entries are always used in order, so index array never changes
+    unsigned *array = reinterpret_cast<unsigned *>(sq + _params.sq_off.array);
+    for (unsigned i = 0; i < _params.sq_entries; i++) {
+        array[i] = i;
+    }
+
+    char *cq = static_cast<char *>(_cq_ptr);
+    _cq_head = reinterpret_cast<unsigned *>(cq + _params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned *>(cq + _params.cq_off.tail);
+    _cq_mask = *reinterpret_cast<unsigned *>(cq + _params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<struct io_uring_cqe *>(cq + _params.cq_off.cqes);
+}
+
+// See Ring.h
+Ring::~Ring() { _unmap(); }
+
+void Ring::_unmap() {
+    if (_sqes != nullptr) {
+        munmap(_sqes, _params.sq_entries * sizeof(struct io_uring_sqe));
+    }
+    if (_cq_ptr != MAP_FAILED && _cq_ptr != _sq_ptr) {
+        munmap(_cq_ptr, _cq_size);
+    }
+    if (_sq_ptr != MAP_FAILED) {
+        munmap(_sq_ptr, _sq_size);
+    }
+    close(_fd);
+}
+
+// See Ring.h
+bool Ring::Supported() {
+    try {
+        Ring ring(8);
+        BufferRing buffers(ring, 0, 1, 64);
+        return true;
+    } catch (std::runtime_error &) {
+        return false;
+    }
+}
+
+// See Ring.h
+struct io_uring_sqe *Ring::Sqe() {
+    unsigned tail = *_sq_tail + _sq_pending;
+    if (tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) >= _params.sq_entries) {
+        Submit(0);
+        tail = *_sq_tail;
+        if (tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) >= _params.sq_entries) {
+            throw std::runtime_error("io_uring submission queue is full");
+        }
+    }
+    struct io_uring_sqe *sqe = &_sqes[tail & _sq_mask];
+    std::memset(sqe, 0, sizeof(*sqe));
+    _sq_pending++;
+    return sqe;
+}
+
+// See Ring.h
+void Ring::Submit(unsigned wait) {
+    __atomic_store_n(_sq_tail, *_sq_tail + _sq_pending, __ATOMIC_RELEASE);
+    unsigned to_submit = _sq_pending;
+    _sq_pending = 0;
+
+    unsigned flags = wait > 0 ? IORING_ENTER_GETEVENTS : 0;
+    while (to_submit > 0 || wait > 0) {
+        int submitted = io_uring_enter(_fd, to_submit, wait, flags);
+        if (submitted >= 0) {
+            to_submit -= std::min(to_submit, unsigned(submitted));
+            if (to_submit == 0) {
+                return;
+            }
+            // Kernel took only part of the queue, rest goes with the next call without waiting
+            flags = 0;
+            wait = 0;
+        } else if (errno == EBUSY || errno == EAGAIN) {
+            // Completions have to be reaped first, they are there already
+            return;
+        } else if (errno != EINTR) {
+            throw std::runtime_error("Failed to submit to io_uring: " + std::string(strerror(errno)));
+        }
+    }
+}
+
+// See Ring.h
+int Ring::Register(unsigned opcode, void *arg, unsigned nargs) { return io_uring_register(_fd, opcode, arg, nargs); }
+
+// See Ring.h
+BufferRing::BufferRing(Ring &ring, uint16_t group, unsigned count, std::size_t size)
+    : _ring(ring), _group(group), _count(count), _size(size), _tail(0), _storage(count * size) {
+    if (count == 0 || (count & (count - 1)) != 0) {
+        throw std::runtime_error("Number of buffers must be power of 2");
+    }
+
+    _bufs_size = count * sizeof(struct io_uring_buf);
+    void *ptr = mmap(nullptr, _bufs_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_POPULATE, -1, 0);
+    if (ptr == MAP_FAILED) {
+        throw std::runtime_error("Failed to map buffer ring: " + std::string(strerror(errno)));
+    }
+    _bufs = static_cast<struct io_uring_buf_ring *>(ptr);
+
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(_bufs);
+    reg.ring_entries = count;
+    reg.bgid = group;
+    if (_ring.Register(IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        munmap(_bufs, _bufs_size);
+        throw std::runtime_error("Failed to register buffer ring: " + std::string(strerror(errno)));
+    }
+
+    for (unsigned i = 0; i < count; i++) {
+        Recycle(i);
+    }
+}
+
+// See Ring.h
+BufferRing::~BufferRing() {
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.bgid = _group;
+    _ring.Register(IORING_UNREGISTER_PBUF_RING, &reg, 1);
+    munmap(_bufs, _bufs_size);
+}
+
+// See Ring.h
+void BufferRing::Recycle(uint16_t id) {
+    // Flexible array of the header is shifted in C++, so entries are addressed from the start of the ring
+    struct io_uring_buf &buf = reinterpret_cast<struct io_uring_buf *>(_bufs)[_tail & (_count - 1)];
+    buf.addr = reinterpret_cast<uint64_t>(Buffer(id));
+    buf.len = _size;
+    buf.bid = id;
+    __atomic_store_n(&_bufs->tail, ++_tail, __ATOMIC_RELEASE);
+}
+
+} // namespace IOuring
+} // namespace Network
+} // namespace Afina
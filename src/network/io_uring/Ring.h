@@ -0,0 +1,130 @@
+#ifndef AFINA_NETWORK_IO_URING_RING_H
+#define AFINA_NETWORK_IO_URING_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <linux/io_uring.h>
+
+namespace Afina {
+namespace Network {
+namespace IOuring {
+
+/**
+ * # Submission and completion queues shared with kernel
+ * Thin wrapper over io_uring syscalls, no liburing needed. Requests are put into submission queue with
+ * Sqe and go to kernel all at once on Submit, which also waits for completions, so one syscall serves
+ * whole batch of them. Completions are read straight from the shared memory.
+ *
+ * Ring is used by one thread, so it is NOT thread safe.
+ */
+class Ring {
+public:
+    // Throws if kernel has no io_uring or it is forbidden
+    Ring(unsigned entries);
+    ~Ring();
+
+    Ring(const Ring &) = delete;
+    Ring &operator=(const Ring &) = delete;
+
+    /**
+     * Checks that kernel has everything server needs: multishot accept and provided buffer rings, both
+     * came in 5.19
+     */
+    static bool Supported();
+
+    // Free entry of submission queue, cleared. If queue is full, pending entries are submitted first
+    struct io_uring_sqe *Sqe();
+
+    // Submits pending entries and waits until there are at least wait completions
+    void Submit(unsigned wait);
+
+    /**
+     * Calls handler for every completion available. Handler may add new entries, they are submitted by
+     * the next Submit
+     */
+    template <typename F> void Complete(F handler) {
+        unsigned head = *_cq_head;
+        unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const struct io_uring_cqe cqe = _cqes[head & _cq_mask];
+            __atomic_store_n(_cq_head, ++head, __ATOMIC_RELEASE);
+            handler(cqe);
+            if (head == tail) {
+                tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+            }
+        }
+    }
+
+    // Calls io_uring_register
+    int Register(unsigned opcode, void *arg, unsigned nargs);
+
+private:
+    // Releases mapped memory and the ring itself
+    void _unmap();
+
+    int _fd;
+    struct io_uring_params _params;
+
+    // Mapped memory of the queues
+    void *_sq_ptr;
+    std::size_t _sq_size;
+    void *_cq_ptr;
+    std::size_t _cq_size;
+    struct io_uring_sqe *_sqes;
+
+    // Submission queue, tail is ours until it is published on Submit
+    unsigned *_sq_head;
+    unsigned *_sq_tail;
+    unsigned _sq_mask;
+    unsigned _sq_pending;
+
+    // Completion queue, head is ours
+    unsigned *_cq_head;
+    unsigned *_cq_tail;
+    unsigned _cq_mask;
+    struct io_uring_cqe *_cqes;
+};
+
+/**
+ * # Buffers kernel picks from to receive data
+ * Receive request with IOSQE_BUFFER_SELECT doesn't hold any memory while it waits, kernel takes a buffer
+ * of the group once data arrives and reports its id in the completion. Buffer is given back with Recycle
+ * once data is processed, so a few buffers serve any number of idle connections.
+ */
+class BufferRing {
+public:
+    // Number of buffers must be power of 2
+    BufferRing(Ring &ring, uint16_t group, unsigned count, std::size_t size);
+    ~BufferRing();
+
+    BufferRing(const BufferRing &) = delete;
+    BufferRing &operator=(const BufferRing &) = delete;
+
+    inline uint16_t Group() const { return _group; }
+
+    inline char *Buffer(uint16_t id) { return &_storage[std::size_t(id) * _size]; }
+
+    // Gives buffer back to kernel
+    void Recycle(uint16_t id);
+
+private:
+    Ring &_ring;
+    uint16_t _group;
+    unsigned _count;
+    std::size_t _size;
+
+    // Ring of buffer descriptors shared with kernel, tail is ours
+    struct io_uring_buf_ring *_bufs;
+    std::size_t _bufs_size;
+    uint16_t _tail;
+
+    std::vector<char> _storage;
+};
+
+} // namespace IOuring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_IO_URING_RING_H
@@ -0,0 +1,110 @@
+#include "ServerImpl.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/logging/Service.h>
+
+#include "Ring.h"
+#include "Worker.h"
+#include "network/Utils.h"
+#include "network/mt_nonblocking/ServerImpl.h"
+
+namespace Afina {
+namespace Network {
+namespace IOuring {
+
+// See Server.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl)
+    : Server(ps, pl), _event_fd(-1) {}
+
+// See Server.h
+ServerImpl::~ServerImpl() {}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    if (!Ring::Supported()) {
+        _logger->warn("Kernel has no io_uring support, fall back to mt_nonblocking");
+        _fallback.reset(new MTnonblock::ServerImpl(pStorage, pLogging, true));
+        _fallback->Start(port, n_acceptors, n_workers);
+        return;
+    }
+    _logger->info("Start io_uring network service");
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    // Sockets of the workers are bound to the same port, kernel spreads connections between them
+    try {
+        for (uint32_t i = 0; i < n_workers; i++) {
+            _server_sockets.push_back(listen_socket(port, true, false));
+        }
+    } catch (...) {
+        for (int fd : _server_sockets) {
+            close(fd);
+        }
+        _server_sockets.clear();
+        throw;
+    }
+
+    _event_fd = eventfd(0, EFD_NONBLOCK);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create eventfd: " + std::string(strerror(errno)));
+    }
+
+    for (uint32_t i = 0; i < n_workers; i++) {
+        _workers.emplace_back(new Worker(pStorage, pLogging->select("network.worker")));
+        _workers.back()->Start(_server_sockets[i], _event_fd);
+    }
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    if (_fallback) {
+        _fallback->Stop();
+        return;
+    }
+
+    // Workers wait for eventfd to get readable, all of them wake up at once
+    _logger->warn("Stop network service");
+    if (eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup workers");
+    }
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    if (_fallback) {
+        _fallback->Join();
+        return;
+    }
+
+    for (auto &w : _workers) {
+        w->Join();
+    }
+    _workers.clear();
+
+    for (int fd : _server_sockets) {
+        close(fd);
+    }
+    _server_sockets.clear();
+    close(_event_fd);
+}
+
+} // namespace IOuring
+} // namespace Network
+} // namespace Afina
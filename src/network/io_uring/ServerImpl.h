@@ -0,0 +1,62 @@
+#ifndef AFINA_NETWORK_IO_URING_SERVER_H
+#define AFINA_NETWORK_IO_URING_SERVER_H
+
+#include <memory>
+#include <vector>
+
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+namespace IOuring {
+
+// Forward declaration, see Worker.h
+class Worker;
+
+/**
+ * # Network resource manager implementation
+ * io_uring based server: every worker has its own ring and its own listening socket bound to the same
+ * port with SO_REUSEPORT, kernel spreads new connections between them. If kernel has no io_uring, or
+ * one too old for multishot accept and buffer rings, server falls back to mt_nonblocking in the same
+ * shared-nothing mode.
+ */
+class ServerImpl : public Server {
+public:
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ~ServerImpl();
+
+    // See Server.h
+    void Start(uint16_t port, uint32_t acceptors, uint32_t workers) override;
+
+    // See Server.h
+    void Stop() override;
+
+    // See Server.h
+    void Join() override;
+
+private:
+    // logger to use
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Server used instead if there is no io_uring
+    std::unique_ptr<Server> _fallback;
+
+    // Sockets to accept new connection on, one per worker
+    std::vector<int> _server_sockets;
+
+    // Curstom event "device" used to stop workers
+    int _event_fd;
+
+    // threads serving connections
+    std::vector<std::unique_ptr<Worker>> _workers;
+};
+
+} // namespace IOuring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_IO_URING_SERVER_H
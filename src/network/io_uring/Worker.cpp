@@ -0,0 +1,214 @@
+#include "Worker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include "Connection.h"
+#include "Ring.h"
+
+namespace Afina {
+namespace Network {
+namespace IOuring {
+
+namespace {
+
+// Completions are told apart by user data: connection pointer for receive, pointer with the lowest bit
+// set for send, connections are aligned so pointers never clash with the tags
+const uint64_t accept_tag = 1;
+const uint64_t stop_tag = 2;
+const uint64_t send_flag = 1;
+
+// Buffers kernel receives into, any number of connections share them
+const unsigned buffers_count = 1024;
+const std::size_t buffer_size = 4096;
+
+} // namespace
+
+// See Worker.h
+Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> logger)
+    : _pStorage(ps), _logger(logger), _server_socket(-1), _event_fd(-1), _running(false) {}
+
+// See Worker.h
+Worker::~Worker() {}
+
+// See Worker.h
+void Worker::Start(int server_socket, int event_fd) {
+    assert(!_thread.joinable());
+    _server_socket = server_socket;
+    _event_fd = event_fd;
+    _ring.reset(new Ring(4096));
+    _buffers.reset(new BufferRing(*_ring, 0, buffers_count, buffer_size));
+    _running = true;
+    _thread = std::thread(&Worker::OnRun, this);
+}
+
+// See Worker.h
+void Worker::Join() {
+    assert(_thread.joinable());
+    _thread.join();
+    _buffers.reset();
+    _ring.reset();
+}
+
+// See Worker.h
+void Worker::OnRun() {
+    _logger->trace("OnRun");
+    _accept();
+    _wait_stop();
+    while (_running) {
+        _ring->Submit(1);
+        _ring->Complete([this](const struct io_uring_cqe &cqe) { OnComplete(cqe); });
+    }
+
+    // Requests of the connections refer to their memory, so connections are released only once their
+    // requests complete. Shutdown makes them complete right away
+    for (Connection *pconn : _connections) {
+        shutdown(pconn->_socket, SHUT_RDWR);
+    }
+    while (!_connections.empty()) {
+        _ring->Submit(1);
+        _ring->Complete([this](const struct io_uring_cqe &cqe) { OnComplete(cqe); });
+    }
+    _logger->warn("Worker stopped");
+}
+
+// See Worker.h
+void Worker::OnComplete(const struct io_uring_cqe &cqe) {
+    if (cqe.user_data == stop_tag) {
+        _logger->debug("Stop worker");
+        _running = false;
+    } else if (cqe.user_data == accept_tag) {
+        if (cqe.res >= 0 && _running) {
+            _logger->debug("Accepted connection on descriptor {}", cqe.res);
+            Connection *pconn = new Connection(cqe.res, _pStorage, _logger);
+            _connections.insert(pconn);
+            _receive(pconn);
+        } else if (cqe.res >= 0) {
+            close(cqe.res);
+        } else if (cqe.res != -ECANCELED) {
+            _logger->error("Failed to accept socket: {}", strerror(-cqe.res));
+        }
+
+        // Multishot request is over, for example because of an error
+        if (!(cqe.flags & IORING_CQE_F_MORE) && _running) {
+            _accept();
+        }
+    } else {
+        Connection *pconn = reinterpret_cast<Connection *>(cqe.user_data & ~send_flag);
+        if (cqe.user_data & send_flag) {
+            OnSent(pconn, cqe.res);
+        } else {
+            OnReceived(pconn, cqe);
+        }
+    }
+}
+
+// See Worker.h
+void Worker::OnReceived(Connection *pconn, const struct io_uring_cqe &cqe) {
+    if (cqe.flags & IORING_CQE_F_BUFFER) {
+        uint16_t id = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+        if (cqe.res > 0 && !pconn->_session.Process(_buffers->Buffer(id), cqe.res)) {
+            _logger->error("Failed to process connection on descriptor {}: {}", pconn->_socket,
+                           pconn->_session.Error());
+            pconn->_alive = false;
+        }
+        _buffers->Recycle(id);
+    }
+
+    if (!_running) {
+        _close(pconn);
+    } else if (cqe.res == -ENOBUFS) {
+        // Completions of this batch took all the buffers, they are given back by the time kernel gets this
+        _receive(pconn);
+    } else if (cqe.res <= 0) {
+        if (cqe.res < 0) {
+            _logger->error("Failed to read from descriptor {}: {}", pconn->_socket, strerror(-cqe.res));
+        }
+        _close(pconn);
+    } else if (!pconn->_session.Output().Empty()) {
+        _send(pconn);
+    } else if (pconn->isAlive()) {
+        _receive(pconn);
+    } else {
+        _close(pconn);
+    }
+}
+
+// See Worker.h
+void Worker::OnSent(Connection *pconn, int result) {
+    if (result < 0) {
+        _logger->error("Failed to write to descriptor {}: {}", pconn->_socket, strerror(-result));
+        _close(pconn);
+        return;
+    }
+
+    pconn->_session.Output().Consume(result);
+    if (!_running) {
+        _close(pconn);
+    } else if (!pconn->_session.Output().Empty()) {
+        _send(pconn);
+    } else if (pconn->isAlive()) {
+        _receive(pconn);
+    } else {
+        _close(pconn);
+    }
+}
+
+void Worker::_accept() {
+    struct io_uring_sqe *sqe = _ring->Sqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = _server_socket;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = accept_tag;
+}
+
+void Worker::_wait_stop() {
+    struct io_uring_sqe *sqe = _ring->Sqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = _event_fd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = stop_tag;
+}
+
+void Worker::_receive(Connection *pconn) {
+    struct io_uring_sqe *sqe = _ring->Sqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = pconn->_socket;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = _buffers->Group();
+    sqe->user_data = reinterpret_cast<uint64_t>(pconn);
+}
+
+void Worker::_send(Connection *pconn) {
+    Execute::Response &output = pconn->_session.Output();
+    pconn->_message.msg_iov = const_cast<struct iovec *>(output.Iov());
+    pconn->_message.msg_iovlen = std::min(output.IovCount(), std::size_t(IOV_MAX));
+
+    struct io_uring_sqe *sqe = _ring->Sqe();
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = pconn->_socket;
+    sqe->addr = reinterpret_cast<uint64_t>(&pconn->_message);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = reinterpret_cast<uint64_t>(pconn) | send_flag;
+}
+
+void Worker::_close(Connection *pconn) {
+    _logger->debug("Close connection on descriptor {}", pconn->_socket);
+    _connections.erase(pconn);
+    close(pconn->_socket);
+    delete pconn;
+}
+
+} // namespace IOuring
+} // namespace Network
+} // namespace Afina
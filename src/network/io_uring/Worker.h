@@ -0,0 +1,105 @@
+#ifndef AFINA_NETWORK_IO_URING_WORKER_H
+#define AFINA_NETWORK_IO_URING_WORKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+
+#include <linux/io_uring.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+namespace Logging {
+class Service;
+}
+
+namespace Network {
+namespace IOuring {
+
+// Forward declaration, see Connection.h and Ring.h
+class Connection;
+class Ring;
+class BufferRing;
+
+/**
+ * # Thread running io_uring
+ * Worker owns ring and listening socket bound with SO_REUSEPORT, so it shares nothing with the other
+ * workers. Connections are accepted with single multishot request, data is received into buffers kernel
+ * picks from the buffer ring, responses of all the commands read are sent with one sendmsg. Requests
+ * issued while completions are handled go to kernel with the next wait, so each loop iteration costs
+ * one syscall no matter how many connections it served.
+ */
+class Worker {
+public:
+    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> logger);
+    ~Worker();
+
+    Worker(const Worker &) = delete;
+    Worker &operator=(const Worker &) = delete;
+
+    /**
+     * Spawns background thread serving connections of the server socket, it stops once event_fd gets
+     * readable
+     */
+    void Start(int server_socket, int event_fd);
+
+    /**
+     * Blocks calling thread until background one stops, then closes connections that are left
+     */
+    void Join();
+
+protected:
+    /**
+     * Method executing by background thread
+     */
+    void OnRun();
+
+    // Dispatches completion to the request it belongs to
+    void OnComplete(const struct io_uring_cqe &cqe);
+
+    // Client sent data or closed connection
+    void OnReceived(Connection *pconn, const struct io_uring_cqe &cqe);
+
+    // Responses or part of them are sent
+    void OnSent(Connection *pconn, int result);
+
+private:
+    // Requests of the ring
+    void _accept();
+    void _wait_stop();
+    void _receive(Connection *pconn);
+    void _send(Connection *pconn);
+
+    // Connection has no request in the ring, so it is safe to close it
+    void _close(Connection *pconn);
+
+    std::shared_ptr<Afina::Storage> _pStorage;
+    std::shared_ptr<spdlog::logger> _logger;
+
+    std::unique_ptr<Ring> _ring;
+    std::unique_ptr<BufferRing> _buffers;
+
+    int _server_socket;
+    int _event_fd;
+    bool _running;
+
+    // Connections with request in the ring
+    std::unordered_set<Connection *> _connections;
+
+    // Thread serving requests in this worker
+    std::thread _thread;
+};
+
+} // namespace IOuring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_IO_URING_WORKER_H
@@ -22,7 +22,7 @@
 #include <afina/execute/Command.h>
 #include <afina/logging/Service.h>
 
-#include "protocol/Parser.h"
+#include "network/Session.h"
 
 namespace Afina {
 namespace Network {
@@ -100,14 +100,6 @@ void ServerImpl::Join() {
 
 // See Server.h
 void ServerImpl::OnRun() {
-    // Here is connection state
-    // - parser: parse state of the stream
-    // - command_to_execute: last command parsed out of stream
-    // - arg_remains: how many bytes to read from stream to get command argument
-    // - argument_for_command: buffer stores argument
-    Protocol::Parser parser;
-    std::string argument_for_command;
-    std::unique_ptr<Execute::Command> command_to_execute;
     std::function<void(const std::string &)> err_log = [&, this](const std::string &msg) {
         return this->_logger->error(msg);
     };
@@ -165,14 +157,11 @@ void ServerImpl::OnRun() {
 }
 
 void ServerImpl::OnWorkerRun(int client_socket) {
-    std::size_t arg_remains;
-    Protocol::Parser parser;
-    std::string argument_for_command;
-    std::unique_ptr<Execute::Command> command_to_execute;
+    Session session(pStorage, _logger);
     // Process new connection:
     // - read commands until socket alive
-    // - execute each command
-    // - send response
+    // - execute every command of the read
+    // - send all the responses at once
     {
         std::unique_lock<std::mutex> lock(_m_client_sockets);
         _client_sockets.emplace(client_socket);
@@ -183,69 +172,13 @@ void ServerImpl::OnWorkerRun(int client_socket) {
         while ((readed_bytes = read(client_socket, client_buffer, sizeof(client_buffer))) > 0) {
             _logger->debug("Got {} bytes from socket", readed_bytes);
 
-            // Single block of data readed from the socket could trigger inside actions a multiple times,
-            // for example:
-            // - read#0: [<command1 start>]
-            // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
-            while (running && (readed_bytes > 0)) {
-                _logger->debug("Process {} bytes", readed_bytes);
-                // There is no command yet
-                if (!command_to_execute) {
-                    std::size_t parsed = 0;
-                    if (parser.Parse(client_buffer, readed_bytes, parsed)) {
-                        // There is no command to be launched, continue to parse input stream
-                        // Here we are, current chunk finished some command, process it
-                        _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
-                        command_to_execute = parser.Build(arg_remains);
-                        if (arg_remains > 0) {
-                            arg_remains += 2;
-                        }
-                    }
-
-                    // Parsed might fails to consume any bytes from input stream. In real life that could happens,
-                    // for example, because we are working with UTF-16 chars and only 1 byte left in stream
-                    if (parsed == 0) {
-                        break;
-                    } else {
-                        std::memmove(client_buffer, client_buffer + parsed, readed_bytes - parsed);
-                        readed_bytes -= parsed;
-                    }
-                }
-
-                // There is command, but we still wait for argument to arrive...
-                if (command_to_execute && arg_remains > 0) {
-                    _logger->debug("Fill argument: {} bytes of {}", readed_bytes, arg_remains);
-                    // There is some parsed command, and now we are reading argument
-                    std::size_t to_read = std::min(arg_remains, std::size_t(readed_bytes));
-                    argument_for_command.append(client_buffer, to_read);
-
-                    std::memmove(client_buffer, client_buffer + to_read, readed_bytes - to_read);
-                    arg_remains -= to_read;
-                    readed_bytes -= to_read;
-                }
-
-                // Thre is command & argument - RUN!
-                if (command_to_execute && arg_remains == 0) {
-                    _logger->debug("Start command execution");
-
-                    std::string result;
-                    if (!argument_for_command.empty()) {
-                        argument_for_command.resize(argument_for_command.size() - 2);
-                    }
-                    command_to_execute->Execute(*pStorage, argument_for_command, result);
-
-                    // Send response
-                    result += "\r\n";
-                    if (send(client_socket, result.data(), result.size(), 0) <= 0) {
-                        throw std::runtime_error("Failed to send response");
-                    }
-
-                    // Prepare for the next command
-                    command_to_execute.reset();
-                    argument_for_command.resize(0);
-                    parser.Reset();
-                }
-            } // while (readed_bytes)
+            // Single block of data readed from the socket could have many commands as well as a part
+            // of one, session executes the complete ones and keeps the rest
+            bool valid = session.Process(client_buffer, readed_bytes);
+            session.Flush(client_socket);
+            if (!valid) {
+                throw std::runtime_error(session.Error());
+            }
         }
 
         if (readed_bytes == 0) {
@@ -1,25 +1,102 @@
 #include "Connection.h"
 
-#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include <spdlog/logger.h>
 
 namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
+namespace {
+
+// Events connection waits for while it reads commands and while it sends responses
+const uint32_t reading = EPOLLIN | EPOLLRDHUP | EPOLLET;
+const uint32_t writing = EPOLLOUT | EPOLLRDHUP | EPOLLET;
+
+} // namespace
+
 // See Connection.h
-void Connection::Start() { std::cout << "Start" << std::endl; }
+void Connection::Start() {
+    _logger->debug("Start connection on descriptor {}", _socket);
+    _event.events = reading;
+}
 
 // See Connection.h
-void Connection::OnError() { std::cout << "OnError" << std::endl; }
+void Connection::OnError() {
+    _logger->debug("Connection on descriptor {} failed", _socket);
+    _alive = false;
+}
 
 // See Connection.h
-void Connection::OnClose() { std::cout << "OnClose" << std::endl; }
+void Connection::OnClose() {
+    _logger->debug("Connection on descriptor {} closed by client", _socket);
+    _alive = false;
+}
 
 // See Connection.h
-void Connection::DoRead() { std::cout << "DoRead" << std::endl; }
+void Connection::DoRead(char *buffer, std::size_t size) {
+    // Connection that sends responses still gets EPOLLIN and EPOLLRDHUP. Nothing is read until the output is
+    // sent, otherwise end of stream from the half-closed client would drop the rest of it
+    if (!_session.Output().Empty()) {
+        return;
+    }
+
+    try {
+        // Edge triggered: nothing new gets reported until socket is read out
+        for (;;) {
+            ssize_t readed_bytes = read(_socket, buffer, size);
+            if (readed_bytes > 0) {
+                bool valid = _session.Process(buffer, readed_bytes);
+                if (!valid) {
+                    _logger->error("Failed to process connection on descriptor {}: {}", _socket, _session.Error());
+                    _session.Flush(_socket);
+                    _alive = false;
+                    return;
+                }
+                if (!_flush()) {
+                    return;
+                }
+            } else if (readed_bytes == 0) {
+                _logger->debug("Connection on descriptor {} closed", _socket);
+                _alive = false;
+                return;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
+            } else if (errno != EINTR) {
+                throw std::runtime_error(std::string(strerror(errno)));
+            }
+        }
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to read from descriptor {}: {}", _socket, ex.what());
+        _alive = false;
+    }
+}
 
 // See Connection.h
-void Connection::DoWrite() { std::cout << "DoWrite" << std::endl; }
+void Connection::DoWrite() {
+    try {
+        if (_flush()) {
+            // Data that arrived meanwhile is reported once connection gets rearmed for reading
+            _event.events = reading;
+        }
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to write to descriptor {}: {}", _socket, ex.what());
+        _alive = false;
+    }
+}
+
+bool Connection::_flush() {
+    if (_session.Flush(_socket)) {
+        return true;
+    }
+    _event.events = writing;
+    return false;
+}
 
 } // namespace MTnonblock
 } // namespace Network
@@ -1,37 +1,81 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 #define AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <memory>
 
 #include <sys/epoll.h>
 
+#include "network/Session.h"
+
+namespace spdlog {
+class logger;
+}
+
 namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
+/**
+ * # Client connection served by workers
+ * Connection is registered in epoll edge-triggered. In epoll shared by workers it is one-shot as well:
+ * only one worker gets its event, and it serves the socket until read would block, then rearms the
+ * connection with the events of the new state. Connection of worker's own epoll is updated only when
+ * the events it waits for change.
+ *
+ * Connection reads while it has nothing to send. Responses of the whole read go to the output queue of
+ * the session and are sent with writev at once. If socket would block, connection waits for EPOLLOUT
+ * only and doesn't read anything until output is sent, so slow reader never makes the queue grow. Read
+ * buffer belongs to the worker, connection keeps only the protocol state of the unfinished command, so
+ * idle connection costs little memory.
+ *
+ * Connection is served by one thread at a time, so it is NOT thread safe.
+ */
 class Connection {
 public:
-    Connection(int s) : _socket(s) {
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> logger)
+        : _socket(s), _logger(logger), _session(ps, logger), _alive(true), _next(nullptr), _period(0) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _event.data.ptr = this;
     }
 
-    inline bool isAlive() const { return true; }
+    inline bool isAlive() const { return _alive; }
 
     void Start();
 
 protected:
     void OnError();
     void OnClose();
-    void DoRead();
+
+    // Reads until socket would block using the given buffer, executes commands and sends responses. Does
+    // nothing while output of the previous read is not sent yet
+    void DoRead(char *buffer, std::size_t size);
+
+    // Sends rest of the output, resumes reading once it is sent
     void DoWrite();
 
 private:
     friend class Worker;
     friend class ServerImpl;
 
+    // Sends output, switches connection to wait for EPOLLOUT if socket would block. Returns true
+    // if everything is sent
+    bool _flush();
+
     int _socket;
     struct epoll_event _event;
+
+    std::shared_ptr<spdlog::logger> _logger;
+    Session _session;
+    bool _alive;
+
+    // Next connection in worker's inbox
+    Connection *_next;
+
+    // Last balancing period of the worker it was served in, periods start from 1
+    uint64_t _period;
 };
 
 } // namespace MTnonblock
@@ -4,6 +4,7 @@
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <new>
 #include <stdexcept>
 
 #include <arpa/inet.h>
@@ -22,7 +23,7 @@
 #include <afina/logging/Service.h>
 
 #include "Connection.h"
-#include "Utils.h"
+#include "network/Utils.h"
 #include "Worker.h"
 
 namespace Afina {
@@ -30,7 +31,9 @@ namespace Network {
 namespace MTnonblock {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, bool reuseport,
+                       uint64_t rebalance_load)
+    : Server(ps, pl), _reuseport(reuseport), _rebalance_load(rebalance_load), _migrated(0) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -38,7 +41,7 @@ ServerImpl::~ServerImpl() {}
 // See Server.h
 void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
     _logger = pLogging->select("network");
-    _logger->info("Start mt_nonblocking network service");
+    _logger->info("Start mt_nonblocking network service{}", _reuseport ? " with SO_REUSEPORT workers" : "");
 
     sigset_t sig_mask;
     sigemptyset(&sig_mask);
@@ -47,63 +50,60 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Unable to mask SIGPIPE");
     }
 
-    // Create server socket
-    struct sockaddr_in server_addr;
-    std::memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;         // IPv4
-    server_addr.sin_port = htons(port);       // TCP port number
-    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
-
-    _server_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (_server_socket == -1) {
-        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
-    }
-
-    int opts = 1;
-    if (setsockopt(_server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
-    }
-
-    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
-    }
-
-    make_socket_non_blocking(_server_socket);
-    if (listen(_server_socket, 5) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    // Either one socket and epoll shared by all threads, or ones of each worker
+    std::size_t n_sets = _reuseport ? n_workers : 1;
+    try {
+        for (std::size_t i = 0; i < n_sets; i++) {
+            _server_sockets.push_back(listen_socket(port, _reuseport, true));
+        }
+    } catch (...) {
+        for (int fd : _server_sockets) {
+            close(fd);
+        }
+        _server_sockets.clear();
+        throw;
     }
 
     // Start IO workers
-    _data_epoll_fd = epoll_create1(0);
-    if (_data_epoll_fd == -1) {
-        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
-    }
-
     _event_fd = eventfd(0, EFD_NONBLOCK);
     if (_event_fd == -1) {
         throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
-    struct epoll_event event;
-    event.events = EPOLLIN;
-    event.data.ptr = nullptr;
-    if (epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
-        throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+    for (std::size_t i = 0; i < n_sets; i++) {
+        int epoll_fd = epoll_create1(0);
+        if (epoll_fd == -1) {
+            throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+        }
+        _epoll_fds.push_back(epoll_fd);
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+            throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+        }
     }
 
+    // Workers look at each other to balance load, so all of them exist before the first one starts
     _workers.reserve(n_workers);
-    for (int i = 0; i < n_workers; i++) {
-        _workers.emplace_back(pStorage, pLogging);
-        _workers.back().Start(_data_epoll_fd);
+    for (std::size_t i = 0; i < n_workers; i++) {
+        _workers.emplace_back(pStorage, pLogging, this);
+    }
+    for (std::size_t i = 0; i < n_workers; i++) {
+        if (_reuseport) {
+            _workers[i].Start(_epoll_fds[i], _server_sockets[i]);
+        } else {
+            _workers[i].Start(_epoll_fds[0]);
+        }
     }
 
-    // Start acceptors
-    _acceptors.reserve(n_acceptors);
-    for (int i = 0; i < n_acceptors; i++) {
-        _acceptors.emplace_back(&ServerImpl::OnRun, this);
+    // Start acceptors, workers accept connections themselves if each of them has own socket
+    if (!_reuseport) {
+        _acceptors.reserve(n_acceptors);
+        for (std::size_t i = 0; i < n_acceptors; i++) {
+            _acceptors.emplace_back(&ServerImpl::OnRun, this);
+        }
     }
 }
 
@@ -130,6 +130,25 @@ void ServerImpl::Join() {
     for (auto &w : _workers) {
         w.Join();
     }
+
+    // Nobody serves connections anymore
+    for (Connection *pc : _connections) {
+        close(pc->_socket);
+        delete pc;
+    }
+    _connections.clear();
+    _workers.clear();
+    _acceptors.clear();
+
+    for (int fd : _epoll_fds) {
+        close(fd);
+    }
+    for (int fd : _server_sockets) {
+        close(fd);
+    }
+    _epoll_fds.clear();
+    _server_sockets.clear();
+    close(_event_fd);
 }
 
 // See ServerImpl.h
@@ -140,10 +159,11 @@ void ServerImpl::OnRun() {
         throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
+    int server_socket = _server_sockets[0];
     struct epoll_event event;
     event.events = EPOLLIN | EPOLLEXCLUSIVE;
-    event.data.fd = _server_socket;
-    if (epoll_ctl(acceptor_epoll, EPOLL_CTL_ADD, _server_socket, &event)) {
+    event.data.fd = server_socket;
+    if (epoll_ctl(acceptor_epoll, EPOLL_CTL_ADD, server_socket, &event)) {
         throw std::runtime_error("Failed to add file descriptor to epoll");
     }
 
@@ -168,53 +188,78 @@ void ServerImpl::OnRun() {
                 continue;
             }
 
-            for (;;) {
-                struct sockaddr in_addr;
-                socklen_t in_len;
-
-                // No need to make these sockets non blocking since accept4() takes care of it.
-                in_len = sizeof in_addr;
-                int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
-                if (infd == -1) {
-                    if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
-                        break; // We have processed all incoming connections.
-                    } else {
-                        _logger->error("Failed to accept socket");
-                        break;
-                    }
-                }
-
-                // Print host and service info.
-                char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
-                int retval = getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf,
-                                         NI_NUMERICHOST | NI_NUMERICSERV);
-                if (retval == 0) {
-                    _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
-                }
-
-                // Register the new FD to be monitored by epoll.
-                Connection *pc = new Connection(infd);
-                if (pc == nullptr) {
-                    throw std::runtime_error("Failed to allocate connection");
-                }
-
-                // Register connection in worker's epoll
-                pc->Start();
-                if (pc->isAlive()) {
-                    pc->_event.events |= EPOLLONESHOT;
-                    int epoll_ctl_retval;
-                    if ((epoll_ctl_retval = epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event))) {
-                        _logger->debug("epoll_ctl failed during connection register in workers'epoll: error {}", epoll_ctl_retval);
-                        pc->OnError();
-                        delete pc;
-                    }
-                }
-            }
+            // Connection is served by whichever worker gets its event, so it is one-shot
+            OnNewConnection(server_socket, _epoll_fds[0], EPOLLONESHOT);
         }
     }
+    close(acceptor_epoll);
     _logger->warn("Acceptor stopped");
 }
 
+// See ServerImpl.h
+void ServerImpl::OnNewConnection(int server_socket, int epoll_fd, uint32_t events) {
+    for (;;) {
+        struct sockaddr in_addr;
+        socklen_t in_len;
+
+        // No need to make these sockets non blocking since accept4() takes care of it.
+        in_len = sizeof in_addr;
+        int infd = accept4(server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (infd == -1) {
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                break; // We have processed all incoming connections.
+            } else {
+                _logger->error("Failed to accept socket");
+                break;
+            }
+        }
+
+        // Print host and service info.
+        if (_logger->should_log(spdlog::level::debug)) {
+            char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
+            int retval =
+                getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf, NI_NUMERICHOST | NI_NUMERICSERV);
+            if (retval == 0) {
+                _logger->debug("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
+            }
+        }
+
+        // Register the new FD to be monitored by epoll.
+        Connection *pc = new (std::nothrow) Connection(infd, pStorage, _logger);
+        if (pc == nullptr) {
+            close(infd);
+            throw std::runtime_error("Failed to allocate connection");
+        }
+        {
+            std::lock_guard<std::mutex> lock(_connections_mutex);
+            _connections.insert(pc);
+        }
+
+        // Register connection in worker's epoll. Once it is there, connection belongs to workers and
+        // could be closed by them any moment
+        pc->Start();
+        if (pc->isAlive()) {
+            pc->_event.events |= events;
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event) == 0) {
+                continue;
+            }
+            _logger->error("Failed to register connection in workers' epoll: {}", strerror(errno));
+            pc->OnError();
+        }
+        OnClosed(pc);
+    }
+}
+
+// See ServerImpl.h
+void ServerImpl::OnClosed(Connection *pc) {
+    {
+        std::lock_guard<std::mutex> lock(_connections_mutex);
+        _connections.erase(pc);
+    }
+    close(pc->_socket);
+    delete pc;
+}
+
 } // namespace MTnonblock
 } // namespace Network
 } // namespace Afina
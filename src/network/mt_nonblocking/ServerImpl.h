@@ -1,7 +1,11 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 #define AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include <afina/network/Server.h>
@@ -14,16 +18,26 @@ namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
-// Forward declaration, see Worker.h
+// Forward declaration, see Worker.h and Connection.h
 class Worker;
+class Connection;
 
 /**
  * # Network resource manager implementation
- * Epoll based server
+ * Epoll based server. By default acceptors put connections into one epoll shared by all workers, so
+ * connection is served by whichever worker is free and has to be one-shot: each event costs extra
+ * epoll_ctl to rearm it.
+ *
+ * With reuseport set nothing is shared: each worker has own epoll and own listening socket bound to the
+ * same port with SO_REUSEPORT, kernel spreads new connections between them. Worker accepts connections
+ * itself and serves them for their whole life, epoll_ctl is called only if connection switches between
+ * reading and writing. Worker that serves at least rebalance_load events in a period and more than twice
+ * as many as the least loaded one hands part of its connections over, see Worker.h
  */
 class ServerImpl : public Server {
 public:
-    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, bool reuseport = false,
+               uint64_t rebalance_load = 1024);
     ~ServerImpl();
 
     // See Server.h
@@ -35,11 +49,21 @@ public:
     // See Server.h
     void Join() override;
 
+    // Number of times a connection was handed over from one worker to another
+    std::size_t Migrated() const { return _migrated.load(std::memory_order_relaxed); }
+
 protected:
     void OnRun();
-    void OnNewConnection();
+
+    // Accepts all pending connections of the socket and registers them in epoll with the given extra events
+    void OnNewConnection(int server_socket, int epoll_fd, uint32_t events);
 
 private:
+    friend class Worker;
+
+    // Worker is done with the connection, it is not in epoll anymore
+    void OnClosed(Connection *pc);
+
     // logger to use
     std::shared_ptr<spdlog::logger> _logger;
 
@@ -48,21 +72,34 @@ private:
     // Read-only
     uint16_t listen_port;
 
-    // Socket to accept new connection on, shared between acceptors
-    int _server_socket;
+    // Workers have own sockets and epolls
+    bool _reuseport;
+
+    // Few events are not worth moving connections around, worker serving less in a period keeps them
+    uint64_t _rebalance_load;
+
+    // Connections handed over between workers since start
+    std::atomic<std::size_t> _migrated;
+
+    // Sockets to accept new connection on, either one shared between acceptors or one per worker
+    std::vector<int> _server_sockets;
 
     // Threads that accepts new connections, each has private epoll instance
     // but share global server socket
     std::vector<std::thread> _acceptors;
 
-    // EPOLL instance shared between workers
-    int _data_epoll_fd;
+    // EPOLL instances of workers, either one shared between them or one per worker
+    std::vector<int> _epoll_fds;
 
     // Curstom event "device" used to wakeup workers
     int _event_fd;
 
     // threads serving read/write requests
     std::vector<Worker> _workers;
+
+    // Connections served by workers, the ones left after workers stop are closed on Join
+    std::mutex _connections_mutex;
+    std::unordered_set<Connection *> _connections;
 };
 
 } // namespace MTnonblock
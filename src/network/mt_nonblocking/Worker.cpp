@@ -1,19 +1,24 @@
 #include "Worker.h"
 
 #include <cassert>
+#include <cstring>
 #include <functional>
 #include <iostream>
+#include <stdexcept>
 
 #include <netdb.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include <spdlog/logger.h>
 
 #include <afina/logging/Service.h>
 
 #include "Connection.h"
+#include "ServerImpl.h"
 #include "Utils.h"
 
 namespace Afina {
@@ -21,18 +26,26 @@ namespace Network {
 namespace MTnonblock {
 
 // See Worker.h
-Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
-    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1) {
-    // TODO: implementation here
+Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl, ServerImpl *server)
+    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1), _server_socket(-1), _server(server),
+      _read_buffer(16384), _load(0), _inbox(nullptr), _period(1), _events(0), _active(0), _migrate_to(nullptr),
+      _migrate_budget(0) {
+    // Created right away, so that other workers could hand connections over before this one starts
+    _inbox_fd = eventfd(0, EFD_NONBLOCK);
+    if (_inbox_fd == -1) {
+        throw std::runtime_error("Failed to create inbox eventfd: " + std::string(strerror(errno)));
+    }
 }
 
 // See Worker.h
 Worker::~Worker() {
-    // TODO: implementation here
+    if (_inbox_fd != -1) {
+        close(_inbox_fd);
+    }
 }
 
 // See Worker.h
-Worker::Worker(Worker &&other) { *this = std::move(other); }
+Worker::Worker(Worker &&other) : _inbox(nullptr), _inbox_fd(-1) { *this = std::move(other); }
 
 // See Worker.h
 Worker &Worker::operator=(Worker &&other) {
@@ -41,17 +54,47 @@ Worker &Worker::operator=(Worker &&other) {
     _logger = std::move(other._logger);
     _thread = std::move(other._thread);
     _epoll_fd = other._epoll_fd;
+    _server_socket = other._server_socket;
+    _server = other._server;
+    _read_buffer = std::move(other._read_buffer);
+    _load = other._load.load();
+    _inbox = other._inbox.exchange(nullptr);
+    std::swap(_inbox_fd, other._inbox_fd);
+    _period = other._period;
+    _period_start = other._period_start;
+    _events = other._events;
+    _active = other._active;
+    _migrate_to = other._migrate_to;
+    _migrate_budget = other._migrate_budget;
 
     other._epoll_fd = -1;
     return *this;
 }
 
 // See Worker.h
-void Worker::Start(int epoll_fd) {
+void Worker::Start(int epoll_fd, int server_socket) {
     if (isRunning.exchange(true) == false) {
         assert(_epoll_fd == -1);
         _epoll_fd = epoll_fd;
+        _server_socket = server_socket;
         _logger = _pLogging->select("network.worker");
+
+        // Own listening socket is told apart from connections by worker pointer
+        if (_server_socket != -1) {
+            struct epoll_event event;
+            event.events = EPOLLIN;
+            event.data.ptr = this;
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _server_socket, &event)) {
+                throw std::runtime_error("Failed to add server socket to epoll");
+            }
+
+            // Inbox is told apart by its own address
+            event.data.ptr = &_inbox;
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _inbox_fd, &event)) {
+                throw std::runtime_error("Failed to add inbox eventfd to epoll");
+            }
+            _period_start = std::chrono::steady_clock::now();
+        }
         _thread = std::thread(&Worker::OnRun, this);
     }
 }
@@ -65,20 +108,34 @@ void Worker::Join() {
     _thread.join();
 }
 
+// See Worker.h
+void Worker::Adopt(Connection *pconn) {
+    Connection *head = _inbox.load(std::memory_order_relaxed);
+    do {
+        pconn->_next = head;
+    } while (!_inbox.compare_exchange_weak(head, pconn, std::memory_order_release, std::memory_order_relaxed));
+
+    // Counter never gets anywhere near overflow, so write can't fail
+    eventfd_write(_inbox_fd, 1);
+}
+
 // See Worker.h
 void Worker::OnRun() {
     assert(_epoll_fd >= 0);
     _logger->trace("OnRun");
 
-    // Process connection events
-    //
-    // Do not forget to use EPOLLEXCLUSIVE flag when register socket
-    // for events to avoid thundering herd type behavior.
-    int timeout = -1;
+    // Process connection events. Connections of shared epoll are one-shot, so each event is delivered to
+    // one worker only and connection is served by one thread at a time
+    // Worker owning epoll wakes up every period even if it is idle, so that its published load drops
+    const std::chrono::milliseconds period(100);
+    int timeout = _server_socket == -1 ? -1 : period.count();
     std::array<struct epoll_event, 64> mod_list;
     while (isRunning) {
         int nmod = epoll_wait(_epoll_fd, &mod_list[0], mod_list.size(), timeout);
         _logger->debug("Worker wokeup: {} events", nmod);
+        if (_server_socket != -1 && std::chrono::steady_clock::now() - _period_start >= period) {
+            Rebalance();
+        }
 
         for (int i = 0; i < nmod; i++) {
             struct epoll_event &current_event = mod_list[i];
@@ -90,47 +147,122 @@ void Worker::OnRun() {
                 continue;
             }
 
+            // New connections on own socket, they stay in this epoll for their whole life
+            if (current_event.data.ptr == this) {
+                _server->OnNewConnection(_server_socket, _epoll_fd, 0);
+                continue;
+            } else if (current_event.data.ptr == &_inbox) {
+                OnAdopted();
+                continue;
+            }
+
             // Some connection gets new data
             Connection *pconn = static_cast<Connection *>(current_event.data.ptr);
+            uint32_t events = pconn->_event.events;
+            _events++;
+            if (pconn->_period != _period) {
+                pconn->_period = _period;
+                _active++;
+            }
             if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
                 _logger->debug("Got EPOLLERR or EPOLLHUP, value of returned events: {}", current_event.events);
                 pconn->OnError();
-            } else if (current_event.events & EPOLLRDHUP) {
-                _logger->debug("Got EPOLLRDHUP, value of returned events: {}", current_event.events);
-                pconn->OnClose();
             } else {
-                // Depends on what connection wants...
-                if (current_event.events & EPOLLIN) {
+                // Client that is done with writing still waits for the responses. Its commands are read
+                // first, end of the stream is read only after all the responses are sent
+                if (current_event.events & (EPOLLIN | EPOLLRDHUP)) {
                     _logger->trace("Got EPOLLIN");
-                    pconn->DoRead();
+                    pconn->DoRead(_read_buffer.data(), _read_buffer.size());
                 }
-                if (current_event.events & EPOLLOUT) {
+                if (pconn->isAlive() && (current_event.events & EPOLLOUT)) {
                     _logger->trace("Got EPOLLOUT");
                     pconn->DoWrite();
                 }
             }
+            OnServed(pconn, events);
+        }
+    }
+    _logger->warn("Worker stopped");
+}
 
-            // Rearm connection
-            if (pconn->isAlive()) {
-                pconn->_event.events |= EPOLLONESHOT;
-                int epoll_ctl_retval;
-                if ((epoll_ctl_retval = epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_socket, &pconn->_event))) {
-                    _logger->debug("epoll_ctl failed during connection rearm: error {}", epoll_ctl_retval);
-                    pconn->OnError();
-                    delete pconn;
-                }
-            }
-            // Or delete closed one
-            else {
-                if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event)) {
-                    std::cerr << "Failed to delete connection!" << std::endl;
-                }
-                delete pconn;
+// See Worker.h
+void Worker::OnServed(Connection *pconn, uint32_t events) {
+    // Connection of shared epoll is one-shot, so nobody else could get it until it is rearmed. Own
+    // connection stays armed, epoll is updated only when it switches between reading and writing
+    if (pconn->isAlive()) {
+        if (_server_socket == -1) {
+            pconn->_event.events |= EPOLLONESHOT;
+        } else if (_migrate_budget > 0) {
+            // Connection is between events, nothing of it is lost
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event) == 0) {
+                _migrate_budget--;
+                _server->_migrated.fetch_add(1, std::memory_order_relaxed);
+                _migrate_to->Adopt(pconn);
+                return;
             }
+            _logger->error("Failed to take connection on descriptor {} out of epoll", pconn->_socket);
+        } else if (pconn->_event.events == events) {
+            return;
         }
-        // TODO: Select timeout...
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_socket, &pconn->_event) == 0) {
+            return;
+        }
+        _logger->error("Failed to rearm connection on descriptor {}", pconn->_socket);
+        pconn->OnError();
     }
-    _logger->warn("Worker stopped");
+
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event)) {
+        _logger->error("Failed to delete connection from epoll");
+    }
+    _server->OnClosed(pconn);
+}
+
+// See Worker.h
+void Worker::OnAdopted() {
+    eventfd_t value;
+    eventfd_read(_inbox_fd, &value);
+
+    // Epoll reports data that came while connection moved as soon as it is added
+    Connection *pconn = _inbox.exchange(nullptr, std::memory_order_acquire);
+    while (pconn != nullptr) {
+        Connection *next = pconn->_next;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, pconn->_socket, &pconn->_event)) {
+            _logger->error("Failed to register connection on descriptor {}", pconn->_socket);
+            pconn->OnError();
+            _server->OnClosed(pconn);
+        }
+        pconn = next;
+    }
+}
+
+// See Worker.h
+void Worker::Rebalance() {
+    uint64_t load = _events;
+    _load.store(load, std::memory_order_relaxed);
+
+    // Worker that has a lot to do hands part of connections it served over to the least loaded one, so that
+    // both end up with the same load
+    Worker *idle = nullptr;
+    uint64_t idle_load = load;
+    for (Worker &w : _server->_workers) {
+        uint64_t w_load = w._load.load(std::memory_order_relaxed);
+        if (&w != this && w_load < idle_load) {
+            idle = &w;
+            idle_load = w_load;
+        }
+    }
+
+    _migrate_budget = 0;
+    if (idle != nullptr && load >= _server->_rebalance_load && load > 2 * idle_load) {
+        _migrate_to = idle;
+        _migrate_budget = _active * (load - idle_load) / (2 * load);
+        _logger->debug("Worker served {} events, hands {} connections over", load, _migrate_budget);
+    }
+
+    _period++;
+    _period_start = std::chrono::steady_clock::now();
+    _events = 0;
+    _active = 0;
 }
 
 } // namespace MTnonblock
@@ -2,8 +2,12 @@
 #define AFINA_NETWORK_MT_NONBLOCKING_WORKER_H
 
 #include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <thread>
+#include <vector>
 
 namespace spdlog {
 class logger;
@@ -20,14 +24,26 @@ class Service;
 namespace Network {
 namespace MTnonblock {
 
+// Forward declaration, see Connection.h and ServerImpl.h
+class Connection;
+class ServerImpl;
+
 /**
  * # Thread running epoll
  * On Start spaws background thread that is doing epoll on the given server
- * socket and process incoming connections and its data
+ * socket and process incoming connections and its data. Epoll is either shared with other workers, or
+ * owned by this one along with listening socket, then worker accepts connections itself.
+ *
+ * Workers owning epoll balance load between each other. Every period worker publishes how many events
+ * it has served, and if it served enough of them and more than twice as many as the least loaded one, it
+ * hands part of its active connections over to that worker. Connection is taken out of epoll between
+ * events, so its unfinished command and unsent responses travel along with it, and pushed into inbox of
+ * the other worker which is signalled with eventfd. Epoll reports whatever socket has once the new owner
+ * adds it.
  */
 class Worker {
 public:
-    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl);
+    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl, ServerImpl *server);
     ~Worker();
 
     Worker(Worker &&);
@@ -38,7 +54,7 @@ public:
      * socket. Once connection accepted it must be registered and being processed
      * on this thread
      */
-    void Start(int epoll_fd);
+    void Start(int epoll_fd, int server_socket = -1);
 
     /**
      * Signal background thread to stop. After that signal thread must stop to
@@ -54,12 +70,27 @@ public:
      */
     void Join();
 
+    /**
+     * Hands connection over to this worker, could be called by any thread. Connection must not be in
+     * any epoll
+     */
+    void Adopt(Connection *pconn);
+
 protected:
     /**
      * Method executing by background thread
      */
     void OnRun();
 
+    // Rearms connection in epoll or closes it if it is done, events are the ones connection waited for
+    void OnServed(Connection *pconn, uint32_t events);
+
+    // Registers connections handed over by other workers
+    void OnAdopted();
+
+    // Publishes load of the finished period and decides how many connections to hand over
+    void Rebalance();
+
 private:
     Worker(Worker &) = delete;
     Worker &operator=(Worker &) = delete;
@@ -81,6 +112,35 @@ private:
 
     // EPOLL descriptor using for events processing
     int _epoll_fd;
+
+    // Listening socket owned by this worker, -1 if epoll is shared and connections are accepted by server
+    int _server_socket;
+
+    // Server connections are registered in
+    ServerImpl *_server;
+
+    // Buffer every connection served by this worker reads into, connection keeps only the part of the
+    // command that is not complete yet
+    std::vector<char> _read_buffer;
+
+    // Events served during the last period, read by other workers
+    std::atomic<uint64_t> _load;
+
+    // Connections handed over by other workers: many threads push, this one takes the whole list at once
+    std::atomic<Connection *> _inbox;
+
+    // Signals that inbox is not empty
+    int _inbox_fd;
+
+    // Current period: its number, when it started, how many events and distinct connections served
+    uint64_t _period;
+    std::chrono::steady_clock::time_point _period_start;
+    uint64_t _events;
+    std::size_t _active;
+
+    // Where to hand active connections over and how many of them
+    Worker *_migrate_to;
+    std::size_t _migrate_budget;
 };
 
 } // namespace MTnonblock
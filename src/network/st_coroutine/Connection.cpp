@@ -1,25 +1,93 @@
 #include "Connection.h"
 
-#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/coroutine/Engine.h>
 
 namespace Afina {
 namespace Network {
 namespace STcoroutine {
 
 // See Connection.h
-void Connection::Start() { std::cout << "Start" << std::endl; }
+void Connection::Serve(char *buffer, std::size_t size) {
+    _logger->debug("Start connection on descriptor {}", _socket);
+    try {
+        for (;;) {
+            ssize_t readed_bytes = _read(buffer, size);
+            if (readed_bytes == 0) {
+                _logger->debug("Connection on descriptor {} closed", _socket);
+                break;
+            }
 
-// See Connection.h
-void Connection::OnError() { std::cout << "OnError" << std::endl; }
+            bool valid = _session.Process(buffer, readed_bytes);
+            if (!_flush()) {
+                break;
+            }
+            if (!valid) {
+                _logger->error("Failed to process connection on descriptor {}: {}", _socket, _session.Error());
+                break;
+            }
+        }
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to serve descriptor {}: {}", _socket, ex.what());
+    }
+    _alive = false;
+}
 
 // See Connection.h
-void Connection::OnClose() { std::cout << "OnClose" << std::endl; }
+bool Connection::OnEvent() {
+    if (!_waiting) {
+        return false;
+    }
+    _engine.unblock(_coroutine);
+    return true;
+}
 
 // See Connection.h
-void Connection::DoRead() { std::cout << "DoRead" << std::endl; }
+void Connection::OnStop() {
+    _alive = false;
+    OnEvent();
+}
 
-// See Connection.h
-void Connection::DoWrite() { std::cout << "DoWrite" << std::endl; }
+ssize_t Connection::_read(char *buffer, std::size_t size) {
+    for (;;) {
+        ssize_t readed_bytes = read(_socket, buffer, size);
+        if (readed_bytes >= 0) {
+            return readed_bytes;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            if (!_wait()) {
+                return 0;
+            }
+        } else if (errno != EINTR) {
+            throw std::runtime_error(std::string(strerror(errno)));
+        }
+    }
+}
+
+bool Connection::_flush() {
+    while (!_session.Flush(_socket)) {
+        if (!_wait()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Connection::_wait() {
+    if (_alive) {
+        _waiting = true;
+        _engine.block();
+        _waiting = false;
+    }
+    return _alive;
+}
 
 } // namespace STcoroutine
 } // namespace Network
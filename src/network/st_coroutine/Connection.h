@@ -1,36 +1,83 @@
 #ifndef AFINA_NETWORK_ST_COROUTINE_CONNECTION_H
 #define AFINA_NETWORK_ST_COROUTINE_CONNECTION_H
 
+#include <cstddef>
 #include <cstring>
+#include <memory>
 
 #include <sys/epoll.h>
+#include <sys/types.h>
+
+#include "network/Session.h"
+
+namespace spdlog {
+class logger;
+}
 
 namespace Afina {
+namespace Coroutine {
+class Engine;
+}
+
 namespace Network {
 namespace STcoroutine {
 
+/**
+ * # Client connection served by its own coroutine
+ * Coroutine runs plain loop: read, execute commands, send responses. Socket is nonblocking, once read or
+ * write would block coroutine gets blocked in the engine, and server unblocks it when epoll reports the
+ * socket. Socket is registered edge-triggered for both directions once, events that came while
+ * coroutine was running are not needed: it works with socket until it would block anyway.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
 class Connection {
 public:
-    Connection(int s) : _socket(s) {
+    Connection(int s, Coroutine::Engine &engine, std::shared_ptr<Afina::Storage> ps,
+               std::shared_ptr<spdlog::logger> logger)
+        : _socket(s), _engine(engine), _coroutine(nullptr), _waiting(false), _alive(true), _logger(logger),
+          _session(ps, logger) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
+        _event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
         _event.data.ptr = this;
     }
 
-    inline bool isAlive() const { return true; }
+    inline bool isAlive() const { return _alive; }
 
-    void Start();
+    /**
+     * Body of the coroutine, serves client until it is gone or server stops. Buffer to read into is
+     * shared by all connections: data is processed before coroutine could get blocked
+     */
+    void Serve(char *buffer, std::size_t size);
 
 protected:
-    void OnError();
-    void OnClose();
-    void DoRead();
-    void DoWrite();
+    // Wakes coroutine up if it waits for the socket, returns true if it did
+    bool OnEvent();
+
+    // Server stops, coroutine has to finish
+    void OnStop();
 
 private:
     friend class ServerImpl;
 
+    // Socket operations that block coroutine instead of thread, once server stops read reports end of
+    // the stream and flush gives up
+    ssize_t _read(char *buffer, std::size_t size);
+    bool _flush();
+
+    // Blocks coroutine until socket gets some event, returns false if server stops
+    bool _wait();
+
     int _socket;
     struct epoll_event _event;
+
+    Coroutine::Engine &_engine;
+    void *_coroutine;
+    bool _waiting;
+    bool _alive;
+
+    std::shared_ptr<spdlog::logger> _logger;
+    Session _session;
 };
 
 } // namespace STcoroutine
@@ -1,9 +1,11 @@
 #include "ServerImpl.h"
 
+#include <array>
 #include <cassert>
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <new>
 #include <stdexcept>
 
 #include <arpa/inet.h>
@@ -29,7 +31,9 @@ namespace Network {
 namespace STcoroutine {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl)
+    : Server(ps, pl), _running(false), _engine([this](Coroutine::Engine &) { OnIdle(); }), _acceptor(nullptr),
+      _acceptor_waiting(false), _read_buffer(16384) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -37,7 +41,7 @@ ServerImpl::~ServerImpl() {}
 // See Server.h
 void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
     _logger = pLogging->select("network");
-    _logger->info("Start st_nonblocking network service");
+    _logger->info("Start st_coroutine network service");
 
     sigset_t sig_mask;
     sigemptyset(&sig_mask);
@@ -59,7 +63,8 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
     }
 
     int opts = 1;
-    if (setsockopt(_server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1) {
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1 ||
+        setsockopt(_server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
     }
@@ -70,7 +75,7 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
     }
 
     make_socket_non_blocking(_server_socket);
-    if (listen(_server_socket, 5) == -1) {
+    if (listen(_server_socket, SOMAXCONN) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
     }
@@ -80,6 +85,7 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
+    _running = true;
     _work_thread = std::thread(&ServerImpl::OnRun, this);
 }
 
@@ -97,92 +103,42 @@ void ServerImpl::Stop() {
 void ServerImpl::Join() {
     // Wait for work to be complete
     _work_thread.join();
+    close(_server_socket);
+    close(_event_fd);
 }
 
 // See ServerImpl.h
 void ServerImpl::OnRun() {
-    _logger->info("Start acceptor");
-    int epoll_descr = epoll_create1(0);
-    if (epoll_descr == -1) {
+    _logger->info("Start coroutines");
+    _epoll_fd = epoll_create1(0);
+    if (_epoll_fd == -1) {
         throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
     struct epoll_event event;
     event.events = EPOLLIN;
-    event.data.fd = _server_socket;
-    if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, _server_socket, &event)) {
+    event.data.ptr = this;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _server_socket, &event)) {
         throw std::runtime_error("Failed to add file descriptor to epoll");
     }
 
     struct epoll_event event2;
     event2.events = EPOLLIN;
-    event2.data.fd = _event_fd;
-    if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, _event_fd, &event2)) {
+    event2.data.ptr = nullptr;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event2)) {
         throw std::runtime_error("Failed to add file descriptor to epoll");
     }
 
-    bool run = true;
-    std::array<struct epoll_event, 64> mod_list;
-    while (run) {
-        int nmod = epoll_wait(epoll_descr, &mod_list[0], mod_list.size(), -1);
-        _logger->debug("Acceptor wokeup: {} events", nmod);
-
-        for (int i = 0; i < nmod; i++) {
-            struct epoll_event &current_event = mod_list[i];
-            if (current_event.data.fd == _event_fd) {
-                _logger->debug("Break acceptor due to stop signal");
-                run = false;
-                continue;
-            } else if (current_event.data.fd == _server_socket) {
-                OnNewConnection(epoll_descr);
-                continue;
-            }
-
-            // That is some connection!
-            Connection *pc = static_cast<Connection *>(current_event.data.ptr);
-
-            auto old_mask = pc->_event.events;
-            if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
-                pc->OnError();
-            } else if (current_event.events & EPOLLRDHUP) {
-                pc->OnClose();
-            } else {
-                // Depends on what connection wants...
-                if (current_event.events & EPOLLIN) {
-                    pc->DoRead();
-                }
-                if (current_event.events & EPOLLOUT) {
-                    pc->DoWrite();
-                }
-            }
-
-            // Does it alive?
-            if (!pc->isAlive()) {
-                if (epoll_ctl(epoll_descr, EPOLL_CTL_DEL, pc->_socket, &pc->_event)) {
-                    _logger->error("Failed to delete connection from epoll");
-                }
-
-                close(pc->_socket);
-                pc->OnClose();
+    // Returns once all coroutines are done
+    _engine.start(&ServerImpl::RunMain, *this);
 
-                delete pc;
-            } else if (pc->_event.events != old_mask) {
-                if (epoll_ctl(epoll_descr, EPOLL_CTL_MOD, pc->_socket, &pc->_event)) {
-                    _logger->error("Failed to change connection event mask");
-
-                    close(pc->_socket);
-                    pc->OnClose();
-
-                    delete pc;
-                }
-            }
-        }
-    }
-    _logger->warn("Acceptor stopped");
+    close(_epoll_fd);
+    _logger->warn("Coroutines stopped");
 }
 
-void ServerImpl::OnNewConnection(int epoll_descr) {
-    for (;;) {
+// See ServerImpl.h
+void ServerImpl::OnAccept() {
+    while (_running) {
         struct sockaddr in_addr;
         socklen_t in_len;
 
@@ -190,37 +146,105 @@ void ServerImpl::OnNewConnection(int epoll_descr) {
         in_len = sizeof in_addr;
         int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
         if (infd == -1) {
-            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
-                break; // We have processed all incoming connections.
-            } else {
-                _logger->error("Failed to accept socket");
-                break;
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                _logger->error("Failed to accept socket: {}", strerror(errno));
             }
+
+            // Wait for the next connection letting others run
+            _acceptor_waiting = true;
+            _engine.block();
+            _acceptor_waiting = false;
+            continue;
         }
 
         // Print host and service info.
-        char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
-        int retval =
-            getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf, NI_NUMERICHOST | NI_NUMERICSERV);
-        if (retval == 0) {
-            _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
+        if (_logger->should_log(spdlog::level::debug)) {
+            char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
+            int retval =
+                getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf, NI_NUMERICHOST | NI_NUMERICSERV);
+            if (retval == 0) {
+                _logger->debug("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
+            }
         }
 
-        // Register the new FD to be monitored by epoll.
-        Connection *pc = new (std::nothrow) Connection(infd);
+        // Register the new FD to be monitored by epoll, events are reported to the coroutine
+        Connection *pc = new (std::nothrow) Connection(infd, _engine, pStorage, _logger);
         if (pc == nullptr) {
-            throw std::runtime_error("Failed to allocate connection");
+            close(infd);
+            _logger->error("Failed to allocate connection");
+            continue;
+        }
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
+            _logger->error("Failed to register connection in epoll: {}", strerror(errno));
+            close(infd);
+            delete pc;
+            continue;
         }
+        _connections.insert(pc);
 
-        // Register connection in worker's epoll
-        pc->Start();
-        if (pc->isAlive()) {
-            if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
-                pc->OnError();
-                delete pc;
+        // Coroutine gets control once acceptor waits for the next connection
+        pc->_coroutine = _engine.run(&ServerImpl::RunConnection, *this, *pc);
+    }
+    _logger->warn("Acceptor stopped");
+}
+
+// See ServerImpl.h
+void ServerImpl::OnIdle() {
+    std::array<struct epoll_event, 64> mod_list;
+    bool woken = false;
+    while (_running && !woken) {
+        int nmod = epoll_wait(_epoll_fd, &mod_list[0], mod_list.size(), -1);
+        if (nmod == -1) {
+            if (errno != EINTR) {
+                _logger->error("Failed to wait for events: {}", strerror(errno));
+            }
+            continue;
+        }
+
+        for (int i = 0; i < nmod; i++) {
+            struct epoll_event &current_event = mod_list[i];
+            if (current_event.data.ptr == nullptr) {
+                _logger->debug("Stop coroutines due to stop signal");
+                _running = false;
+            } else if (current_event.data.ptr == this) {
+                if (_acceptor_waiting) {
+                    _engine.unblock(_acceptor);
+                    woken = true;
+                }
+            } else if (static_cast<Connection *>(current_event.data.ptr)->OnEvent()) {
+                woken = true;
             }
         }
     }
+
+    // Everyone has to finish, connections give up on their sockets once they get control
+    if (!_running) {
+        _engine.unblock(_acceptor);
+        for (Connection *pc : _connections) {
+            pc->OnStop();
+        }
+    }
+}
+
+// See ServerImpl.h
+void ServerImpl::OnClosed(Connection *pc) {
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pc->_socket, &pc->_event)) {
+        _logger->error("Failed to delete connection from epoll");
+    }
+    _connections.erase(pc);
+    close(pc->_socket);
+    delete pc;
+}
+
+void ServerImpl::RunMain(ServerImpl &server) {
+    server._acceptor = server._engine.run(&ServerImpl::RunAcceptor, server);
+}
+
+void ServerImpl::RunAcceptor(ServerImpl &server) { server.OnAccept(); }
+
+void ServerImpl::RunConnection(ServerImpl &server, Connection &conn) {
+    conn.Serve(server._read_buffer.data(), server._read_buffer.size());
+    server.OnClosed(&conn);
 }
 
 } // namespace STcoroutine
@@ -2,8 +2,10 @@
 #define AFINA_NETWORK_ST_COROUTINE_SERVER_H
 
 #include <thread>
+#include <unordered_set>
 #include <vector>
 
+#include <afina/coroutine/Engine.h>
 #include <afina/network/Server.h>
 
 namespace spdlog {
@@ -14,12 +16,15 @@ namespace Afina {
 namespace Network {
 namespace STcoroutine {
 
-// Forward declaration, see Worker.h
-class Worker;
+// Forward declaration, see Connection.h
+class Connection;
 
 /**
  * # Network resource manager implementation
- * Epoll based server
+ * Single thread server where acceptor and every connection run as coroutines of one engine. Code of
+ * the coroutine is plain blocking-style loop, but once socket would block coroutine gets blocked in the
+ * engine and others run. When all of them wait, engine calls unblocker which waits on epoll and unblocks
+ * the coroutines whose sockets are ready.
  */
 class ServerImpl : public Server {
 public:
@@ -37,9 +42,22 @@ public:
 
 protected:
     void OnRun();
-    void OnNewConnection(int);
+
+    // Accepts connections and starts coroutine for each of them until server stops
+    void OnAccept();
+
+    // Waits for epoll events and unblocks coroutines, called by engine once nobody could run
+    void OnIdle();
+
+    // Coroutine is done with the connection
+    void OnClosed(Connection *pc);
 
 private:
+    // Entry points of the coroutines, main one only starts acceptor
+    static void RunMain(ServerImpl &server);
+    static void RunAcceptor(ServerImpl &server);
+    static void RunConnection(ServerImpl &server, Connection &conn);
+
     // logger to use
     std::shared_ptr<spdlog::logger> _logger;
 
@@ -54,6 +72,25 @@ private:
     // Curstom event "device" used to wakeup workers
     int _event_fd;
 
+    // EPOLL instance of the IO thread
+    int _epoll_fd;
+
+    // Server is not stopped yet, read-only outside of IO thread
+    bool _running;
+
+    // Coroutines live here
+    Coroutine::Engine _engine;
+
+    // Acceptor coroutine, if it waits for new connections
+    void *_acceptor;
+    bool _acceptor_waiting;
+
+    // Connections being served
+    std::unordered_set<Connection *> _connections;
+
+    // Buffer all connections read into
+    std::vector<char> _read_buffer;
+
     // IO thread
     std::thread _work_thread;
 };
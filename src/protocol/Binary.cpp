@@ -0,0 +1,191 @@
+#include "Binary.h"
+
+#include <cstring>
+
+#include <endian.h>
+
+namespace Afina {
+namespace Protocol {
+namespace Binary {
+
+namespace {
+
+// Requests that return the key along with the value
+inline bool with_key(uint8_t opcode) { return opcode == GetK || opcode == GetKQ; }
+
+} // namespace
+
+// See Binary.h
+Header Header::decode(const char *data) {
+    Header header;
+    header.magic = uint8_t(data[0]);
+    header.opcode = uint8_t(data[1]);
+    std::memcpy(&header.key_length, data + 2, 2);
+    header.key_length = be16toh(header.key_length);
+    header.extras_length = uint8_t(data[4]);
+    header.data_type = uint8_t(data[5]);
+    std::memcpy(&header.status, data + 6, 2);
+    header.status = be16toh(header.status);
+    std::memcpy(&header.body_length, data + 8, 4);
+    header.body_length = be32toh(header.body_length);
+    std::memcpy(&header.opaque, data + 12, 4);
+    std::memcpy(&header.cas, data + 16, 8);
+    header.cas = be64toh(header.cas);
+    return header;
+}
+
+// See Binary.h
+void Header::encode(char *out) const {
+    uint16_t key_length_be = htobe16(key_length), status_be = htobe16(status);
+    uint32_t body_length_be = htobe32(body_length);
+    uint64_t cas_be = htobe64(cas);
+    out[0] = char(magic);
+    out[1] = char(opcode);
+    std::memcpy(out + 2, &key_length_be, 2);
+    out[4] = char(extras_length);
+    out[5] = char(data_type);
+    std::memcpy(out + 6, &status_be, 2);
+    std::memcpy(out + 8, &body_length_be, 4);
+    std::memcpy(out + 12, &opaque, 4);
+    std::memcpy(out + 16, &cas_be, 8);
+}
+
+// See Binary.h
+bool quiet(uint8_t opcode) {
+    switch (opcode) {
+    case GetQ:
+    case GetKQ:
+    case SetQ:
+    case AddQ:
+    case ReplaceQ:
+    case DeleteQ:
+    case IncrementQ:
+    case DecrementQ:
+    case QuitQ:
+    case FlushQ:
+    case AppendQ:
+    case PrependQ:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// See Binary.h
+void Encoder::Result(Execute::Response &out, Execute::Response::Status status, uint64_t cas) {
+    typedef Execute::Response::Status Result;
+
+    uint16_t code = NoError;
+    switch (status) {
+    case Result::Stored:
+    case Result::Deleted:
+    case Result::Touched:
+    case Result::Ok:
+        if (quiet(_opcode)) {
+            return;
+        }
+        break;
+    case Result::NotStored:
+        // Text protocol says NOT_STORED for every failed store, binary one tells why
+        if (_opcode == Add || _opcode == AddQ) {
+            code = KeyExists;
+        } else if (_opcode == Replace || _opcode == ReplaceQ) {
+            code = KeyNotFound;
+        } else {
+            code = ItemNotStored;
+        }
+        break;
+    case Result::Exists:
+        code = KeyExists;
+        break;
+    case Result::NotFound:
+        code = KeyNotFound;
+        break;
+    case Result::NotNumber:
+        code = NonNumeric;
+        break;
+    }
+
+    // Client takes version of the stored item from the response for its next cas
+    _packet(out, code, std::string(), 0, 0, code == NoError ? cas : 0);
+}
+
+// See Binary.h
+void Encoder::Value(Execute::Response &out, const std::string &key, const ItemView &item, bool) {
+    // Version is always sent in the header
+    static const std::string no_key;
+    const std::string &sent_key = with_key(_opcode) ? key : no_key;
+    _packet(out, NoError, sent_key, 4, item.header.size, item.header.cas);
+
+    uint32_t flags = htobe32(item.header.flags);
+    out.Append(reinterpret_cast<const char *>(&flags), 4).Append(sent_key).Append(item);
+}
+
+// See Binary.h
+void Encoder::Miss(Execute::Response &out, const std::string &key) {
+    if (quiet(_opcode)) {
+        return;
+    }
+    static const std::string no_key;
+    const std::string &sent_key = with_key(_opcode) ? key : no_key;
+    _packet(out, KeyNotFound, sent_key, 0, 0, 0);
+    out.Append(sent_key);
+}
+
+// See Binary.h
+void Encoder::Number(Execute::Response &out, uint64_t number, uint64_t cas) {
+    if (quiet(_opcode)) {
+        return;
+    }
+    _packet(out, NoError, std::string(), 0, 8, cas);
+    uint64_t value = htobe64(number);
+    out.Append(reinterpret_cast<const char *>(&value), 8);
+}
+
+// See Binary.h
+void Encoder::End(Execute::Response &out) {
+    // Stats are sent one per packet, packet without key terminates them. Other requests are done
+    // with the last packet they have sent
+    if (_opcode == Stat) {
+        _packet(out, NoError, std::string(), 0, 0, 0);
+    }
+}
+
+void Encoder::_packet(Execute::Response &out, uint16_t status, const std::string &key, uint8_t extras_length,
+                      std::size_t value_length, uint64_t cas) {
+    Header header;
+    header.magic = response_magic;
+    header.opcode = _opcode;
+    header.key_length = uint16_t(key.size());
+    header.extras_length = extras_length;
+    header.data_type = 0;
+    header.status = status;
+    header.body_length = uint32_t(extras_length + key.size() + value_length);
+    header.opaque = _opaque;
+    header.cas = cas;
+
+    char buf[header_size];
+    header.encode(buf);
+    out.Append(buf, header_size);
+}
+
+// See Binary.h
+void Command::Execute(Storage &storage, const std::string &args, Execute::Response &out) {
+    out.SetEncoder(&_encoder);
+    try {
+        _command->Execute(storage, args, out);
+    } catch (...) {
+        out.SetEncoder(nullptr);
+        throw;
+    }
+    out.SetEncoder(nullptr);
+}
+
+// See Binary.h
+void NoopCommand::Execute(Storage &storage, const std::string &args, Execute::Response &out) {
+    out.Result(Execute::Response::Status::Ok);
+}
+
+} // namespace Binary
+} // namespace Protocol
+} // namespace Afina
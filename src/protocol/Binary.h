@@ -0,0 +1,159 @@
+#ifndef AFINA_PROTOCOL_BINARY_H
+#define AFINA_PROTOCOL_BINARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
+
+namespace Afina {
+namespace Protocol {
+
+/**
+ * # Memcached binary protocol
+ * Every request and response starts with 24 bytes header, multi-byte fields are in network byte order.
+ * Header is followed by body: extras, key and value, their sizes are given in the header.
+ *
+ * Requests are parsed by Parser into the same commands as text ones, command is wrapped into
+ * Binary::Command which makes response encoded with the binary protocol. Quiet requests (getq, setq and
+ * others) get response only if something goes wrong or, for gets, if item is found, so that client could
+ * send a batch of them followed by noop and wait for the noop response only.
+ */
+namespace Binary {
+
+// First byte of the request, no text command starts with it
+const uint8_t request_magic = 0x80;
+const uint8_t response_magic = 0x81;
+
+const std::size_t header_size = 24;
+
+// Longest key allowed by memcached
+const std::size_t max_key = 250;
+
+enum Opcode : uint8_t {
+    Get = 0x00,
+    Set = 0x01,
+    Add = 0x02,
+    Replace = 0x03,
+    Delete = 0x04,
+    Increment = 0x05,
+    Decrement = 0x06,
+    Quit = 0x07,
+    Flush = 0x08,
+    GetQ = 0x09,
+    Noop = 0x0a,
+    Version = 0x0b,
+    GetK = 0x0c,
+    GetKQ = 0x0d,
+    Append = 0x0e,
+    Prepend = 0x0f,
+    Stat = 0x10,
+    SetQ = 0x11,
+    AddQ = 0x12,
+    ReplaceQ = 0x13,
+    DeleteQ = 0x14,
+    IncrementQ = 0x15,
+    DecrementQ = 0x16,
+    QuitQ = 0x17,
+    FlushQ = 0x18,
+    AppendQ = 0x19,
+    PrependQ = 0x1a,
+    Touch = 0x1c
+};
+
+enum Status : uint16_t {
+    NoError = 0x0000,
+    KeyNotFound = 0x0001,
+    KeyExists = 0x0002,
+    ValueTooLarge = 0x0003,
+    InvalidArguments = 0x0004,
+    ItemNotStored = 0x0005,
+    NonNumeric = 0x0006,
+    UnknownCommand = 0x0081,
+    OutOfMemory = 0x0082
+};
+
+// Request or response header
+struct Header {
+    uint8_t magic;
+    uint8_t opcode;
+    uint16_t key_length;
+    uint8_t extras_length;
+    uint8_t data_type;
+
+    // vbucket id in request, status in response
+    uint16_t status;
+    uint32_t body_length;
+
+    // Copied from request into response as is
+    uint32_t opaque;
+    uint64_t cas;
+
+    // Reads header from the wire, data must have header_size bytes
+    static Header decode(const char *data);
+
+    // Writes header to the wire, out must have room for header_size bytes
+    void encode(char *out) const;
+
+    // Bytes of the value that follows extras and key
+    inline std::size_t value_length() const { return body_length - extras_length - key_length; }
+};
+
+// Request gets no response if it succeeds
+bool quiet(uint8_t opcode);
+
+/**
+ * # Response of one request
+ * Encodes results reported by the command as binary protocol packets
+ */
+class Encoder : public Execute::Response::Encoder {
+public:
+    explicit Encoder(const Header &request) : _opcode(request.opcode), _opaque(request.opaque) {}
+
+    void Result(Execute::Response &out, Execute::Response::Status status, uint64_t cas) override;
+    void Value(Execute::Response &out, const std::string &key, const ItemView &item, bool cas) override;
+    void Miss(Execute::Response &out, const std::string &key) override;
+    void Number(Execute::Response &out, uint64_t number, uint64_t cas) override;
+    void End(Execute::Response &out) override;
+
+private:
+    void _packet(Execute::Response &out, uint16_t status, const std::string &key, uint8_t extras_length,
+                 std::size_t value_length, uint64_t cas);
+
+    uint8_t _opcode;
+    uint32_t _opaque;
+};
+
+/**
+ * # Binary request
+ * Runs parsed command with the response encoded in binary protocol
+ */
+class Command : public Execute::Command {
+public:
+    Command(std::unique_ptr<Execute::Command> command, const Header &request)
+        : _command(std::move(command)), _encoder(request) {}
+
+    void Execute(Storage &storage, const std::string &args, Execute::Response &out) override;
+
+private:
+    std::unique_ptr<Execute::Command> _command;
+    Encoder _encoder;
+};
+
+/**
+ * # No operation
+ * Responds with success, ends batch of quiet requests
+ */
+class NoopCommand : public Execute::Command {
+public:
+    void Execute(Storage &storage, const std::string &args, Execute::Response &out) override;
+};
+
+} // namespace Binary
+} // namespace Protocol
+} // namespace Afina
+
+#endif // AFINA_PROTOCOL_BINARY_H
@@ -1,199 +1,604 @@
 #include "Parser.h"
 
-#include <iostream>
-#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <stdexcept>
 
+#include <endian.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #include <afina/execute/Add.h>
 #include <afina/execute/Append.h>
+#include <afina/execute/Cas.h>
 #include <afina/execute/Command.h>
+#include <afina/execute/Decr.h>
 #include <afina/execute/Delete.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Gets.h>
+#include <afina/execute/Incr.h>
+#include <afina/execute/Prepend.h>
+#include <afina/execute/Replace.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
+#include <afina/execute/Touch.h>
 
 namespace Afina {
 namespace Protocol {
 
+namespace {
+
+// Bit i of the mask is set if byte i of the block is space or line feed
+#if defined(__AVX2__)
+const std::size_t block_size = 32;
+
+inline uint32_t delimiters(const char *block) {
+    __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+    __m256i spaces = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' '));
+    __m256i feeds = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n'));
+    return uint32_t(_mm256_movemask_epi8(_mm256_or_si256(spaces, feeds)));
+}
+#elif defined(__SSE2__)
+const std::size_t block_size = 16;
+
+inline uint32_t delimiters(const char *block) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+    __m128i spaces = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+    __m128i feeds = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'));
+    return uint32_t(_mm_movemask_epi8(_mm_or_si128(spaces, feeds)));
+}
+#else
+const std::size_t block_size = 8;
+
+inline uint32_t delimiters(const char *block) {
+    uint32_t mask = 0;
+    for (std::size_t i = 0; i < block_size; i++) {
+        mask |= uint32_t(block[i] == ' ' || block[i] == '\n') << i;
+    }
+    return mask;
+}
+#endif
+
+// Command names are resolved by perfect hash of the first two chars, the last one and the length. Table
+// has room for the commands to come, hash is collision free for all of the memcached text protocol
+const std::size_t names_bits = 5;
+
+inline std::size_t name_hash(const char *name, std::size_t size) {
+    return (uint32_t(uint8_t(name[0])) * 6 + uint32_t(uint8_t(name[1])) * 9 + uint32_t(uint8_t(name[size - 1])) * 3 +
+            size) &
+           ((1 << names_bits) - 1);
+}
+
+const std::string command_names[] = {"",      "get",    "gets", "set",  "add",  "replace", "append", "prepend",
+                                     "stats", "cas",    "delete", "incr", "decr", "touch",   "noop"};
+
+// Commands that have text form, the rest of command_names are binary only and stay out of the table
+const uint8_t text_commands = 14;
+
+struct names_table {
+    uint8_t slots[1 << names_bits];
+
+    names_table() {
+        std::memset(slots, 0, sizeof(slots));
+        for (uint8_t i = 1; i < text_commands; i++) {
+            const std::string &name = command_names[i];
+            slots[name_hash(name.data(), name.size())] = i;
+        }
+    }
+};
+
+const names_table command_table;
+
+// Parses decimal number of type T, negative one only if T is signed
+template <typename T> T parse_number(const Parser::Span &token, const char *field) {
+    const char *p = token.data, *end = token.data + token.size;
+    bool negative = std::numeric_limits<T>::is_signed && p != end && *p == '-';
+    if (negative) {
+        p++;
+    }
+    if (p == end) {
+        throw std::runtime_error(std::string(field) + " field is empty");
+    }
+
+    T limit = negative ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    T result = 0;
+    for (; p != end; p++) {
+        unsigned digit = unsigned(*p) - '0';
+        if (digit > 9) {
+            throw std::runtime_error(std::string(field) + " field has invalid char");
+        }
+        if (negative) {
+            if (result < (limit + T(digit)) / 10) {
+                throw std::runtime_error(std::string(field) + " field overflow");
+            }
+            result = result * 10 - T(digit);
+        } else {
+            if (result > (limit - T(digit)) / 10) {
+                throw std::runtime_error(std::string(field) + " field overflow");
+            }
+            result = result * 10 + T(digit);
+        }
+    }
+    return result;
+}
+
+// Encoder of the response nobody waits for, drops every result so that nothing gets formatted
+class Silent : public Execute::Response::Encoder {
+public:
+    void Result(Execute::Response &, Execute::Response::Status, uint64_t) override {}
+    void Value(Execute::Response &, const std::string &, const ItemView &, bool) override {}
+    void Miss(Execute::Response &, const std::string &) override {}
+    void Number(Execute::Response &, uint64_t, uint64_t) override {}
+    void End(Execute::Response &) override {}
+};
+
+Silent silent;
+
+// Text command with noreply, connection has nothing to send after it
+class NoReplyCommand : public Execute::Command {
+public:
+    explicit NoReplyCommand(std::unique_ptr<Execute::Command> command) : _command(std::move(command)) {}
+
+    void Execute(Storage &storage, const std::string &args, Execute::Response &out) override {
+        out.SetEncoder(&silent);
+        try {
+            _command->Execute(storage, args, out);
+        } catch (...) {
+            out.SetEncoder(nullptr);
+            throw;
+        }
+        out.SetEncoder(nullptr);
+    }
+
+private:
+    std::unique_ptr<Execute::Command> _command;
+};
+
+// Reads unaligned value
+template <typename T> inline T load(const char *data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+} // namespace
+
 // See Parse.h
 bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
-    size_t pos;
     parsed = 0;
+    if (_command != cUnknown) {
+        return true;
+    }
+    if (_binary || (_line.empty() && size > 0 && uint8_t(input[0]) == Binary::request_magic)) {
+        return _parse_binary(input, size, parsed);
+    }
 
-    for (pos = 0; pos < size && !parse_complete; pos++) {
-        char c = input[pos];
-        // std::cout << "[" << pos << "] '" << c << "': state=" << int(state) << std::endl;
-
-        switch (state) {
-        case State::sName: {
-            if (c == ' ' || c == '\r') {
-                // std::cout << "parser debug: name='" << name << "'" << std::endl;
-                if (name == "set" || name == "add" || name == "append" || name == "prepend") {
-                    state = State::spKey;
-                } else if (name == "get" || name == "gets") {
-                    state = State::sgKey;
-                } else if (name == "stats") {
-                    state = State::sLF;
-                    continue;
-                } else {
-                    throw std::runtime_error("Unknown command name: " + name);
-                }
-            } else {
-                name.push_back(c);
-            }
-            break;
+    // Fast path: whole line is in the input, tokens point right into it
+    if (_line.empty()) {
+        std::size_t end = _tokenize(input, size);
+        if (end < size) {
+            parsed = end + 1;
+            _finish();
+            return true;
         }
+        if (size > max_line) {
+            throw std::runtime_error("Command line is too long");
+        }
+        _line.append(input, size);
+        parsed = size;
+        return false;
+    }
 
-        case State::spKey: {
-            if (c == ' ') {
-                state = State::spFlags;
-                keys.push_back(curKey);
-                // std::cout << "parser debug: key[" << keys.size() - 1 << "]='" << curKey << "'" << std::endl;
-            } else {
-                curKey.push_back(c);
-            }
-            break;
-        }
-
-        case State::sgKey: {
-            if (c == '\r') {
-                keys.push_back(curKey);
-                // std::cout << "parser debug: total '" << keys.size() << " keys" << std::endl;
-
-                if (keys.size() == 0) {
-                    throw std::runtime_error("Client provides no key to retrive");
-                }
-
-                curKey.clear();
-                state = State::sLF;
-            } else if (c == ' ') {
-                // std::cout << "parser debug: key[" << keys.size() << "]='" << curKey << "'" << std::endl;
-                state = State::sgKey;
-                keys.push_back(curKey);
-                curKey.clear();
-            } else {
-                curKey.push_back(c);
-            }
-            break;
-        }
-
-        case State::spFlags: {
-            if (c == ' ') {
-                negative = false;
-                state = State::spExprTimeStart;
-                // std::cout << "parser debug: flags='" << flags << "'" << std::endl;
-            } else if (c >= '0' && c <= '9') {
-                uint32_t f = (flags * 10) + (c - '0');
-                if (f < flags) {
-                    // Overflow
-                    throw std::runtime_error("Flags field overflow");
-                }
-                flags = f;
-            }
-            break;
+    // Line continues, collect it until the line feed
+    const char *feed = static_cast<const char *>(std::memchr(input, '\n', size));
+    parsed = feed != nullptr ? feed - input + 1 : size;
+    if (_line.size() + parsed > max_line) {
+        throw std::runtime_error("Command line is too long");
+    }
+    _line.append(input, parsed);
+    if (feed == nullptr) {
+        return false;
+    }
+
+    _tokenize(_line.data(), _line.size());
+    _finish();
+    return true;
+}
+
+std::size_t Parser::_tokenize(const char *input, std::size_t size) {
+    _tokens.clear();
+    std::size_t start = 0, pos = 0;
+
+    // Delimiters at the given position close the token which started after the previous one
+    auto close_token = [this, input, &start](std::size_t pos) -> bool {
+        std::size_t end = pos;
+        if (input[pos] == '\n' && end > start && input[end - 1] == '\r') {
+            end--;
+        }
+        if (end > start) {
+            _tokens.push_back(Span{input + start, end - start});
         }
+        start = pos + 1;
+        return input[pos] == '\n';
+    };
 
-        case State::spExprTimeStart: {
-            if (c == '-') {
-                negative = true;
-                state = State::spExprTime;
-            } else if (c >= '0' && c <= '9') {
-                exprtime = (c - '0');
-                state = State::spExprTime;
-            }
-            break;
-        }
-
-        case State::spExprTime: {
-            if (c == ' ') {
-                state = State::spBytes;
-                // std::cout << "parser debug: ExprTime='" << exprtime << "'" << std::endl;
-            } else if (c >= '0' && c <= '9') {
-                int32_t et = exprtime;
-                if (negative) {
-                    et -= (c - '0');
-                    if (et > exprtime) {
-                        throw std::runtime_error("Expire time field overflow");
-                    }
-                } else {
-                    et += (c - '0');
-                    if (et < exprtime) {
-                        throw std::runtime_error("Expire time field overflow");
-                    }
-                }
-                exprtime = et;
-            }
-            break;
-        }
-
-        case State::spBytes: {
-            if (c == '\r') {
-                state = State::sLF;
-                // std::cout << "parser debug: bytes='" << bytes << "'" << std::endl;
-            } else if (c >= '0' && c <= '9') {
-                uint32_t b = (bytes * 10) + (c - '0');
-                if (b < bytes) {
-                    // Overflow
-                    throw std::runtime_error("Bytes field overflow");
-                }
-                bytes = b;
+    for (; pos + block_size <= size; pos += block_size) {
+        uint32_t mask = delimiters(input + pos);
+        while (mask != 0) {
+            std::size_t found = pos + __builtin_ctz(mask);
+            if (close_token(found)) {
+                return found;
             }
-            break;
+            mask &= mask - 1;
         }
+    }
+    for (; pos < size; pos++) {
+        if ((input[pos] == ' ' || input[pos] == '\n') && close_token(pos)) {
+            return pos;
+        }
+    }
+    return size;
+}
 
-        case State::sLF: {
-            if (c == '\n') {
-                parse_complete = true;
-            } else {
-                std::stringstream err;
-                err << "Invalid char " << (int)c << " at position " << (parsed + pos) << ", \\n expected";
-                throw std::runtime_error(err.str());
-            }
-            break;
+void Parser::_finish() {
+    if (_tokens.empty()) {
+        throw std::runtime_error("Unknown command name: ");
+    }
+
+    // Update commands could end with noreply, get takes every token as a key
+    Command command = _lookup(_tokens[0]);
+    if (command != cGet && command != cGets && command != cStats && _tokens.size() > 1) {
+        const Span &last = _tokens.back();
+        if (last.size == 7 && std::memcmp(last.data, "noreply", 7) == 0) {
+            _noreply = true;
+            _tokens.pop_back();
         }
+    }
 
-        default:
-            throw std::runtime_error("Unknown state");
+    switch (command) {
+    case cSet:
+    case cAdd:
+    case cReplace:
+    case cAppend:
+    case cPrepend: {
+        // <command name> <key> <flags> <exptime> <bytes> [noreply]
+        if (_tokens.size() != 5) {
+            throw std::runtime_error("Wrong number of arguments for " + command_names[command]);
         }
+        _keys.push_back(_tokens[1]);
+        _flags = parse_number<uint32_t>(_tokens[2], "Flags");
+        _exprtime = parse_number<int32_t>(_tokens[3], "Expire time");
+        _bytes = parse_number<uint32_t>(_tokens[4], "Bytes");
+        break;
     }
 
-    parsed += pos;
-    return parse_complete;
+    case cCas: {
+        // cas <key> <flags> <exptime> <bytes> <cas unique> [noreply]
+        if (_tokens.size() != 6) {
+            throw std::runtime_error("Wrong number of arguments for " + command_names[command]);
+        }
+        _keys.push_back(_tokens[1]);
+        _flags = parse_number<uint32_t>(_tokens[2], "Flags");
+        _exprtime = parse_number<int32_t>(_tokens[3], "Expire time");
+        _bytes = parse_number<uint32_t>(_tokens[4], "Bytes");
+        _cas = parse_number<uint64_t>(_tokens[5], "Cas unique");
+        break;
+    }
+
+    case cGet:
+    case cGets: {
+        if (_tokens.size() < 2) {
+            throw std::runtime_error("Client provides no key to retrive");
+        }
+        _keys.assign(_tokens.begin() + 1, _tokens.end());
+        break;
+    }
+
+    case cDelete: {
+        // delete <key> [noreply]
+        if (_tokens.size() != 2) {
+            throw std::runtime_error("Wrong number of arguments for " + command_names[command]);
+        }
+        _keys.push_back(_tokens[1]);
+        break;
+    }
+
+    case cIncr:
+    case cDecr: {
+        // incr <key> <value> [noreply]
+        if (_tokens.size() != 3) {
+            throw std::runtime_error("Wrong number of arguments for " + command_names[command]);
+        }
+        _keys.push_back(_tokens[1]);
+        _delta = parse_number<uint64_t>(_tokens[2], "Value");
+        break;
+    }
+
+    case cTouch: {
+        // touch <key> <exptime> [noreply]
+        if (_tokens.size() != 3) {
+            throw std::runtime_error("Wrong number of arguments for " + command_names[command]);
+        }
+        _keys.push_back(_tokens[1]);
+        _exprtime = parse_number<int32_t>(_tokens[2], "Expire time");
+        break;
+    }
+
+    case cStats:
+        break;
+
+    default:
+        throw std::runtime_error("Unknown command name: " + _tokens[0].str());
+    }
+
+    _own_keys();
+    _command = command;
+}
+
+bool Parser::_parse_binary(const char *input, std::size_t size, std::size_t &parsed) {
+    _binary = true;
+
+    // Size of the request without value, header must be known to find it out
+    auto request_size = [](const char *header) -> std::size_t {
+        Binary::Header request = Binary::Header::decode(header);
+        if (request.magic != Binary::request_magic) {
+            throw std::runtime_error("Bad magic of binary request");
+        }
+        if (request.key_length > Binary::max_key || request.extras_length + request.key_length > request.body_length) {
+            throw std::runtime_error("Bad lengths in binary request header");
+        }
+        return Binary::header_size + request.extras_length + request.key_length;
+    };
+
+    // Fast path: whole request is in the input
+    if (_line.empty() && size >= Binary::header_size) {
+        std::size_t need = request_size(input);
+        if (size >= need) {
+            parsed = need;
+            _finish_binary(input);
+            return true;
+        }
+    }
+
+    // Request continues, collect it
+    for (;;) {
+        std::size_t need = _line.size() < Binary::header_size ? Binary::header_size : request_size(_line.data());
+        if (_line.size() >= need) {
+            _finish_binary(_line.data());
+            return true;
+        }
+        if (parsed == size) {
+            return false;
+        }
+        std::size_t take = std::min(need - _line.size(), size - parsed);
+        _line.append(input + parsed, take);
+        parsed += take;
+    }
+}
+
+void Parser::_finish_binary(const char *request) {
+    _request = Binary::Header::decode(request);
+    const char *extras = request + Binary::header_size;
+    Span key{extras + _request.extras_length, _request.key_length};
+
+    Command command = cUnknown;
+    switch (_request.opcode) {
+    case Binary::Set:
+    case Binary::SetQ:
+        command = cSet;
+        break;
+    case Binary::Add:
+    case Binary::AddQ:
+        command = cAdd;
+        break;
+    case Binary::Replace:
+    case Binary::ReplaceQ:
+        command = cReplace;
+        break;
+    case Binary::Append:
+    case Binary::AppendQ:
+        command = cAppend;
+        break;
+    case Binary::Prepend:
+    case Binary::PrependQ:
+        command = cPrepend;
+        break;
+    case Binary::Get:
+    case Binary::GetQ:
+    case Binary::GetK:
+    case Binary::GetKQ:
+        command = cGet;
+        break;
+    case Binary::Delete:
+    case Binary::DeleteQ:
+        command = cDelete;
+        break;
+    case Binary::Increment:
+    case Binary::IncrementQ:
+        command = cIncr;
+        break;
+    case Binary::Decrement:
+    case Binary::DecrementQ:
+        command = cDecr;
+        break;
+    case Binary::Touch:
+        command = cTouch;
+        break;
+    case Binary::Stat:
+        command = cStats;
+        break;
+    case Binary::Noop:
+        command = cNoop;
+        break;
+    default:
+        throw std::runtime_error("Unknown binary command: " + std::to_string(_request.opcode));
+    }
+
+    // Set, add and replace carry flags and expiration time in extras, incr and decr carry delta, initial
+    // value and expiration time, touch carries expiration time. Others have no extras at all
+    std::size_t extras_length = 0;
+    if (command == cSet || command == cAdd || command == cReplace) {
+        extras_length = 8;
+    } else if (command == cIncr || command == cDecr) {
+        extras_length = 20;
+    } else if (command == cTouch) {
+        extras_length = 4;
+    }
+    if (_request.extras_length != extras_length) {
+        throw std::runtime_error("Wrong extras for " + command_names[command]);
+    }
+    if (command == cSet || command == cAdd || command == cReplace) {
+        _flags = be32toh(load<uint32_t>(extras));
+        _exprtime = int32_t(be32toh(load<uint32_t>(extras + 4)));
+    } else if (command == cIncr || command == cDecr) {
+        _delta = be64toh(load<uint64_t>(extras));
+        _initial = be64toh(load<uint64_t>(extras + 8));
+        uint32_t exprtime = be32toh(load<uint32_t>(extras + 16));
+        _create = exprtime != UINT32_MAX;
+        _exprtime = int32_t(exprtime);
+    } else if (command == cTouch) {
+        _exprtime = int32_t(be32toh(load<uint32_t>(extras)));
+    }
+
+    // Set and replace with known version of the item are check and set
+    if ((command == cSet || command == cReplace) && _request.cas != 0) {
+        command = cCas;
+        _cas = _request.cas;
+    }
+
+    bool storage = command == cSet || command == cAdd || command == cReplace || command == cAppend ||
+                   command == cPrepend || command == cCas;
+    if (command != cStats && command != cNoop && key.size == 0) {
+        throw std::runtime_error("Binary " + command_names[command] + " has no key");
+    }
+    if (!storage && _request.value_length() != 0) {
+        throw std::runtime_error("Binary " + command_names[command] + " has value");
+    }
+    if (command != cStats && key.size != 0) {
+        _keys.push_back(key);
+    }
+    _bytes = uint32_t(_request.value_length());
+
+    _own_keys();
+    _command = command;
+}
+
+void Parser::_own_keys() {
+    // Keys are moved out of the input, so that it could be reused before the command is built
+    _key_data.clear();
+    for (const Span &key : _keys) {
+        _key_data.append(key.data, key.size);
+    }
+    const char *data = _key_data.data();
+    for (Span &key : _keys) {
+        key.data = data;
+        data += key.size;
+    }
+}
+
+Parser::Command Parser::_lookup(const Span &name) {
+    if (name.size < 2) {
+        return cUnknown;
+    }
+    Command command = Command(command_table.slots[name_hash(name.data, name.size)]);
+    const std::string &expected = command_names[command];
+    if (expected.size() != name.size || std::memcmp(expected.data(), name.data, name.size) != 0) {
+        return cUnknown;
+    }
+    return command;
 }
 
 // See Parse.h
 std::unique_ptr<Execute::Command> Parser::Build(size_t &body_size) const {
-    if (state != State::sLF) {
+    if (_command == cUnknown) {
         return std::unique_ptr<Execute::Command>(nullptr);
     }
 
-    body_size = bytes;
-    if (name == "set") {
-        return std::unique_ptr<Execute::Command>(new Execute::Set(keys[0], flags, exprtime));
-    } else if (name == "add") {
-        return std::unique_ptr<Execute::Command>(new Execute::Add(keys[0], flags, exprtime));
-    } else if (name == "append") {
-        return std::unique_ptr<Execute::Command>(new Execute::Append(keys[0], flags, exprtime));
-    } else if (name == "get") {
+    body_size = _bytes;
+    if (_binary) {
+        return std::unique_ptr<Execute::Command>(new Binary::Command(_build(), _request));
+    }
+    if (_noreply) {
+        return std::unique_ptr<Execute::Command>(new NoReplyCommand(_build()));
+    }
+    return _build();
+}
+
+std::unique_ptr<Execute::Command> Parser::_build() const {
+    switch (_command) {
+    case cSet:
+        return std::unique_ptr<Execute::Command>(new Execute::Set(_keys[0].str(), _flags, _exprtime));
+    case cAdd:
+        return std::unique_ptr<Execute::Command>(new Execute::Add(_keys[0].str(), _flags, _exprtime));
+    case cReplace:
+        return std::unique_ptr<Execute::Command>(new Execute::Replace(_keys[0].str(), _flags, _exprtime));
+    case cAppend:
+        return std::unique_ptr<Execute::Command>(new Execute::Append(_keys[0].str(), _flags, _exprtime));
+    case cPrepend:
+        return std::unique_ptr<Execute::Command>(new Execute::Prepend(_keys[0].str(), _flags, _exprtime));
+    case cCas:
+        return std::unique_ptr<Execute::Command>(new Execute::Cas(_keys[0].str(), _flags, _exprtime, _cas));
+    case cGet:
+    case cGets: {
+        std::vector<std::string> keys;
+        keys.reserve(_keys.size());
+        for (const Span &key : _keys) {
+            keys.push_back(key.str());
+        }
+        if (_command == cGets) {
+            return std::unique_ptr<Execute::Command>(new Execute::Gets(keys));
+        }
         return std::unique_ptr<Execute::Command>(new Execute::Get(keys));
-    } else if (name == "stats") {
+    }
+    case cDelete:
+        return std::unique_ptr<Execute::Command>(new Execute::Delete(_keys[0].str()));
+    case cIncr:
+    case cDecr: {
+        std::unique_ptr<Execute::ArithmeticCommand> command;
+        if (_command == cIncr) {
+            command.reset(new Execute::Incr(_keys[0].str(), _delta));
+        } else {
+            command.reset(new Execute::Decr(_keys[0].str(), _delta));
+        }
+        if (_create) {
+            command->CreateMissing(_initial, _exprtime);
+        }
+        return std::unique_ptr<Execute::Command>(std::move(command));
+    }
+    case cTouch:
+        return std::unique_ptr<Execute::Command>(new Execute::Touch(_keys[0].str(), _exprtime));
+    case cStats:
         return std::unique_ptr<Execute::Command>(new Execute::Stats());
-    } else {
+    case cNoop:
+        return std::unique_ptr<Execute::Command>(new Binary::NoopCommand());
+    default:
         throw std::runtime_error("Unsupported command");
     }
 }
 
 // See Parse.h
 void Parser::Reset() {
-    state = State::sName;
-    name.clear();
-    keys.clear();
-    curKey.clear();
-    parse_complete = false;
-    flags = 0;
-    bytes = 0;
-    exprtime = 0;
+    _command = cUnknown;
+    _binary = false;
+    _noreply = false;
+    _line.clear();
+    _tokens.clear();
+    _keys.clear();
+    _key_data.clear();
+    _flags = 0;
+    _bytes = 0;
+    _exprtime = 0;
+    _cas = 0;
+    _delta = 0;
+    _create = false;
+    _initial = 0;
 }
 
+// See Parse.h
+const std::string &Parser::Name() const { return command_names[_command]; }
+
 } // namespace Protocol
 } // namespace Afina
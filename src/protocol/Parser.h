@@ -8,6 +8,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "Binary.h"
+
 namespace Afina {
 namespace Execute {
 class Command;
@@ -16,11 +18,33 @@ namespace Protocol {
 
 /**
  * # Memcached protocol parser
- * Parser supports subset of memcached protocol
+ * Parser supports subset of memcached protocol, both text and binary ones. Request that starts with
+ * Binary::request_magic is binary, see Binary.h, any other is text.
+ *
+ * Command line is split into tokens in one pass: delimiters are found by SIMD compare of the whole
+ * block of input at once, tokens are kept as spans pointing right into the input, command name is
+ * resolved by perfect hash. Only keys are copied out, all together into one buffer, so that input
+ * could be reused right after Parse. Line that comes in several pieces is accumulated in the internal
+ * buffer. Buffers keep their capacity, so in steady state parser makes no allocations.
  */
 class Parser {
 public:
-    Parser() { Reset(); }
+    // Part of the parsed input
+    struct Span {
+        const char *data;
+        std::size_t size;
+
+        inline std::string str() const { return std::string(data, size); }
+    };
+
+    Parser() {
+        _line.reserve(256);
+        _key_data.reserve(256);
+        _tokens.reserve(16);
+        _keys.reserve(16);
+        Reset();
+    }
+
     /**
      * Push given string into parser input. Method returns true if it was a command parsed out
      * from comulative input. In a such case method Build will return new command
@@ -53,44 +77,110 @@ public:
      */
     void Reset();
 
-    inline const std::string &Name() const { return name; }
+    const std::string &Name() const;
 
-private:
-    /**
-     * State of the command parser. Prefixes are:
-     * - s: state for PUT and GET commands
-     * - sp: for PUT commands only
-     * - sg: for GET commands only
-     */
-    enum State : uint16_t { sCR, sLF, sName, spKey, spFlags, spExprTimeStart, spExprTime, spBytes, sgKey };
+    // Bytes that terminate data block and are not part of the command argument
+    inline std::size_t Trailer() const { return _binary ? 0 : 2; }
 
-    // Current parser state
-    State state;
+    // Client doesn't wait for the response of the parsed command, nothing is written to the output
+    // when it gets executed
+    inline bool NoReply() const { return _noreply; }
 
-    // vrious fields of the command
-    std::string name;
-    std::vector<std::string> keys;
+    // Keys of the parsed command, valid until Reset
+    inline const std::vector<Span> &Keys() const { return _keys; }
+
+    // Longest command line accepted, not including data block
+    static const std::size_t max_line = 8192;
+
+private:
+    // Commands known to the parser
+    enum Command : uint8_t {
+        cUnknown,
+        cGet,
+        cGets,
+        cSet,
+        cAdd,
+        cReplace,
+        cAppend,
+        cPrepend,
+        cStats,
+        cCas,
+        cDelete,
+        cIncr,
+        cDecr,
+        cTouch,
+        cNoop
+    };
+
+    // Splits line into tokens, returns position of the line feed or size if there is none
+    std::size_t _tokenize(const char *input, std::size_t size);
+
+    // Checks tokens of the complete line and extracts command parameters
+    void _finish();
+
+    // Resolves command name
+    static Command _lookup(const Span &name);
+
+    // Collects header, extras and key of the binary request
+    bool _parse_binary(const char *input, std::size_t size, std::size_t &parsed);
+
+    // Checks binary request, given its header, extras and key, and extracts command parameters
+    void _finish_binary(const char *request);
+
+    // Copies keys into _key_data, so that input could be reused
+    void _own_keys();
+
+    // Command of the parsed input, without protocol wrapper
+    std::unique_ptr<Execute::Command> _build() const;
+
+    // Current command, cUnknown until whole line is parsed
+    Command _command;
+
+    // Current request is in binary protocol, its header is kept for the response
+    bool _binary;
+
+    // Text command ended with noreply
+    bool _noreply;
+    Binary::Header _request;
+
+    // Beginning of the line which didn't fit into one input
+    std::string _line;
+
+    // Tokens of the current line, point either into the input or into _line
+    std::vector<Span> _tokens;
+
+    // Keys of the parsed command, point into _key_data
+    std::vector<Span> _keys;
+    std::string _key_data;
 
     // <flags> is an arbitrary 16-bit unsigned integer (written out in decimal) that the server stores along with
     // the data and sends back when the item is retrieved. Clients may use this as a bit field to store data-specific
     //  information; this field is opaque to the server. Note that in memcached 1.2.1 and higher, flags may be 32-bits,
     // instead of 16, but you might want to restrict yourself to 16 bits for compatibility with older versions.
-    uint32_t flags;
+    uint32_t _flags;
 
     // <exptime> is expiration time. If it's 0, the item never expires (although it may be deleted from the cache to
     // make place for other items). If it's non-zero (either Unix time or offset in seconds from current time), it is
     // guaranteed that clients will not be able to retrieve this item after the expiration time arrives (measured by
     // server time). If a negative value is given the item is immediately expired.
-    int32_t exprtime;
+    int32_t _exprtime;
 
     // <bytes> is the number of bytes in the data block to follow, *not*
     // including the delimiting \r\n. <bytes> may be zero (in which case
     // it's followed by an empty data block).
-    uint32_t bytes;
+    uint32_t _bytes;
+
+    // <cas unique> is a unique 64-bit value of an existing entry. Clients should use the value returned
+    // from the "gets" command when issuing "cas" updates.
+    uint64_t _cas;
+
+    // <value> is the amount by which the client wants to increase/decrease the item. It is a decimal
+    // representation of a 64-bit unsigned integer.
+    uint64_t _delta;
 
-    bool negative;
-    std::string curKey;
-    bool parse_complete;
+    // Binary incr/decr creates missing item with the initial value unless expiration is all ones
+    bool _create;
+    uint64_t _initial;
 };
 
 } // namespace Protocol
@@ -0,0 +1,289 @@
+#include "ClockLRU.h"
+
+#include <algorithm>
+
+#include "Counter.h"
+
+namespace Afina {
+namespace Backend {
+
+// See ClockLRU.h
+ClockLRU::ClockLRU(size_t max_size) : _max_size(max_size) {}
+
+// See ClockLRU.h
+ClockLRU::~ClockLRU() { _index.clear(); }
+
+// See ClockLRU.h
+bool ClockLRU::Put(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags, int32_t ttl,
+                   uint64_t *stored_cas) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    clock_entry *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        _put_absent(key, hash, value, flags, TimingWheel::deadline(now, ttl));
+    } else {
+        _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
+    }
+    return report_cas(stored_cas, _cas, true);
+}
+
+// See ClockLRU.h
+bool ClockLRU::PutIfAbsent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                           int32_t ttl, uint64_t *stored_cas) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    if (_find_alive(key, hash, now) == nullptr) {
+        _put_absent(key, hash, value, flags, TimingWheel::deadline(now, ttl));
+        return report_cas(stored_cas, _cas, true);
+    }
+    return false;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Set(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags, int32_t ttl,
+                   uint64_t *stored_cas) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    clock_entry *in_cache = _find_alive(key, hash, now);
+    if (in_cache != nullptr) {
+        _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
+        return report_cas(stored_cas, _cas, true);
+    }
+    return false;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Delete(const std::string &key, std::size_t hash) {
+    clock_entry *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        _delete(*in_cache);
+        return true;
+    }
+    return false;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Get(const std::string &key, std::size_t hash, std::string &value) {
+    clock_entry *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        value = in_cache->value;
+        in_cache->referenced = true;
+        return true;
+    }
+    return false;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Get(const std::string &key, std::size_t hash, const ItemReader &reader) {
+    clock_entry *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        reader(ItemHeader{in_cache->flags, in_cache->cas, in_cache->value.size()}, in_cache->value.data());
+        in_cache->referenced = true;
+        return true;
+    }
+    return false;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Touch(const std::string &key, std::size_t hash, int32_t ttl) {
+    uint32_t now = _clock();
+    clock_entry *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        return false;
+    }
+    _expire_at(*in_cache, TimingWheel::deadline(now, ttl));
+    in_cache->referenced = true;
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Append(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas) {
+    clock_entry *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr || in_cache->key.size() + in_cache->value.size() + data.size() > _max_size) {
+        return false;
+    }
+    _set_existing(*in_cache, in_cache->value + data, in_cache->flags, in_cache->deadline);
+    return report_cas(stored_cas, _cas, true);
+}
+
+// See ClockLRU.h
+bool ClockLRU::Prepend(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas) {
+    clock_entry *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr || in_cache->key.size() + in_cache->value.size() + data.size() > _max_size) {
+        return false;
+    }
+    _set_existing(*in_cache, data + in_cache->value, in_cache->flags, in_cache->deadline);
+    return report_cas(stored_cas, _cas, true);
+}
+
+// See ClockLRU.h
+Storage::UpdateResult ClockLRU::Increment(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                                          uint64_t *stored_cas) {
+    return _increment(key, hash, delta, false, value, stored_cas);
+}
+
+// See ClockLRU.h
+Storage::UpdateResult ClockLRU::Decrement(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                                          uint64_t *stored_cas) {
+    return _increment(key, hash, delta, true, value, stored_cas);
+}
+
+// See ClockLRU.h
+Storage::UpdateResult ClockLRU::CompareAndSwap(const std::string &key, std::size_t hash, const std::string &value,
+                                               uint32_t flags, int32_t ttl, uint64_t cas, uint64_t *stored_cas) {
+    // Value that could never fit is not stored, same as by Set
+    if (key.size() + value.size() > _max_size) {
+        return UpdateResult::NotFound;
+    }
+    uint32_t now = _clock();
+    clock_entry *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        return UpdateResult::NotFound;
+    }
+    if (in_cache->cas != cas) {
+        return UpdateResult::Exists;
+    }
+    _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
+    return report_cas(stored_cas, _cas, UpdateResult::Stored);
+}
+
+// See ClockLRU.h
+std::size_t ClockLRU::ReapExpired(std::size_t budget) { return _reap(_clock(), budget); }
+
+std::size_t ClockLRU::_reap(uint32_t now, std::size_t budget) {
+    return _wheel.advance(now, budget, [this](TimingWheel::timer &t) { _delete(static_cast<clock_entry &>(t)); });
+}
+
+ClockLRU::clock_entry *ClockLRU::_find_alive(const std::string &key, std::size_t hash, uint32_t now) {
+    clock_entry *in_cache = _index.find(hash, key);
+    if (in_cache != nullptr && TimingWheel::expired(*in_cache, now)) {
+        _delete(*in_cache);
+        return nullptr;
+    }
+    return in_cache;
+}
+
+Storage::UpdateResult ClockLRU::_increment(const std::string &key, std::size_t hash, uint64_t delta, bool decrement,
+                                           uint64_t &value, uint64_t *stored_cas) {
+    clock_entry *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr) {
+        return UpdateResult::NotFound;
+    }
+    uint64_t number;
+    if (!Counter::parse(in_cache->value.data(), in_cache->value.size(), number)) {
+        return UpdateResult::NotNumber;
+    }
+    value = Counter::apply(number, delta, decrement);
+
+    std::string formatted = Counter::format(value);
+    if (key.size() + formatted.size() > _max_size) {
+        return UpdateResult::NotFound;
+    }
+    _set_existing(*in_cache, formatted, in_cache->flags, in_cache->deadline);
+    return report_cas(stored_cas, _cas, UpdateResult::Stored);
+}
+
+void ClockLRU::_put_absent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                           uint32_t deadline) {
+    _evict(key.size() + value.size(), _entries.size());
+    _cache_size += key.size() + value.size();
+
+    if (_free.empty()) {
+        if (_entries.size() == _entries.capacity()) {
+            _grow();
+        }
+        _entries.push_back(clock_entry(key, hash, value));
+        _entries.back().flags = flags;
+        _entries.back().cas = ++_cas;
+        _index.insert(hash, &_entries.back());
+        _expire_at(_entries.back(), deadline);
+        return;
+    }
+
+    clock_entry &entry = _entries[_free.back()];
+    _free.pop_back();
+    entry.key = key;
+    entry.value = value;
+    entry.hash = hash;
+    entry.flags = flags;
+    entry.cas = ++_cas;
+    entry.used = true;
+    entry.referenced = false;
+    _index.insert(hash, &entry);
+    _expire_at(entry, deadline);
+}
+
+void ClockLRU::_set_existing(clock_entry &entry, const std::string &value, uint32_t flags, uint32_t deadline) {
+    _cache_size -= entry.value.size();
+    entry.value.clear();
+    _evict(value.size(), &entry - _entries.data());
+    _cache_size += value.size();
+    entry.value = value;
+    entry.flags = flags;
+    entry.cas = ++_cas;
+    entry.referenced = true;
+    _expire_at(entry, deadline);
+}
+
+void ClockLRU::_expire_at(clock_entry &entry, uint32_t deadline) {
+    if (deadline != 0) {
+        _wheel.schedule(entry, deadline);
+    } else {
+        _wheel.cancel(entry);
+    }
+}
+
+void ClockLRU::_delete(clock_entry &entry) {
+    _index.erase(entry.hash, &entry);
+    _wheel.cancel(entry);
+    _cache_size -= entry.key.size() + entry.value.size();
+    entry.used = false;
+    std::string().swap(entry.key);
+    std::string().swap(entry.value);
+    _free.push_back(&entry - _entries.data());
+}
+
+void ClockLRU::_grow() {
+    // Array is going to move, so timers leave the wheel and index gets rebuilt on the new place
+    std::vector<uint32_t> deadlines(_entries.size());
+    for (std::size_t i = 0; i < _entries.size(); ++i) {
+        deadlines[i] = _entries[i].deadline;
+        _wheel.cancel(_entries[i]);
+    }
+
+    _index.clear();
+    _entries.reserve(std::max(_entries.size() * 2, std::size_t(16)));
+    for (std::size_t i = 0; i < _entries.size(); ++i) {
+        clock_entry &entry = _entries[i];
+        if (entry.used) {
+            _index.insert(entry.hash, &entry);
+            _expire_at(entry, deadlines[i]);
+        }
+    }
+}
+
+void ClockLRU::_evict(std::size_t need, std::size_t keep) {
+    while (_max_size - _cache_size < need) {
+        clock_entry &entry = _entries[_hand];
+        if (entry.used && _hand != keep) {
+            if (entry.referenced) {
+                entry.referenced = false;
+            } else {
+                _delete(entry);
+            }
+        }
+        _hand = (_hand + 1) % _entries.size();
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
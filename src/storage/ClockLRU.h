@@ -0,0 +1,212 @@
+#ifndef AFINA_STORAGE_CLOCK_LRU_H
+#define AFINA_STORAGE_CLOCK_LRU_H
+
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "Hash.h"
+#include "HashIndex.h"
+#include "TimingWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # CLOCK approximation of LRU
+ * Entries live in the circular array, each one has reference bit. Hit only sets the bit, nothing is
+ * relinked. To free space the hand walks over the array: entry with the bit set loses it and
+ * survives one more round, entry without it gets evicted and its slot is reused by the next insert.
+ * As new entry takes slot right behind the hand, it is visited last, same as fresh element of LRU.
+ *
+ * Index points into the array, so it is rebuilt when array grows; that happens only until working
+ * set of the cache stabilizes. Size accounting is the same as in SimpleLRU. Expiration is the same as
+ * in SimpleLRU too, timers are moved to the new array together with the index.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class ClockLRU : public Afina::Storage {
+public:
+    ClockLRU(size_t max_size = 1024);
+    ~ClockLRU();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override { return Put(key, key_hash(key), value); }
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        return PutIfAbsent(key, key_hash(key), value);
+    }
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override { return Set(key, key_hash(key), value); }
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override { return Delete(key, key_hash(key)); }
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override { return Get(key, key_hash(key), value); }
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        return Put(key, key_hash(key), value, flags, ttl, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas = nullptr) override {
+        return PutIfAbsent(key, key_hash(key), value, flags, ttl, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        return Set(key, key_hash(key), value, flags, ttl, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, const ItemReader &reader) override { return Get(key, key_hash(key), reader); }
+
+    // Implements Afina::Storage interface
+    bool Touch(const std::string &key, int32_t ttl) override { return Touch(key, key_hash(key), ttl); }
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override {
+        return Append(key, key_hash(key), data, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override {
+        return Prepend(key, key_hash(key), data, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    UpdateResult Increment(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override {
+        return Increment(key, key_hash(key), delta, value, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    UpdateResult Decrement(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override {
+        return Decrement(key, key_hash(key), delta, value, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    UpdateResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                                uint64_t cas, uint64_t *stored_cas = nullptr) override {
+        return CompareAndSwap(key, key_hash(key), value, flags, ttl, cas, stored_cas);
+    }
+
+    // Same operations for the key which hash is already known, see key_hash
+    bool Put(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr);
+    bool PutIfAbsent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0,
+                     int32_t ttl = 0, uint64_t *stored_cas = nullptr);
+    bool Set(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr);
+    bool Delete(const std::string &key, std::size_t hash);
+    bool Get(const std::string &key, std::size_t hash, std::string &value);
+    bool Get(const std::string &key, std::size_t hash, const ItemReader &reader);
+    bool Touch(const std::string &key, std::size_t hash, int32_t ttl);
+    bool Append(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr);
+    bool Prepend(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr);
+    UpdateResult Increment(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr);
+    UpdateResult Decrement(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr);
+    UpdateResult CompareAndSwap(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                                int32_t ttl, uint64_t cas, uint64_t *stored_cas = nullptr);
+
+    /**
+     * Removes up to budget expired entries from memory, returns number of removed ones
+     */
+    std::size_t ReapExpired(std::size_t budget);
+
+    /**
+     * Replaces source of time for expiration, storage must be empty
+     */
+    void SetClock(uint32_t (*clock)()) {
+        _clock = clock;
+        _wheel.reset(_clock());
+    }
+
+private:
+    // Timer of the entry is scheduled if entry has expiration time
+    struct clock_entry : public TimingWheel::timer {
+        clock_entry(const std::string &k, std::size_t h, const std::string &v)
+            : key(k), value(v), hash(h), flags(0), cas(0), used(true), referenced(false) {}
+
+        std::string key;
+        std::string value;
+        std::size_t hash;
+        uint32_t flags;
+        uint64_t cas;
+
+        // Slot keeps some entry
+        bool used;
+
+        // Entry was read since the hand passed it last time
+        bool referenced;
+    };
+
+    // Compares key owned by the entry with the one requested
+    struct clock_key_equal {
+        bool operator()(const clock_entry &entry, const std::string &key) const { return entry.key == key; }
+    };
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be less the _max_size
+    std::size_t _max_size;
+
+    // Current size of cache
+    std::size_t _cache_size = 0;
+
+    // The clock itself and its hand
+    std::vector<clock_entry> _entries;
+    std::size_t _hand = 0;
+
+    // Slots of evicted/deleted entries
+    std::vector<std::size_t> _free;
+
+    // Index of used entries
+    HashIndex<clock_entry, clock_key_equal> _index;
+
+    // Version assigned to the last updated entry
+    uint64_t _cas = 0;
+
+    // Expiration times of entries
+    TimingWheel _wheel;
+    uint32_t (*_clock)() = &TimingWheel::clock;
+
+    // Number of expired items each update removes on the way
+    static const std::size_t _reap_batch = 16;
+
+    std::size_t _reap(uint32_t now, std::size_t budget);
+
+    // Returns entry for the key unless it is absent or expired, expired one gets deleted
+    clock_entry *_find_alive(const std::string &key, std::size_t hash, uint32_t now);
+
+    void _put_absent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                     uint32_t deadline);
+    void _set_existing(clock_entry &entry, const std::string &value, uint32_t flags, uint32_t deadline);
+    void _expire_at(clock_entry &entry, uint32_t deadline);
+
+    // Update keeps flags and expiration time of the entry
+    UpdateResult _increment(const std::string &key, std::size_t hash, uint64_t delta, bool decrement, uint64_t &value,
+                            uint64_t *stored_cas);
+    void _delete(clock_entry &entry);
+
+    // Moves entries into the larger array, index and timers follow them
+    void _grow();
+
+    // Runs the hand until there is room for extra bytes, entry in slot keep is never evicted
+    void _evict(std::size_t need, std::size_t keep);
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_CLOCK_LRU_H
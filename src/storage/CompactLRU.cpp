@@ -0,0 +1,421 @@
+#include "CompactLRU.h"
+
+#include <new>
+
+#include "Counter.h"
+
+namespace Afina {
+namespace Backend {
+
+// See CompactLRU.h
+CompactLRU::CompactLRU(size_t max_size, size_t min_chunk, double factor)
+    : _max_size(max_size), _arena(new char[max_size]), _slab(_arena.get(), max_size, min_chunk, factor) {
+    _lru_head.prev = &_lru_head;
+    _lru_head.next = &_lru_head;
+}
+
+// See CompactLRU.h
+CompactLRU::~CompactLRU() {
+    // Items live in the arena, nothing to release one by one
+    _lru_index.clear();
+}
+
+// See CompactLRU.h
+bool CompactLRU::Put(const std::string &key, const std::string &value) { return Put(key, key_hash(key), value); }
+
+// See CompactLRU.h
+bool CompactLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return PutIfAbsent(key, key_hash(key), value);
+}
+
+// See CompactLRU.h
+bool CompactLRU::Set(const std::string &key, const std::string &value) { return Set(key, key_hash(key), value); }
+
+// See CompactLRU.h
+bool CompactLRU::Delete(const std::string &key) { return Delete(key, key_hash(key)); }
+
+// See CompactLRU.h
+bool CompactLRU::Get(const std::string &key, std::string &value) { return Get(key, key_hash(key), value); }
+
+// See CompactLRU.h
+bool CompactLRU::Put(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas) {
+    return Put(key, key_hash(key), value, flags, ttl, stored_cas);
+}
+
+// See CompactLRU.h
+bool CompactLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                             uint64_t *stored_cas) {
+    return PutIfAbsent(key, key_hash(key), value, flags, ttl, stored_cas);
+}
+
+// See CompactLRU.h
+bool CompactLRU::Set(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas) {
+    return Set(key, key_hash(key), value, flags, ttl, stored_cas);
+}
+
+// See CompactLRU.h
+bool CompactLRU::Get(const std::string &key, const ItemReader &reader) { return Get(key, key_hash(key), reader); }
+
+// See CompactLRU.h
+bool CompactLRU::Get(const std::string &key, ItemView &view) { return Get(key, key_hash(key), view); }
+
+// See CompactLRU.h
+bool CompactLRU::Touch(const std::string &key, int32_t ttl) { return Touch(key, key_hash(key), ttl); }
+
+// See CompactLRU.h
+bool CompactLRU::Put(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas) {
+    if (item_size(key.size(), value.size()) == 0) {
+        return false;
+    }
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    lru_item *in_cache = _find_alive(key, hash, now);
+    bool stored = in_cache == nullptr ? _put_absent(key, hash, value, flags, TimingWheel::deadline(now, ttl))
+                                      : _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
+    return report_cas(stored_cas, _cas, stored);
+}
+
+// See CompactLRU.h
+bool CompactLRU::PutIfAbsent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                             int32_t ttl, uint64_t *stored_cas) {
+    if (item_size(key.size(), value.size()) == 0) {
+        return false;
+    }
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    if (_find_alive(key, hash, now) == nullptr) {
+        bool stored = _put_absent(key, hash, value, flags, TimingWheel::deadline(now, ttl));
+        return report_cas(stored_cas, _cas, stored);
+    }
+    return false;
+}
+
+// See CompactLRU.h
+bool CompactLRU::Set(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas) {
+    if (item_size(key.size(), value.size()) == 0) {
+        return false;
+    }
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    lru_item *in_cache = _find_alive(key, hash, now);
+    if (in_cache != nullptr) {
+        bool stored = _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
+        return report_cas(stored_cas, _cas, stored);
+    }
+    return false;
+}
+
+// See CompactLRU.h
+bool CompactLRU::Delete(const std::string &key, std::size_t hash) {
+    lru_item *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        _delete(*in_cache);
+        return true;
+    }
+    return false;
+}
+
+// See CompactLRU.h
+bool CompactLRU::Get(const std::string &key, std::size_t hash, std::string &value) {
+    lru_item *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        value.assign(in_cache->value(), in_cache->value_size);
+        _unlink(*in_cache);
+        _link_fresh(*in_cache);
+        return true;
+    }
+    return false;
+}
+
+// See CompactLRU.h
+bool CompactLRU::Get(const std::string &key, std::size_t hash, const ItemReader &reader) {
+    lru_item *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        reader(ItemHeader{in_cache->flags, in_cache->cas, in_cache->value_size}, in_cache->value());
+        _unlink(*in_cache);
+        _link_fresh(*in_cache);
+        return true;
+    }
+    return false;
+}
+
+// See CompactLRU.h
+bool CompactLRU::Get(const std::string &key, std::size_t hash, ItemView &view) {
+    lru_item *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        auto copy = std::make_shared<std::string>(in_cache->value(), in_cache->value_size);
+        view.header = ItemHeader{in_cache->flags, in_cache->cas, in_cache->value_size};
+        view.value = std::shared_ptr<const char>(copy, copy->data());
+        _unlink(*in_cache);
+        _link_fresh(*in_cache);
+        return true;
+    }
+    return false;
+}
+
+// See CompactLRU.h
+bool CompactLRU::Touch(const std::string &key, std::size_t hash, int32_t ttl) {
+    uint32_t now = _clock();
+    lru_item *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        return false;
+    }
+    _expire_at(*in_cache, TimingWheel::deadline(now, ttl));
+    _unlink(*in_cache);
+    _link_fresh(*in_cache);
+    return true;
+}
+
+// See CompactLRU.h
+bool CompactLRU::Append(const std::string &key, const std::string &data, uint64_t *stored_cas) {
+    return Append(key, key_hash(key), data, stored_cas);
+}
+
+// See CompactLRU.h
+bool CompactLRU::Append(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas) {
+    lru_item *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr) {
+        return false;
+    }
+    std::size_t old_size = in_cache->value_size;
+    lru_item *item = _resize(*in_cache, old_size + data.size(), 0, old_size);
+    if (item == nullptr) {
+        return false;
+    }
+    std::memcpy(item->value() + old_size, data.data(), data.size());
+    return report_cas(stored_cas, item->cas, true);
+}
+
+// See CompactLRU.h
+bool CompactLRU::Prepend(const std::string &key, const std::string &data, uint64_t *stored_cas) {
+    return Prepend(key, key_hash(key), data, stored_cas);
+}
+
+// See CompactLRU.h
+bool CompactLRU::Prepend(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas) {
+    lru_item *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr) {
+        return false;
+    }
+    std::size_t old_size = in_cache->value_size;
+    lru_item *item = _resize(*in_cache, old_size + data.size(), data.size(), old_size);
+    if (item == nullptr) {
+        return false;
+    }
+    std::memcpy(item->value(), data.data(), data.size());
+    return report_cas(stored_cas, item->cas, true);
+}
+
+// See CompactLRU.h
+Storage::UpdateResult CompactLRU::Increment(const std::string &key, uint64_t delta, uint64_t &value,
+                                            uint64_t *stored_cas) {
+    return _increment(key, key_hash(key), delta, false, value, stored_cas);
+}
+
+// See CompactLRU.h
+Storage::UpdateResult CompactLRU::Increment(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                                            uint64_t *stored_cas) {
+    return _increment(key, hash, delta, false, value, stored_cas);
+}
+
+// See CompactLRU.h
+Storage::UpdateResult CompactLRU::Decrement(const std::string &key, uint64_t delta, uint64_t &value,
+                                            uint64_t *stored_cas) {
+    return _increment(key, key_hash(key), delta, true, value, stored_cas);
+}
+
+// See CompactLRU.h
+Storage::UpdateResult CompactLRU::Decrement(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                                            uint64_t *stored_cas) {
+    return _increment(key, hash, delta, true, value, stored_cas);
+}
+
+// See CompactLRU.h
+Storage::UpdateResult CompactLRU::CompareAndSwap(const std::string &key, const std::string &value, uint32_t flags,
+                                                 int32_t ttl, uint64_t cas, uint64_t *stored_cas) {
+    return CompareAndSwap(key, key_hash(key), value, flags, ttl, cas, stored_cas);
+}
+
+// See CompactLRU.h
+Storage::UpdateResult CompactLRU::CompareAndSwap(const std::string &key, std::size_t hash, const std::string &value,
+                                                 uint32_t flags, int32_t ttl, uint64_t cas, uint64_t *stored_cas) {
+    // Value that could never fit is not stored, same as by Set
+    if (item_size(key.size(), value.size()) == 0) {
+        return UpdateResult::NotFound;
+    }
+    uint32_t now = _clock();
+    lru_item *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        return UpdateResult::NotFound;
+    }
+    if (in_cache->cas != cas) {
+        return UpdateResult::Exists;
+    }
+    if (!_set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl))) {
+        return UpdateResult::NotFound;
+    }
+    return report_cas(stored_cas, _cas, UpdateResult::Stored);
+}
+
+// See CompactLRU.h
+std::size_t CompactLRU::ReapExpired(std::size_t budget) { return _reap(_clock(), budget); }
+
+std::size_t CompactLRU::_reap(uint32_t now, std::size_t budget) {
+    return _wheel.advance(now, budget, [this](TimingWheel::timer &t) { _delete(static_cast<lru_item &>(t)); });
+}
+
+CompactLRU::lru_item *CompactLRU::_find_alive(const std::string &key, std::size_t hash, uint32_t now) {
+    lru_item *in_cache = _lru_index.find(hash, key);
+    if (in_cache != nullptr && TimingWheel::expired(*in_cache, now)) {
+        _delete(*in_cache);
+        return nullptr;
+    }
+    return in_cache;
+}
+
+bool CompactLRU::_put_absent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                             uint32_t deadline) {
+    // Evict old items until allocator finds a chunk. Note that freed chunk could be of a different
+    // class, it helps only once whole page gets released
+    std::size_t need = sizeof(lru_item) + key.size() + value.size();
+    void *memory;
+    while ((memory = _slab.try_alloc(need)) == nullptr) {
+        if (_lru_head.next == &_lru_head) {
+            return false;
+        }
+        _delete(*_lru_head.next);
+    }
+
+    lru_item *item = new (memory) lru_item;
+    item->hash = hash;
+    item->key_size = key.size();
+    item->value_size = value.size();
+    item->flags = flags;
+    item->cas = ++_cas;
+    std::memcpy(item->key(), key.data(), key.size());
+    std::memcpy(item->value(), value.data(), value.size());
+
+    _cache_size += item_size(key.size(), value.size());
+    _link_fresh(*item);
+    _lru_index.insert(hash, item);
+    _expire_at(*item, deadline);
+    return true;
+}
+
+bool CompactLRU::_set_existing(lru_item &item, const std::string &value, uint32_t flags, uint32_t deadline) {
+    // Old value is released only once the new block is there, so failed update keeps it
+    lru_item *updated = _resize(item, value.size(), 0, 0);
+    if (updated == nullptr) {
+        return false;
+    }
+    std::memcpy(updated->value(), value.data(), value.size());
+    updated->flags = flags;
+    _expire_at(*updated, deadline);
+    return true;
+}
+
+void CompactLRU::_expire_at(lru_item &item, uint32_t deadline) {
+    if (deadline != 0) {
+        _wheel.schedule(item, deadline);
+    } else {
+        _wheel.cancel(item);
+    }
+}
+
+CompactLRU::lru_item *CompactLRU::_resize(lru_item &item, std::size_t value_size, std::size_t offset,
+                                          std::size_t keep) {
+    std::size_t new_size = item_size(item.key_size, value_size);
+    if (new_size == 0) {
+        return nullptr;
+    }
+
+    _unlink(item);
+    if (new_size == item_size(item.key_size, item.value_size)) {
+        std::memmove(item.value() + offset, item.value(), keep);
+        item.value_size = value_size;
+        item.cas = ++_cas;
+        _link_fresh(item);
+        return &item;
+    }
+
+    // Item is out of the list while new block is being allocated, so it never gets evicted
+    std::size_t need = sizeof(lru_item) + item.key_size + value_size;
+    lru_item *moved;
+    while ((moved = static_cast<lru_item *>(_slab.try_alloc(need))) == nullptr && _lru_head.next != &_lru_head) {
+        _delete(*_lru_head.next);
+    }
+
+    // Nothing left but the item itself, so its page is the one new chunk has to come from. That is the
+    // only case item is copied out to be released before the new block is allocated
+    std::size_t hash = item.hash, key_size = item.key_size, old_size = item.value_size;
+    uint32_t deadline = item.deadline, flags = item.flags;
+    std::string copy;
+    const char *source = item.key();
+    bool released = moved == nullptr;
+    _lru_index.erase(hash, &item);
+    _wheel.cancel(item);
+    _cache_size -= item_size(key_size, old_size);
+    if (released) {
+        copy.assign(source, key_size + keep);
+        source = copy.data();
+        _slab.free(&item);
+        if ((moved = static_cast<lru_item *>(_slab.try_alloc(need))) == nullptr) {
+            return nullptr;
+        }
+    }
+
+    moved = new (moved) lru_item;
+    moved->hash = hash;
+    moved->key_size = key_size;
+    moved->value_size = value_size;
+    moved->flags = flags;
+    moved->cas = ++_cas;
+    std::memcpy(moved->key(), source, key_size);
+    std::memcpy(moved->value() + offset, source + key_size, keep);
+    if (!released) {
+        _slab.free(&item);
+    }
+
+    _cache_size += new_size;
+    _link_fresh(*moved);
+    _lru_index.insert(hash, moved);
+    _expire_at(*moved, deadline);
+    return moved;
+}
+
+Storage::UpdateResult CompactLRU::_increment(const std::string &key, std::size_t hash, uint64_t delta, bool decrement,
+                                             uint64_t &value, uint64_t *stored_cas) {
+    lru_item *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr) {
+        return UpdateResult::NotFound;
+    }
+    uint64_t number;
+    if (!Counter::parse(in_cache->value(), in_cache->value_size, number)) {
+        return UpdateResult::NotNumber;
+    }
+    value = Counter::apply(number, delta, decrement);
+
+    char buf[Counter::max_size];
+    std::size_t size = Counter::format(value, buf);
+    lru_item *item = _resize(*in_cache, size, 0, 0);
+    if (item == nullptr) {
+        return UpdateResult::NotFound;
+    }
+    std::memcpy(item->value(), buf, size);
+    return report_cas(stored_cas, item->cas, UpdateResult::Stored);
+}
+
+void CompactLRU::_delete(lru_item &item) {
+    _lru_index.erase(item.hash, &item);
+    _wheel.cancel(item);
+    _unlink(item);
+    _cache_size -= item_size(item.key_size, item.value_size);
+    _slab.free(&item);
+}
+
+} // namespace Backend
+} // namespace Afina
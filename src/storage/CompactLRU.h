@@ -0,0 +1,249 @@
+#ifndef AFINA_STORAGE_COMPACT_LRU_H
+#define AFINA_STORAGE_COMPACT_LRU_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <afina/Storage.h>
+#include <afina/allocator/Slab.h>
+
+#include "Hash.h"
+#include "HashIndex.h"
+#include "TimingWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # LRU over single block items
+ * Each item is one contiguous memory block: fixed header followed by key bytes and then value bytes.
+ * List links live in the header, so Put costs exactly one allocation and Get touches header and data
+ * that are next to each other.
+ *
+ * Items are allocated from slab allocator over the arena of max_size bytes which cache preallocates
+ * on construction, so cache never uses more memory than that no matter how keys and values change.
+ * Unlike SimpleLRU, cache size accounts real memory used by the item: header plus slab chunk rounding.
+ *
+ * Expiration is the same as in SimpleLRU, timer of the wheel is part of the item header.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class CompactLRU : public Afina::Storage {
+public:
+    /**
+     * @param max_size size of the arena to allocate items from
+     * @param min_chunk smallest slab class, see Allocator::Slab
+     * @param factor slab classes growth factor, see Allocator::Slab
+     */
+    CompactLRU(size_t max_size = 1 << 20, size_t min_chunk = 48, double factor = 1.25);
+    ~CompactLRU();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, const ItemReader &reader) override;
+
+    // Implements Afina::Storage interface, value is copied as arena memory is reused by updates
+    bool Get(const std::string &key, ItemView &view) override;
+
+    // Implements Afina::Storage interface
+    bool Touch(const std::string &key, int32_t ttl) override;
+
+    // Implements Afina::Storage interface, value grows in place while it fits into the same chunk
+    bool Append(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface, value grows in place while it fits into the same chunk
+    bool Prepend(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface
+    UpdateResult Increment(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface
+    UpdateResult Decrement(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface
+    UpdateResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                                uint64_t cas, uint64_t *stored_cas = nullptr) override;
+
+    // Same operations for the key which hash is already known, see key_hash
+    bool Put(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr);
+    bool PutIfAbsent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0,
+                     int32_t ttl = 0, uint64_t *stored_cas = nullptr);
+    bool Set(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr);
+    bool Delete(const std::string &key, std::size_t hash);
+    bool Get(const std::string &key, std::size_t hash, std::string &value);
+    bool Get(const std::string &key, std::size_t hash, const ItemReader &reader);
+    bool Get(const std::string &key, std::size_t hash, ItemView &view);
+    bool Touch(const std::string &key, std::size_t hash, int32_t ttl);
+    bool Append(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr);
+    bool Prepend(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr);
+    UpdateResult Increment(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr);
+    UpdateResult Decrement(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr);
+    UpdateResult CompareAndSwap(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                                int32_t ttl, uint64_t cas, uint64_t *stored_cas = nullptr);
+
+    /**
+     * Number of bytes item with the given key/value sizes occupies in this cache, 0 if such item
+     * could not be stored at all
+     */
+    inline std::size_t item_size(std::size_t key_size, std::size_t value_size) const {
+        return _slab.chunk_size(sizeof(lru_item) + key_size + value_size);
+    }
+
+    // Current size of cache, see item_size
+    inline std::size_t size() const { return _cache_size; }
+
+    /**
+     * Removes up to budget expired items from memory, returns number of removed ones
+     */
+    std::size_t ReapExpired(std::size_t budget);
+
+    /**
+     * Replaces source of time for expiration, storage must be empty
+     */
+    void SetClock(uint32_t (*clock)()) {
+        _clock = clock;
+        _wheel.reset(_clock());
+    }
+
+private:
+    // Header of the item block, key and value follow it. Timer is scheduled if item has expiration time
+    struct lru_item : public TimingWheel::timer {
+        // Neighbours in the list, prev is older, next is fresher
+        lru_item *prev;
+        lru_item *next;
+
+        // Precomputed hash of the key
+        std::size_t hash;
+
+        uint32_t key_size;
+        uint32_t value_size;
+
+        // Opaque client flags and version of the item
+        uint32_t flags;
+        uint64_t cas;
+
+        inline char *key() { return reinterpret_cast<char *>(this + 1); }
+        inline const char *key() const { return reinterpret_cast<const char *>(this + 1); }
+        inline char *value() { return key() + key_size; }
+        inline const char *value() const { return key() + key_size; }
+    };
+
+    // Compares key stored inline in the item with the one requested
+    struct lru_key_equal {
+        bool operator()(const lru_item &item, const std::string &key) const {
+            return item.key_size == key.size() && std::memcmp(item.key(), key.data(), key.size()) == 0;
+        }
+    };
+
+    // Maximum number of bytes could be stored in this cache,
+    // i.e all items including headers must be less the _max_size
+    std::size_t _max_size;
+
+    // Current size of cache
+    std::size_t _cache_size = 0;
+
+    // Memory all items live in
+    std::unique_ptr<char[]> _arena;
+
+    // Allocator of item blocks over the _arena
+    Allocator::Slab _slab;
+
+    // Sentinel of the circular list of items. _lru_head.prev is the freshest item
+    // and _lru_head.next is the one that wasn't used for longest time.
+    //
+    // List owns all items
+    lru_item _lru_head;
+
+    // Index of items from the list above
+    HashIndex<lru_item, lru_key_equal> _lru_index;
+
+    // Version assigned to the last updated item
+    uint64_t _cas = 0;
+
+    // Expiration times of items
+    TimingWheel _wheel;
+    uint32_t (*_clock)() = &TimingWheel::clock;
+
+    // Number of expired items each update removes on the way
+    static const std::size_t _reap_batch = 16;
+
+    std::size_t _reap(uint32_t now, std::size_t budget);
+
+    // Returns item for the key unless it is absent or expired, expired one gets deleted
+    lru_item *_find_alive(const std::string &key, std::size_t hash, uint32_t now);
+
+    // Allocates new item and places it as the freshest one, evicting old items if required.
+    // Returns false if there is no way to find memory for the item
+    bool _put_absent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                     uint32_t deadline);
+
+    // Updates value of the existing item and marks it as the freshest one
+    bool _set_existing(lru_item &item, const std::string &value, uint32_t flags, uint32_t deadline);
+
+    // Schedules expiration of the item, 0 deadline means never
+    void _expire_at(lru_item &item, uint32_t deadline);
+
+    // Makes room for value_size bytes of value and marks item as the freshest one. First keep bytes of the
+    // old value are placed at the given offset of the new one, they are moved inside the block while it
+    // fits into the same chunk, otherwise item is copied into the new block. Returns the item to write rest
+    // of the value to, it has new version already. nullptr if item of such size could not be stored at all,
+    // old item is kept then
+    lru_item *_resize(lru_item &item, std::size_t value_size, std::size_t offset, std::size_t keep);
+
+    UpdateResult _increment(const std::string &key, std::size_t hash, uint64_t delta, bool decrement, uint64_t &value,
+                            uint64_t *stored_cas);
+
+    // Removes item from list and index and releases its memory
+    void _delete(lru_item &item);
+
+    inline void _unlink(lru_item &item) {
+        item.prev->next = item.next;
+        item.next->prev = item.prev;
+    }
+
+    inline void _link_fresh(lru_item &item) {
+        item.next = &_lru_head;
+        item.prev = _lru_head.prev;
+        _lru_head.prev->next = &item;
+        _lru_head.prev = &item;
+    }
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_COMPACT_LRU_H
@@ -0,0 +1,72 @@
+#ifndef AFINA_STORAGE_COUNTER_H
+#define AFINA_STORAGE_COUNTER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Value of incr/decr
+ * Value is decimal representation of 64-bit unsigned number. Same as memcached, trailing spaces are
+ * allowed, so that number could be updated in place without changing its length
+ */
+namespace Counter {
+
+// Parses value, returns false if it isn't a number
+inline bool parse(const char *data, std::size_t size, uint64_t &number) {
+    while (size > 0 && data[size - 1] == ' ') {
+        size--;
+    }
+    if (size == 0 || size > 20) {
+        return false;
+    }
+    number = 0;
+    for (std::size_t i = 0; i < size; i++) {
+        unsigned digit = unsigned(data[i]) - '0';
+        if (digit > 9 || number > (UINT64_MAX - digit) / 10) {
+            return false;
+        }
+        number = number * 10 + digit;
+    }
+    return true;
+}
+
+// Increment wraps around, decrement stops at zero
+inline uint64_t apply(uint64_t number, uint64_t delta, bool decrement) {
+    if (decrement) {
+        return number > delta ? number - delta : 0;
+    }
+    return number + delta;
+}
+
+// Longest value of the number
+const std::size_t max_size = 20;
+
+// Writes value of the number into out which has room for max_size chars, returns its size
+inline std::size_t format(uint64_t number, char *out) {
+    char buf[max_size];
+    char *p = buf + max_size;
+    do {
+        *--p = char('0' + number % 10);
+        number /= 10;
+    } while (number != 0);
+    std::size_t size = buf + max_size - p;
+    std::copy(p, buf + max_size, out);
+    return size;
+}
+
+// Value of the number
+inline std::string format(uint64_t number) {
+    char buf[max_size];
+    return std::string(buf, format(number, buf));
+}
+
+} // namespace Counter
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_COUNTER_H
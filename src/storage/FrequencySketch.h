@@ -0,0 +1,127 @@
+#ifndef AFINA_STORAGE_FREQUENCY_SKETCH_H
+#define AFINA_STORAGE_FREQUENCY_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Count-min sketch of 4 bit counters
+ * Estimates how often the key was seen recently using fixed amount of memory: each key maps to one
+ * counter in each of 4 rows, estimate is the minimum of them. Only the smallest counters are
+ * incremented (conservative update), which makes overestimation from collisions smaller.
+ *
+ * Counters saturate at 15 and all of them are halved once the number of increments reaches 10 times
+ * the number of counters in a row, so the sketch forgets old history and follows changes of popularity.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class FrequencySketch {
+public:
+    /**
+     * @param width number of counters in each row, rounded up to power of two; should be about the
+     * number of entries in the cache
+     */
+    explicit FrequencySketch(std::size_t width = 1024) { resize(width); }
+
+    // Drops the history and changes width of the sketch
+    void resize(std::size_t width) {
+        std::size_t n = 16;
+        while (n < width) {
+            n <<= 1;
+        }
+        _width_mask = n - 1;
+        _table.assign(rows * n / 16, 0);
+        _sample_size = 10 * n;
+        _additions = 0;
+    }
+
+    // Widens the sketch keeping the history: key maps to the counter which index has the same low bits as
+    // before, so each new counter starts with the value of the old one it was split from
+    void grow(std::size_t width) {
+        if (width <= this->width()) {
+            return;
+        }
+        std::vector<uint64_t> old_table;
+        old_table.swap(_table);
+        std::size_t old_width = this->width(), additions = _additions;
+        resize(width);
+
+        for (unsigned row = 0; row < rows; row++) {
+            for (std::size_t i = 0; i < this->width(); i++) {
+                std::size_t j = i & (old_width - 1);
+                uint64_t value = (old_table[row * (old_width / 16) + j / 16] >> _shift(j)) & 0xf;
+                _word(row, i) |= value << _shift(i);
+            }
+        }
+        _additions = additions;
+    }
+
+    // Number of counters in each row
+    inline std::size_t width() const { return _width_mask + 1; }
+
+    // Estimated number of times key with the hash was seen, up to 15
+    unsigned estimate(std::size_t hash) const {
+        unsigned result = 15;
+        for (unsigned row = 0; row < rows; row++) {
+            unsigned value = _counter(row, _index(hash, row));
+            result = value < result ? value : result;
+        }
+        return result;
+    }
+
+    // Records one more appearance of the key
+    void increment(std::size_t hash) {
+        unsigned min = estimate(hash);
+        if (min == 15) {
+            return;
+        }
+        for (unsigned row = 0; row < rows; row++) {
+            std::size_t i = _index(hash, row);
+            if (_counter(row, i) == min) {
+                _word(row, i) += uint64_t(1) << _shift(i);
+            }
+        }
+        if (++_additions >= _sample_size) {
+            _age();
+        }
+    }
+
+private:
+    static const unsigned rows = 4;
+
+    // Each row uses its own mix of the same hash
+    inline std::size_t _index(std::size_t hash, unsigned row) const {
+        static const uint64_t seeds[rows] = {0xc3a5c85c97cb3127ull, 0xb492b66fbe98f273ull, 0x9ae16a3b2f90404full,
+                                             0xcbf29ce484222325ull};
+        uint64_t h = (uint64_t(hash) + seeds[row]) * seeds[(row + 1) % rows];
+        return std::size_t(h >> 32) & _width_mask;
+    }
+
+    // Counter i of the row lives in word i / 16 of that row, 4 bits each
+    inline uint64_t &_word(unsigned row, std::size_t i) { return _table[row * (width() / 16) + i / 16]; }
+    inline uint64_t _word(unsigned row, std::size_t i) const { return _table[row * (width() / 16) + i / 16]; }
+    inline unsigned _shift(std::size_t i) const { return unsigned(i % 16) * 4; }
+    inline unsigned _counter(unsigned row, std::size_t i) const { return (_word(row, i) >> _shift(i)) & 0xf; }
+
+    // Halves all counters at once
+    void _age() {
+        for (uint64_t &word : _table) {
+            word = (word >> 1) & 0x7777777777777777ull;
+        }
+        _additions /= 2;
+    }
+
+    std::size_t _width_mask;
+    std::vector<uint64_t> _table;
+    std::size_t _sample_size;
+    std::size_t _additions;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FREQUENCY_SKETCH_H
@@ -0,0 +1,102 @@
+#ifndef AFINA_STORAGE_HASH_H
+#define AFINA_STORAGE_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Key hash
+ * wyhash (final version by Wang Yi, public domain): a few multiplications per 16 bytes of the key,
+ * good enough distribution in both low and high bits. Low bits select slot in the HashIndex, high
+ * ones select shard in the StripedLock, so one hash computed per request serves both.
+ */
+namespace wyhash {
+
+static const uint64_t secret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+                                   0x4d5a2da51de1aa47ull};
+
+// 64x64 -> 128 multiplication, both halves are returned
+static inline void mum(uint64_t &a, uint64_t &b) {
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+}
+
+static inline uint64_t mix(uint64_t a, uint64_t b) {
+    mum(a, b);
+    return a ^ b;
+}
+
+static inline uint64_t read8(const uint8_t *p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t read4(const uint8_t *p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+static inline uint64_t read3(const uint8_t *p, size_t k) {
+    return (uint64_t(p[0]) << 16) | (uint64_t(p[k >> 1]) << 8) | p[k - 1];
+}
+
+static inline uint64_t hash(const void *key, size_t len, uint64_t seed = 0) {
+    const uint8_t *p = static_cast<const uint8_t *>(key);
+    seed ^= mix(seed ^ secret[0], secret[1]);
+
+    uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (read4(p) << 32) | read4(p + ((len >> 3) << 2));
+            b = (read4(p + len - 4) << 32) | read4(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = read3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+                see1 = mix(read8(p + 16) ^ secret[2], read8(p + 24) ^ see1);
+                see2 = mix(read8(p + 32) ^ secret[3], read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    mum(a, b);
+    return mix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+} // namespace wyhash
+
+// Hash used by all storages for their keys
+inline std::size_t key_hash(const std::string &key) { return wyhash::hash(key.data(), key.size()); }
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_HASH_H
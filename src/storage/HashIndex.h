@@ -0,0 +1,195 @@
+#ifndef AFINA_STORAGE_HASH_INDEX_H
+#define AFINA_STORAGE_HASH_INDEX_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Open addressing index
+ * Robin Hood hash table that maps keys to the nodes owning them. Index doesn't own nodes, it only
+ * keeps pointers so storage is free to place nodes wherever it likes.
+ *
+ * Callers compute the key hash once and pass it along with every call, so the same hash could be
+ * reused for sharding, lookup and removal. Each slot keeps full hash next to the node pointer: most
+ * of mismatches are rejected without touching the node, and the table never rehashes keys on grow.
+ *
+ * Equal must be callable as `bool(const Node &, const Key &)`.
+ *
+ * That is NOT thread safe implementation!!
+ */
+template <typename Node, typename Equal, typename Key = std::string> class HashIndex {
+public:
+    explicit HashIndex(std::size_t capacity = 16) : _size(0) {
+        std::size_t n = 16;
+        while (n < capacity) {
+            n <<= 1;
+        }
+        _slots.resize(n);
+        _mask = n - 1;
+    }
+
+    /**
+     * Returns node associated with the given key or nullptr if there is no such
+     */
+    Node *find(std::size_t hash, const Key &key) const {
+        std::size_t pos = hash & _mask;
+        for (std::size_t dist = 0;; dist++, pos = (pos + 1) & _mask) {
+            const slot &s = _slots[pos];
+            // Robin Hood invariant: key can't be further from its home than any key met on the way
+            if (s.node == nullptr || _distance(s.hash, pos) < dist) {
+                return nullptr;
+            }
+            if (s.hash == hash && _equal(*s.node, key)) {
+                return s.node;
+            }
+        }
+    }
+
+    /**
+     * Adds new node to the index. Key of the node must not be present in the index yet
+     */
+    void insert(std::size_t hash, Node *node) {
+        if ((_size + 1) * 8 > _slots.size() * 7) {
+            _grow();
+        }
+        _place(slot{hash, node});
+        _size++;
+    }
+
+    /**
+     * Removes association for the given key, returns node it was pointing to or nullptr if
+     * key wasn't found
+     */
+    Node *erase(std::size_t hash, const Key &key) {
+        std::size_t pos = hash & _mask;
+        for (std::size_t dist = 0;; dist++, pos = (pos + 1) & _mask) {
+            slot &s = _slots[pos];
+            if (s.node == nullptr || _distance(s.hash, pos) < dist) {
+                return nullptr;
+            }
+            if (s.hash == hash && _equal(*s.node, key)) {
+                Node *result = s.node;
+                _erase_at(pos);
+                return result;
+            }
+        }
+    }
+
+    /**
+     * Removes given node from the index, no key comparisons performed. Returns false if node
+     * isn't in the index
+     */
+    bool erase(std::size_t hash, const Node *node) {
+        std::size_t pos = hash & _mask;
+        for (std::size_t dist = 0;; dist++, pos = (pos + 1) & _mask) {
+            slot &s = _slots[pos];
+            if (s.node == nullptr || _distance(s.hash, pos) < dist) {
+                return false;
+            }
+            if (s.node == node) {
+                _erase_at(pos);
+                return true;
+            }
+        }
+    }
+
+    /**
+     * Changes node associated with the key that is already in index, for example when node was
+     * reallocated. Returns false if there was no association for the old node
+     */
+    bool replace(std::size_t hash, const Node *old_node, Node *new_node) {
+        std::size_t pos = hash & _mask;
+        for (std::size_t dist = 0;; dist++, pos = (pos + 1) & _mask) {
+            slot &s = _slots[pos];
+            if (s.node == nullptr || _distance(s.hash, pos) < dist) {
+                return false;
+            }
+            if (s.node == old_node) {
+                s.node = new_node;
+                return true;
+            }
+        }
+    }
+
+    void clear() {
+        for (auto &s : _slots) {
+            s.node = nullptr;
+        }
+        _size = 0;
+    }
+
+    inline std::size_t size() const { return _size; }
+    inline std::size_t capacity() const { return _slots.size(); }
+
+private:
+    struct slot {
+        std::size_t hash;
+        Node *node;
+    };
+
+    // How far slot at the given position is from the slot key's hash points to
+    inline std::size_t _distance(std::size_t hash, std::size_t pos) const { return (pos - (hash & _mask)) & _mask; }
+
+    // Robin Hood insertion: take slot from the "richer" element, the one closer to its home, and
+    // continue to place that element further
+    void _place(slot cur) {
+        std::size_t pos = cur.hash & _mask;
+        for (std::size_t dist = 0;; dist++, pos = (pos + 1) & _mask) {
+            slot &s = _slots[pos];
+            if (s.node == nullptr) {
+                s = cur;
+                return;
+            }
+
+            std::size_t existing = _distance(s.hash, pos);
+            if (existing < dist) {
+                std::swap(s, cur);
+                dist = existing;
+            }
+        }
+    }
+
+    // Backward shift deletion: no tombstones, so lookups never degrade after heavy churn
+    void _erase_at(std::size_t pos) {
+        std::size_t next = (pos + 1) & _mask;
+        while (_slots[next].node != nullptr && _distance(_slots[next].hash, next) != 0) {
+            _slots[pos] = _slots[next];
+            pos = next;
+            next = (next + 1) & _mask;
+        }
+        _slots[pos].node = nullptr;
+        _size--;
+    }
+
+    void _grow() {
+        std::vector<slot> old(_slots.size() * 2);
+        old.swap(_slots);
+        _mask = _slots.size() - 1;
+        for (auto &s : old) {
+            if (s.node != nullptr) {
+                _place(s);
+            }
+        }
+    }
+
+    // Table itself, size is always power of 2
+    std::vector<slot> _slots;
+
+    // _slots.size() - 1, turns hash into home slot position
+    std::size_t _mask;
+
+    // Number of nodes in the index
+    std::size_t _size;
+
+    Equal _equal;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_HASH_INDEX_H
@@ -0,0 +1,71 @@
+#ifndef AFINA_STORAGE_REAPER_H
+#define AFINA_STORAGE_REAPER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Background expiration
+ * Thread that periodically calls given function until stopped. Thread safe storages use it to reap
+ * expired items in small portions, each one under the storage lock taken for a short time.
+ */
+class Reaper {
+public:
+    Reaper(std::function<void()> reap, std::chrono::milliseconds period = std::chrono::milliseconds(100))
+        : _reap(reap), _period(period), _running(false) {}
+    ~Reaper() { Stop(); }
+
+    void Start() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_running) {
+            return;
+        }
+        _running = true;
+        _thread = std::thread(&Reaper::_run, this);
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_running) {
+                return;
+            }
+            _running = false;
+        }
+        _wakeup.notify_all();
+        _thread.join();
+    }
+
+private:
+    void _run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (_running) {
+            _wakeup.wait_for(lock, _period);
+            if (!_running) {
+                break;
+            }
+            lock.unlock();
+            _reap();
+            lock.lock();
+        }
+    }
+
+    std::function<void()> _reap;
+    std::chrono::milliseconds _period;
+
+    std::mutex _mutex;
+    std::condition_variable _wakeup;
+    bool _running;
+    std::thread _thread;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_REAPER_H
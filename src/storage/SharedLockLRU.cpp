@@ -0,0 +1,302 @@
+#include "SharedLockLRU.h"
+
+#include "Counter.h"
+
+namespace Afina {
+namespace Backend {
+
+// See SharedLockLRU.h
+SharedLockLRU::SharedLockLRU(size_t max_size)
+    : _max_size(max_size), _lru_head("", 0, ""),
+      _reaper([this]() { while (ReapExpired(reap_batch) == reap_batch) {} }) {
+    _lru_head.prev = &_lru_head;
+    _lru_head.next = &_lru_head;
+}
+
+// See SharedLockLRU.h
+SharedLockLRU::~SharedLockLRU() {
+    _reaper.Stop();
+    _lru_index.clear();
+    lru_node *node = _lru_head.next;
+    while (node != &_lru_head) {
+        lru_node *next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+// See SharedLockLRU.h
+bool SharedLockLRU::Put(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags, int32_t ttl,
+                        uint64_t *stored_cas) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    std::lock_guard<Concurrency::SharedMutex> guard(_lock);
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    lru_node *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        _put_absent(key, hash, value, flags, TimingWheel::deadline(now, ttl));
+    } else {
+        _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
+    }
+    return report_cas(stored_cas, _cas, true);
+}
+
+// See SharedLockLRU.h
+bool SharedLockLRU::PutIfAbsent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                                int32_t ttl, uint64_t *stored_cas) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    std::lock_guard<Concurrency::SharedMutex> guard(_lock);
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    if (_find_alive(key, hash, now) == nullptr) {
+        _put_absent(key, hash, value, flags, TimingWheel::deadline(now, ttl));
+        return report_cas(stored_cas, _cas, true);
+    }
+    return false;
+}
+
+// See SharedLockLRU.h
+bool SharedLockLRU::Set(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags, int32_t ttl,
+                        uint64_t *stored_cas) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    std::lock_guard<Concurrency::SharedMutex> guard(_lock);
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    lru_node *in_cache = _find_alive(key, hash, now);
+    if (in_cache != nullptr) {
+        _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
+        return report_cas(stored_cas, _cas, true);
+    }
+    return false;
+}
+
+// See SharedLockLRU.h
+bool SharedLockLRU::Delete(const std::string &key, std::size_t hash) {
+    std::lock_guard<Concurrency::SharedMutex> guard(_lock);
+    lru_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        _delete(*in_cache);
+        return true;
+    }
+    return false;
+}
+
+// See SharedLockLRU.h
+bool SharedLockLRU::Get(const std::string &key, std::size_t hash, std::string &value) {
+    Concurrency::SharedLock<Concurrency::SharedMutex> guard(_lock);
+    lru_node *in_cache = _find_shared(key, hash);
+    if (in_cache != nullptr) {
+        value = in_cache->value;
+        return true;
+    }
+    return false;
+}
+
+// See SharedLockLRU.h
+bool SharedLockLRU::Get(const std::string &key, std::size_t hash, const ItemReader &reader) {
+    Concurrency::SharedLock<Concurrency::SharedMutex> guard(_lock);
+    lru_node *in_cache = _find_shared(key, hash);
+    if (in_cache != nullptr) {
+        reader(ItemHeader{in_cache->flags, in_cache->cas, in_cache->value.size()}, in_cache->value.data());
+        return true;
+    }
+    return false;
+}
+
+// See SharedLockLRU.h
+bool SharedLockLRU::Get(const std::string &key, std::size_t hash, ItemView &view) {
+    Concurrency::SharedLock<Concurrency::SharedMutex> guard(_lock);
+    lru_node *in_cache = _find_shared(key, hash);
+    if (in_cache != nullptr) {
+        auto copy = std::make_shared<std::string>(in_cache->value);
+        view.header = ItemHeader{in_cache->flags, in_cache->cas, in_cache->value.size()};
+        view.value = std::shared_ptr<const char>(copy, copy->data());
+        return true;
+    }
+    return false;
+}
+
+// See SharedLockLRU.h
+bool SharedLockLRU::Touch(const std::string &key, std::size_t hash, int32_t ttl) {
+    std::lock_guard<Concurrency::SharedMutex> guard(_lock);
+    uint32_t now = _clock();
+    lru_node *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        return false;
+    }
+    _expire_at(*in_cache, TimingWheel::deadline(now, ttl));
+    in_cache->referenced.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+// See SharedLockLRU.h
+bool SharedLockLRU::Append(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas) {
+    std::lock_guard<Concurrency::SharedMutex> guard(_lock);
+    lru_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr || in_cache->key.size() + in_cache->value.size() + data.size() > _max_size) {
+        return false;
+    }
+    _set_existing(*in_cache, in_cache->value + data, in_cache->flags, in_cache->deadline);
+    return report_cas(stored_cas, _cas, true);
+}
+
+// See SharedLockLRU.h
+bool SharedLockLRU::Prepend(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas) {
+    std::lock_guard<Concurrency::SharedMutex> guard(_lock);
+    lru_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr || in_cache->key.size() + in_cache->value.size() + data.size() > _max_size) {
+        return false;
+    }
+    _set_existing(*in_cache, data + in_cache->value, in_cache->flags, in_cache->deadline);
+    return report_cas(stored_cas, _cas, true);
+}
+
+// See SharedLockLRU.h
+Storage::UpdateResult SharedLockLRU::Increment(const std::string &key, std::size_t hash, uint64_t delta,
+                                               uint64_t &value, uint64_t *stored_cas) {
+    return _increment(key, hash, delta, false, value, stored_cas);
+}
+
+// See SharedLockLRU.h
+Storage::UpdateResult SharedLockLRU::Decrement(const std::string &key, std::size_t hash, uint64_t delta,
+                                               uint64_t &value, uint64_t *stored_cas) {
+    return _increment(key, hash, delta, true, value, stored_cas);
+}
+
+// See SharedLockLRU.h
+Storage::UpdateResult SharedLockLRU::CompareAndSwap(const std::string &key, std::size_t hash, const std::string &value,
+                                                    uint32_t flags, int32_t ttl, uint64_t cas, uint64_t *stored_cas) {
+    // Value that could never fit is not stored, same as by Set
+    if (key.size() + value.size() > _max_size) {
+        return UpdateResult::NotFound;
+    }
+    std::lock_guard<Concurrency::SharedMutex> guard(_lock);
+    uint32_t now = _clock();
+    lru_node *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        return UpdateResult::NotFound;
+    }
+    if (in_cache->cas != cas) {
+        return UpdateResult::Exists;
+    }
+    _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
+    return report_cas(stored_cas, _cas, UpdateResult::Stored);
+}
+
+// See SharedLockLRU.h
+std::size_t SharedLockLRU::ReapExpired(std::size_t budget) {
+    std::lock_guard<Concurrency::SharedMutex> guard(_lock);
+    return _reap(_clock(), budget);
+}
+
+std::size_t SharedLockLRU::_reap(uint32_t now, std::size_t budget) {
+    return _wheel.advance(now, budget, [this](TimingWheel::timer &t) { _delete(static_cast<lru_node &>(t)); });
+}
+
+SharedLockLRU::lru_node *SharedLockLRU::_find_alive(const std::string &key, std::size_t hash, uint32_t now) {
+    lru_node *in_cache = _lru_index.find(hash, key);
+    if (in_cache != nullptr && TimingWheel::expired(*in_cache, now)) {
+        _delete(*in_cache);
+        return nullptr;
+    }
+    return in_cache;
+}
+
+Storage::UpdateResult SharedLockLRU::_increment(const std::string &key, std::size_t hash, uint64_t delta,
+                                                bool decrement, uint64_t &value, uint64_t *stored_cas) {
+    std::lock_guard<Concurrency::SharedMutex> guard(_lock);
+    lru_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr) {
+        return UpdateResult::NotFound;
+    }
+    uint64_t number;
+    if (!Counter::parse(in_cache->value.data(), in_cache->value.size(), number)) {
+        return UpdateResult::NotNumber;
+    }
+    value = Counter::apply(number, delta, decrement);
+
+    std::string formatted = Counter::format(value);
+    if (key.size() + formatted.size() > _max_size) {
+        return UpdateResult::NotFound;
+    }
+    _set_existing(*in_cache, formatted, in_cache->flags, in_cache->deadline);
+    return report_cas(stored_cas, _cas, UpdateResult::Stored);
+}
+
+SharedLockLRU::lru_node *SharedLockLRU::_find_shared(const std::string &key, std::size_t hash) {
+    // Expired node is only hidden, readers can't delete it
+    lru_node *in_cache = _lru_index.find(hash, key);
+    if (in_cache == nullptr || TimingWheel::expired(*in_cache, _clock())) {
+        return nullptr;
+    }
+    if (!in_cache->referenced.load(std::memory_order_relaxed)) {
+        in_cache->referenced.store(true, std::memory_order_relaxed);
+    }
+    return in_cache;
+}
+
+void SharedLockLRU::_put_absent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                                uint32_t deadline) {
+    _evict(key.size() + value.size());
+    _cache_size += key.size() + value.size();
+    lru_node *node = new lru_node(key, hash, value);
+    node->flags = flags;
+    node->cas = ++_cas;
+    _link_fresh(*node);
+    _lru_index.insert(hash, node);
+    _expire_at(*node, deadline);
+}
+
+void SharedLockLRU::_set_existing(lru_node &node, const std::string &value, uint32_t flags, uint32_t deadline) {
+    // Node must survive eviction below, so it is unlinked while space is freed
+    _unlink(node);
+    _cache_size -= node.value.size();
+    node.value.clear();
+    _evict(value.size());
+    _cache_size += value.size();
+    node.value = value;
+    node.flags = flags;
+    node.cas = ++_cas;
+    node.referenced.store(false, std::memory_order_relaxed);
+    _link_fresh(node);
+    _expire_at(node, deadline);
+}
+
+void SharedLockLRU::_expire_at(lru_node &node, uint32_t deadline) {
+    if (deadline != 0) {
+        _wheel.schedule(node, deadline);
+    } else {
+        _wheel.cancel(node);
+    }
+}
+
+void SharedLockLRU::_delete(lru_node &node) {
+    _lru_index.erase(node.hash, &node);
+    _wheel.cancel(node);
+    _unlink(node);
+    _cache_size -= node.key.size() + node.value.size();
+    delete &node;
+}
+
+void SharedLockLRU::_evict(std::size_t need) {
+    while (_max_size - _cache_size < need) {
+        lru_node *oldest = _lru_head.next;
+        if (oldest->referenced.load(std::memory_order_relaxed)) {
+            // Second chance: node was read since it was fresh last time
+            oldest->referenced.store(false, std::memory_order_relaxed);
+            _unlink(*oldest);
+            _link_fresh(*oldest);
+        } else {
+            _delete(*oldest);
+        }
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,246 @@
+#ifndef AFINA_STORAGE_SHARED_LOCK_LRU_H
+#define AFINA_STORAGE_SHARED_LOCK_LRU_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/SharedMutex.h>
+
+#include "Hash.h"
+#include "HashIndex.h"
+#include "Reaper.h"
+#include "TimingWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # LRU for read mostly workloads
+ * Get doesn't modify the list, so it runs under shared lock and readers don't block each other.
+ * Instead of moving node to the fresh end, Get only sets node's reference bit (written only if it
+ * isn't set yet, so hot nodes don't bounce between cores). Recency is applied lazily by writers:
+ * when the oldest node is about to be evicted and its bit is set, the bit is cleared and node gets
+ * second chance at the fresh end (CLOCK style approximation of LRU).
+ *
+ * Put/Set/Delete take the lock exclusively. Size accounting is the same as in SimpleLRU.
+ *
+ * Get only hides expired node, it is removed from memory by the next writer coming across it or by
+ * the timing wheel, which is advanced by writers and by background thread once started.
+ *
+ * That is thread safe implementation
+ */
+class SharedLockLRU : public Afina::Storage {
+public:
+    SharedLockLRU(size_t max_size = 1024);
+    ~SharedLockLRU();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override { return Put(key, key_hash(key), value); }
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        return PutIfAbsent(key, key_hash(key), value);
+    }
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override { return Set(key, key_hash(key), value); }
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override { return Delete(key, key_hash(key)); }
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override { return Get(key, key_hash(key), value); }
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        return Put(key, key_hash(key), value, flags, ttl, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas = nullptr) override {
+        return PutIfAbsent(key, key_hash(key), value, flags, ttl, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        return Set(key, key_hash(key), value, flags, ttl, stored_cas);
+    }
+
+    // Implements Afina::Storage interface, reader is called under shared lock
+    bool Get(const std::string &key, const ItemReader &reader) override { return Get(key, key_hash(key), reader); }
+
+    // Implements Afina::Storage interface, value is copied under shared lock
+    bool Get(const std::string &key, ItemView &view) override { return Get(key, key_hash(key), view); }
+
+    // Implements Afina::Storage interface
+    bool Touch(const std::string &key, int32_t ttl) override { return Touch(key, key_hash(key), ttl); }
+
+    // Implements Afina::Storage interface, under exclusive lock
+    bool Append(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override {
+        return Append(key, key_hash(key), data, stored_cas);
+    }
+
+    // Implements Afina::Storage interface, under exclusive lock
+    bool Prepend(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override {
+        return Prepend(key, key_hash(key), data, stored_cas);
+    }
+
+    // Implements Afina::Storage interface, under exclusive lock
+    UpdateResult Increment(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override {
+        return Increment(key, key_hash(key), delta, value, stored_cas);
+    }
+
+    // Implements Afina::Storage interface, under exclusive lock
+    UpdateResult Decrement(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override {
+        return Decrement(key, key_hash(key), delta, value, stored_cas);
+    }
+
+    // Implements Afina::Storage interface, under exclusive lock
+    UpdateResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                                uint64_t cas, uint64_t *stored_cas = nullptr) override {
+        return CompareAndSwap(key, key_hash(key), value, flags, ttl, cas, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    void Start() override { _reaper.Start(); }
+
+    // Implements Afina::Storage interface
+    void Stop() override { _reaper.Stop(); }
+
+    // Same operations for the key which hash is already known, see key_hash
+    bool Put(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr);
+    bool PutIfAbsent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0,
+                     int32_t ttl = 0, uint64_t *stored_cas = nullptr);
+    bool Set(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr);
+    bool Delete(const std::string &key, std::size_t hash);
+    bool Get(const std::string &key, std::size_t hash, std::string &value);
+    bool Get(const std::string &key, std::size_t hash, const ItemReader &reader);
+    bool Get(const std::string &key, std::size_t hash, ItemView &view);
+    bool Touch(const std::string &key, std::size_t hash, int32_t ttl);
+    bool Append(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr);
+    bool Prepend(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr);
+    UpdateResult Increment(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr);
+    UpdateResult Decrement(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr);
+    UpdateResult CompareAndSwap(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                                int32_t ttl, uint64_t cas, uint64_t *stored_cas = nullptr);
+
+    /**
+     * Removes up to budget expired nodes from memory under exclusive lock, returns number of removed ones
+     */
+    std::size_t ReapExpired(std::size_t budget);
+
+    /**
+     * Replaces source of time for expiration, storage must be empty
+     */
+    void SetClock(uint32_t (*clock)()) {
+        _clock = clock;
+        _wheel.reset(_clock());
+    }
+
+    // Number of expired nodes background thread removes under the lock at once
+    static const std::size_t reap_batch = 256;
+
+private:
+    // Timer of the node is scheduled if node has expiration time
+    struct lru_node : public TimingWheel::timer {
+        lru_node(const std::string &k, std::size_t h, const std::string &v)
+            : key(k), value(v), hash(h), flags(0), cas(0), prev(nullptr), next(nullptr), referenced(false) {}
+
+        const std::string key;
+        std::string value;
+        const std::size_t hash;
+        uint32_t flags;
+        uint64_t cas;
+
+        // Neighbours in the list, prev is older, next is fresher
+        lru_node *prev;
+        lru_node *next;
+
+        // Node was read since it was placed at the fresh end last time
+        std::atomic<bool> referenced;
+    };
+
+    // Compares key owned by the node with the one requested
+    struct lru_key_equal {
+        bool operator()(const lru_node &node, const std::string &key) const { return node.key == key; }
+    };
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be less the _max_size
+    std::size_t _max_size;
+
+    // Current size of cache, changed under exclusive lock only
+    std::size_t _cache_size = 0;
+
+    // Sentinel of the circular list. _lru_head.prev is the freshest node and _lru_head.next is the
+    // oldest one. List owns all nodes
+    lru_node _lru_head;
+
+    // Index of nodes from the list above
+    HashIndex<lru_node, lru_key_equal> _lru_index;
+
+    // Readers take it shared, everything that changes list, index or wheel takes it exclusive
+    Concurrency::SharedMutex _lock;
+
+    // Version assigned to the last updated node
+    uint64_t _cas = 0;
+
+    // Expiration times of nodes
+    TimingWheel _wheel;
+    uint32_t (*_clock)() = &TimingWheel::clock;
+
+    // Number of expired items each update removes on the way
+    static const std::size_t _reap_batch = 16;
+
+    Reaper _reaper;
+
+    // Following methods expect exclusive lock to be held
+    std::size_t _reap(uint32_t now, std::size_t budget);
+
+    // Returns node for the key unless it is absent or expired, expired one gets deleted
+    lru_node *_find_alive(const std::string &key, std::size_t hash, uint32_t now);
+
+    void _put_absent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                     uint32_t deadline);
+    void _set_existing(lru_node &node, const std::string &value, uint32_t flags, uint32_t deadline);
+    void _expire_at(lru_node &node, uint32_t deadline);
+
+    // Update keeps flags and expiration time of the node
+    UpdateResult _increment(const std::string &key, std::size_t hash, uint64_t delta, bool decrement, uint64_t &value,
+                            uint64_t *stored_cas);
+    void _delete(lru_node &node);
+
+    // Node alive for the reader holding shared lock, it gets referenced
+    lru_node *_find_shared(const std::string &key, std::size_t hash);
+
+    // Makes room for extra bytes evicting oldest nodes which were not referenced
+    void _evict(std::size_t need);
+
+    inline void _unlink(lru_node &node) {
+        node.prev->next = node.next;
+        node.next->prev = node.prev;
+    }
+
+    inline void _link_fresh(lru_node &node) {
+        node.next = &_lru_head;
+        node.prev = _lru_head.prev;
+        _lru_head.prev->next = &node;
+        _lru_head.prev = &node;
+    }
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SHARED_LOCK_LRU_H
@@ -1,115 +1,354 @@
 #include "SimpleLRU.h"
 
+#include "Counter.h"
+
 namespace Afina {
 namespace Backend {
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Put(const std::string &key, const std::string &value) {
+bool SimpleLRU::Put(const std::string &key, const std::string &value) { return Put(key, key_hash(key), value); }
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return PutIfAbsent(key, key_hash(key), value);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Set(const std::string &key, const std::string &value) { return Set(key, key_hash(key), value); }
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Delete(const std::string &key) { return Delete(key, key_hash(key)); }
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Get(const std::string &key, std::string &value) { return Get(key, key_hash(key), value); }
+
+// See SimpleLRU.h
+bool SimpleLRU::Put(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                    uint64_t *stored_cas) {
+    return Put(key, key_hash(key), value, flags, ttl, stored_cas);
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                            uint64_t *stored_cas) {
+    return PutIfAbsent(key, key_hash(key), value, flags, ttl, stored_cas);
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Set(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                    uint64_t *stored_cas) {
+    return Set(key, key_hash(key), value, flags, ttl, stored_cas);
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Get(const std::string &key, const ItemReader &reader) { return Get(key, key_hash(key), reader); }
+
+// See SimpleLRU.h
+bool SimpleLRU::Get(const std::string &key, ItemView &view) { return Get(key, key_hash(key), view); }
+
+// See SimpleLRU.h
+bool SimpleLRU::Touch(const std::string &key, int32_t ttl) { return Touch(key, key_hash(key), ttl); }
+
+// See SimpleLRU.h
+bool SimpleLRU::Append(const std::string &key, const std::string &data, uint64_t *stored_cas) {
+    return Append(key, key_hash(key), data, stored_cas);
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Prepend(const std::string &key, const std::string &data, uint64_t *stored_cas) {
+    return Prepend(key, key_hash(key), data, stored_cas);
+}
+
+// See SimpleLRU.h
+Storage::UpdateResult SimpleLRU::Increment(const std::string &key, uint64_t delta, uint64_t &value,
+                                           uint64_t *stored_cas) {
+    return Increment(key, key_hash(key), delta, value, stored_cas);
+}
+
+// See SimpleLRU.h
+Storage::UpdateResult SimpleLRU::Decrement(const std::string &key, uint64_t delta, uint64_t &value,
+                                           uint64_t *stored_cas) {
+    return Decrement(key, key_hash(key), delta, value, stored_cas);
+}
+
+// See SimpleLRU.h
+Storage::UpdateResult SimpleLRU::CompareAndSwap(const std::string &key, const std::string &value, uint32_t flags,
+                                                int32_t ttl, uint64_t cas, uint64_t *stored_cas) {
+    return CompareAndSwap(key, key_hash(key), value, flags, ttl, cas, stored_cas);
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Put(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags, int32_t ttl,
+                    uint64_t *stored_cas) {
     if (key.size() + value.size() > _max_size) {
         return false;
     }
-    auto in_cache = _lru_index.find(key);
-    if (in_cache == _lru_index.end()) {
-        _put_absent(key, value);
-        return true;
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    lru_node *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        _put_absent(key, hash, value, flags, TimingWheel::deadline(now, ttl));
     } else {
-        lru_node &node = in_cache->second.get();
-        _set_existing(node, value);
-        return true;
+        _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
     }
+    return report_cas(stored_cas, _cas, true);
 }
 
-// See MapBasedGlobalLockImpl.h
-bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+// See SimpleLRU.h
+bool SimpleLRU::PutIfAbsent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                            int32_t ttl, uint64_t *stored_cas) {
     if (key.size() + value.size() > _max_size) {
         return false;
     }
-    auto in_cache = _lru_index.find(key);
-    if (in_cache == _lru_index.end()) {
-        _put_absent(key, value);
-        return true;
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    if (_find_alive(key, hash, now) == nullptr) {
+        _put_absent(key, hash, value, flags, TimingWheel::deadline(now, ttl));
+        return report_cas(stored_cas, _cas, true);
     }
     return false;
 }
 
-// See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Set(const std::string &key, const std::string &value) {
+// See SimpleLRU.h
+bool SimpleLRU::Set(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags, int32_t ttl,
+                    uint64_t *stored_cas) {
     if (key.size() + value.size() > _max_size) {
         return false;
     }
-    auto in_cache = _lru_index.find(key);
-    if (in_cache != _lru_index.end()) {
-        lru_node &node = in_cache->second.get();
-        _set_existing(node, value);
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    lru_node *in_cache = _find_alive(key, hash, now);
+    if (in_cache != nullptr) {
+        _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
+        return report_cas(stored_cas, _cas, true);
+    }
+    return false;
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Delete(const std::string &key, std::size_t hash) {
+    lru_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        _delete(*in_cache);
+        return true;
+    }
+    return false;
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Get(const std::string &key, std::size_t hash, std::string &value) {
+    lru_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        value = *in_cache->value;
+        _touch(*in_cache);
         return true;
     }
     return false;
 }
 
-// See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Delete(const std::string &key) {
-    auto in_cache = _lru_index.find(key);
-    if (in_cache != _lru_index.end()) {
-        lru_node &node = in_cache->second.get();
-        _cache_size -= node.key.size() + node.value.size();
-        _lru_index.erase(key);
-        std::swap(node.prev, node.next->prev);
-        std::swap(node.next, node.next->prev->next);
-        node.next.reset();
+// See SimpleLRU.h
+bool SimpleLRU::Get(const std::string &key, std::size_t hash, const ItemReader &reader) {
+    lru_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        reader(ItemHeader{in_cache->flags, in_cache->cas, in_cache->value->size()}, in_cache->value->data());
+        _touch(*in_cache);
         return true;
     }
     return false;
 }
 
-// See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Get(const std::string &key, std::string &value) {
-    auto in_cache = _lru_index.find(key);
-    if (in_cache != _lru_index.end()) {
-        value = in_cache->second.get().value;
-        lru_node &node = in_cache->second.get();
-        std::swap(node.prev, node.next->prev);
-        std::swap(node.next, node.next->prev->next);
-        std::swap(node.prev, _lru_head->next->prev);
-        std::swap(node.next, _lru_head->next);
+// See SimpleLRU.h
+bool SimpleLRU::Get(const std::string &key, std::size_t hash, ItemView &view) {
+    lru_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        view.header = ItemHeader{in_cache->flags, in_cache->cas, in_cache->value->size()};
+        view.value = std::shared_ptr<const char>(in_cache->value, in_cache->value->data());
+        _touch(*in_cache);
         return true;
     }
     return false;
 }
 
-void SimpleLRU::_put_absent(const std::string &key, const std::string &value) {
+// See SimpleLRU.h
+bool SimpleLRU::Touch(const std::string &key, std::size_t hash, int32_t ttl) {
+    uint32_t now = _clock();
+    lru_node *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        return false;
+    }
+    uint32_t deadline = TimingWheel::deadline(now, ttl);
+    if (deadline != 0) {
+        _wheel.schedule(*in_cache, deadline);
+    } else {
+        _wheel.cancel(*in_cache);
+    }
+    _touch(*in_cache);
+    return true;
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Append(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas) {
+    lru_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr || !_resize(*in_cache, in_cache->value->size() + data.size())) {
+        return false;
+    }
+    _writable(*in_cache, true).append(data);
+    in_cache->cas = ++_cas;
+    return report_cas(stored_cas, in_cache->cas, true);
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Prepend(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas) {
+    lru_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr || !_resize(*in_cache, in_cache->value->size() + data.size())) {
+        return false;
+    }
+    _writable(*in_cache, true).insert(0, data);
+    in_cache->cas = ++_cas;
+    return report_cas(stored_cas, in_cache->cas, true);
+}
+
+// See SimpleLRU.h
+Storage::UpdateResult SimpleLRU::Increment(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                                           uint64_t *stored_cas) {
+    return _increment(key, hash, delta, false, value, stored_cas);
+}
+
+// See SimpleLRU.h
+Storage::UpdateResult SimpleLRU::Decrement(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                                           uint64_t *stored_cas) {
+    return _increment(key, hash, delta, true, value, stored_cas);
+}
+
+// See SimpleLRU.h
+Storage::UpdateResult SimpleLRU::CompareAndSwap(const std::string &key, std::size_t hash, const std::string &value,
+                                                uint32_t flags, int32_t ttl, uint64_t cas, uint64_t *stored_cas) {
+    // Value that could never fit is not stored, same as by Set
+    if (key.size() + value.size() > _max_size) {
+        return UpdateResult::NotFound;
+    }
+    uint32_t now = _clock();
+    lru_node *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        return UpdateResult::NotFound;
+    }
+    if (in_cache->cas != cas) {
+        return UpdateResult::Exists;
+    }
+    _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
+    return report_cas(stored_cas, in_cache->cas, UpdateResult::Stored);
+}
+
+// See SimpleLRU.h
+std::size_t SimpleLRU::ReapExpired(std::size_t budget) { return _reap(_clock(), budget); }
+
+std::size_t SimpleLRU::_reap(uint32_t now, std::size_t budget) {
+    return _wheel.advance(now, budget, [this](TimingWheel::timer &t) { _delete(static_cast<lru_node &>(t)); });
+}
+
+SimpleLRU::lru_node *SimpleLRU::_find_alive(const std::string &key, std::size_t hash, uint32_t now) {
+    lru_node *in_cache = _lru_index.find(hash, key);
+    if (in_cache != nullptr && TimingWheel::expired(*in_cache, now)) {
+        _delete(*in_cache);
+        return nullptr;
+    }
+    return in_cache;
+}
+
+void SimpleLRU::_put_absent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                            uint32_t deadline) {
     while (_max_size - _cache_size < key.size() + value.size()) {
         _delete_least_recent();
     }
     _cache_size += key.size() + value.size();
-    auto node = new lru_node{key, value, nullptr, nullptr};
+    auto node = new lru_node(key, hash, value);
+    node->flags = flags;
+    node->cas = ++_cas;
     node->prev = node;
     node->next.reset(node);
     std::swap(node->prev, _lru_head->next->prev);
     std::swap(node->next, _lru_head->next);
-    _lru_index.emplace(std::reference_wrapper<const std::string>(node->key), std::reference_wrapper<lru_node>(*node));
+    _lru_index.insert(hash, node);
+    if (deadline != 0) {
+        _wheel.schedule(*node, deadline);
+    }
 }
-void SimpleLRU::_set_existing(SimpleLRU::lru_node &node, const std::string &value) {
+
+void SimpleLRU::_set_existing(SimpleLRU::lru_node &node, const std::string &value, uint32_t flags,
+                              uint32_t deadline) {
+    _resize(node, value.size());
+    _writable(node, false).assign(value);
+    node.flags = flags;
+    node.cas = ++_cas;
+    if (deadline != 0) {
+        _wheel.schedule(node, deadline);
+    } else {
+        _wheel.cancel(node);
+    }
+}
+
+bool SimpleLRU::_resize(lru_node &node, std::size_t size) {
+    if (node.key.size() + size > _max_size) {
+        return false;
+    }
+
+    // Node goes to the fresh end first, so it is evicted last and only if it is the only one
+    _touch(node);
+    _cache_size = _cache_size - node.value->size() + size;
+    while (_cache_size > _max_size) {
+        _delete_least_recent();
+    }
+    return true;
+}
+
+std::string &SimpleLRU::_writable(lru_node &node, bool keep) {
+    // Nobody else could get a view while storage is busy with the update, so if the node is the only
+    // owner of the value now, it stays the only one
+    if (node.value.use_count() != 1) {
+        node.value = keep ? std::make_shared<std::string>(*node.value) : std::make_shared<std::string>();
+    }
+    return *node.value;
+}
+
+Storage::UpdateResult SimpleLRU::_increment(const std::string &key, std::size_t hash, uint64_t delta, bool decrement,
+                                            uint64_t &value, uint64_t *stored_cas) {
+    lru_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr) {
+        return UpdateResult::NotFound;
+    }
+    uint64_t number;
+    if (!Counter::parse(in_cache->value->data(), in_cache->value->size(), number)) {
+        return UpdateResult::NotNumber;
+    }
+    value = Counter::apply(number, delta, decrement);
+
+    char buf[Counter::max_size];
+    std::size_t size = Counter::format(value, buf);
+    if (!_resize(*in_cache, size)) {
+        return UpdateResult::NotFound;
+    }
+    _writable(*in_cache, false).assign(buf, size);
+    in_cache->cas = ++_cas;
+    return report_cas(stored_cas, in_cache->cas, UpdateResult::Stored);
+}
+
+void SimpleLRU::_touch(lru_node &node) {
     std::swap(node.prev, node.next->prev);
     std::swap(node.next, node.next->prev->next);
     std::swap(node.prev, _lru_head->next->prev);
     std::swap(node.next, _lru_head->next);
-    _cache_size -= node.value.size();
-    node.value = "";
-    while (_max_size - _cache_size < value.size()) {
-        _delete_least_recent();
-    }
-    _cache_size += value.size();
-    node.value = value;
 }
 
-void SimpleLRU::_delete_least_recent() {
-    auto node = _lru_head->prev;
-    std::swap(node->prev, node->next->prev);
-    std::swap(node->next, node->next->prev->next);
-    _cache_size -= node->key.size() + node->value.size();
-    _lru_index.erase(node->key);
-    node->next.reset();
+void SimpleLRU::_delete(lru_node &node) {
+    _lru_index.erase(node.hash, &node);
+    _wheel.cancel(node);
+    _cache_size -= node.key.size() + node.value->size();
+    std::swap(node.prev, node.next->prev);
+    std::swap(node.next, node.next->prev->next);
+    node.next.reset();
 }
 
+void SimpleLRU::_delete_least_recent() { _delete(*_lru_head->prev); }
+
 } // namespace Backend
 } // namespace Afina
@@ -1,24 +1,30 @@
 #ifndef AFINA_STORAGE_SIMPLE_LRU_H
 #define AFINA_STORAGE_SIMPLE_LRU_H
 
-#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 
 #include <afina/Storage.h>
 
+#include "Hash.h"
+#include "HashIndex.h"
+#include "TimingWheel.h"
+
 namespace Afina {
 namespace Backend {
 
 /**
- * # Map based implementation
+ * # Hash index based implementation
+ * Expired items are hidden from all operations right away and removed from memory by the timing
+ * wheel in small portions on each update or by ReapExpired
+ *
  * That is NOT thread safe implementaiton!!
  */
 class SimpleLRU : public Afina::Storage {
 public:
     SimpleLRU(size_t max_size = 1024) : _max_size(max_size) {
-        _lru_head = new lru_node{"", "", nullptr, nullptr};
+        _lru_head = new lru_node("", 0, "");
         _lru_head->prev = _lru_head;
         _lru_head->next.reset(_lru_head);
     }
@@ -51,15 +57,101 @@ public:
     // Implements Afina::Storage interface
     bool Get(const std::string &key, std::string &value) override;
 
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, const ItemReader &reader) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, ItemView &view) override;
+
+    // Implements Afina::Storage interface
+    bool Touch(const std::string &key, int32_t ttl) override;
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface
+    UpdateResult Increment(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface
+    UpdateResult Decrement(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override;
+
+    // Implements Afina::Storage interface
+    UpdateResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                                uint64_t cas, uint64_t *stored_cas = nullptr) override;
+
+    // Same operations for the key which hash is already known, see key_hash
+    bool Put(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr);
+    bool PutIfAbsent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0,
+                     int32_t ttl = 0, uint64_t *stored_cas = nullptr);
+    bool Set(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr);
+    bool Delete(const std::string &key, std::size_t hash);
+    bool Get(const std::string &key, std::size_t hash, std::string &value);
+    bool Get(const std::string &key, std::size_t hash, const ItemReader &reader);
+    bool Get(const std::string &key, std::size_t hash, ItemView &view);
+    bool Touch(const std::string &key, std::size_t hash, int32_t ttl);
+    bool Append(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr);
+    bool Prepend(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr);
+    UpdateResult Increment(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr);
+    UpdateResult Decrement(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr);
+    UpdateResult CompareAndSwap(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                                int32_t ttl, uint64_t cas, uint64_t *stored_cas = nullptr);
+
+    /**
+     * Removes up to budget expired items from memory, returns number of removed ones
+     */
+    std::size_t ReapExpired(std::size_t budget);
+
+    /**
+     * Replaces source of time for expiration, storage must be empty
+     */
+    void SetClock(uint32_t (*clock)()) {
+        _clock = clock;
+        _wheel.reset(_clock());
+    }
+
 private:
-    // LRU cache node
-    using lru_node = struct lru_node {
+    // LRU cache node, its timer is scheduled if node has expiration time. Value is shared with the views
+    // of the item, update changes it in place only if there are no views, see _writable
+    using lru_node = struct lru_node : public TimingWheel::timer {
+        lru_node(const std::string &k, std::size_t h, const std::string &v)
+            : key(k), value(std::make_shared<std::string>(v)), hash(h), flags(0), cas(0), prev(nullptr),
+              next(nullptr) {}
+
         const std::string key;
-        std::string value;
+        std::shared_ptr<std::string> value;
+        const std::size_t hash;
+        uint32_t flags;
+        uint64_t cas;
         lru_node *prev;
         std::unique_ptr<lru_node> next;
     };
 
+    // Compares key owned by the node with the one requested
+    struct lru_key_equal {
+        bool operator()(const lru_node &node, const std::string &key) const { return node.key == key; }
+    };
+
     // Maximum number of bytes could be stored in this cache.
     // i.e all (keys+values) must be less the _max_size
     std::size_t _max_size;
@@ -74,12 +166,42 @@ private:
     size_t _cache_size = 0;
 
     // Index of nodes from list above, allows fast random access to elements by lru_node#key
-    std::map<std::reference_wrapper<const std::string>, std::reference_wrapper<lru_node>, std::less<std::string>>
-        _lru_index;
+    HashIndex<lru_node, lru_key_equal> _lru_index;
+
+    // Version assigned to the last updated node
+    uint64_t _cas = 0;
+
+    // Expiration times of nodes
+    TimingWheel _wheel;
+    uint32_t (*_clock)() = &TimingWheel::clock;
+
+    // Number of expired items each update removes on the way
+    static const std::size_t _reap_batch = 16;
+
+    std::size_t _reap(uint32_t now, std::size_t budget);
+
+    // Returns node for the key unless it is absent or expired, expired one gets deleted
+    lru_node *_find_alive(const std::string &key, std::size_t hash, uint32_t now);
+
+    void _put_absent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                     uint32_t deadline);
+
+    void _set_existing(lru_node &node, const std::string &value, uint32_t flags, uint32_t deadline);
+
+    // Accounts new size of the node value evicting others if needed, false if it could never fit
+    bool _resize(lru_node &node, std::size_t size);
+
+    // Value of the node that could be changed in place, the one pinned by views is replaced by a copy
+    // of it if keep is set or by an empty string otherwise
+    std::string &_writable(lru_node &node, bool keep);
+
+    UpdateResult _increment(const std::string &key, std::size_t hash, uint64_t delta, bool decrement, uint64_t &value,
+                            uint64_t *stored_cas);
 
-    void _put_absent(const std::string &key, const std::string &value);
+    // Moves node to the fresh end of the list
+    void _touch(lru_node &node);
 
-    void _set_existing(lru_node &node, const std::string &value);
+    void _delete(lru_node &node);
 
     void _delete_least_recent();
 };
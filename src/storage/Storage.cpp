@@ -0,0 +1,91 @@
+#include <afina/Storage.h>
+
+#include "Counter.h"
+
+namespace Afina {
+
+namespace {
+
+// Copies value and flags of the item out
+bool read(Storage &storage, const std::string &key, std::string &value, uint32_t &flags) {
+    return storage.Get(key, Storage::ItemReader([&value, &flags](const ItemHeader &header, const char *data) {
+        value.assign(data, header.size);
+        flags = header.flags;
+    }));
+}
+
+// Emulates atomic update by copying value out and putting it back
+Storage::UpdateResult increment(Storage &storage, const std::string &key, uint64_t delta, bool decrement,
+                                uint64_t &value, uint64_t *stored_cas) {
+    std::string current;
+    uint32_t flags;
+    if (!read(storage, key, current, flags)) {
+        return Storage::UpdateResult::NotFound;
+    }
+    uint64_t number;
+    if (!Backend::Counter::parse(current.data(), current.size(), number)) {
+        return Storage::UpdateResult::NotNumber;
+    }
+    value = Backend::Counter::apply(number, delta, decrement);
+    if (!storage.Set(key, Backend::Counter::format(value), flags, 0, stored_cas)) {
+        return Storage::UpdateResult::NotFound;
+    }
+    return Storage::UpdateResult::Stored;
+}
+
+} // namespace
+
+// See Storage.h
+bool Storage::Touch(const std::string &key, int32_t ttl) {
+    return Get(key, ItemReader([](const ItemHeader &, const char *) {}));
+}
+
+// See Storage.h
+bool Storage::Append(const std::string &key, const std::string &data, uint64_t *stored_cas) {
+    std::string value;
+    uint32_t flags;
+    if (!read(*this, key, value, flags)) {
+        return false;
+    }
+    return Set(key, value + data, flags, 0, stored_cas);
+}
+
+// See Storage.h
+bool Storage::Prepend(const std::string &key, const std::string &data, uint64_t *stored_cas) {
+    std::string value;
+    uint32_t flags;
+    if (!read(*this, key, value, flags)) {
+        return false;
+    }
+    return Set(key, data + value, flags, 0, stored_cas);
+}
+
+// See Storage.h
+Storage::UpdateResult Storage::Increment(const std::string &key, uint64_t delta, uint64_t &value,
+                                         uint64_t *stored_cas) {
+    return increment(*this, key, delta, false, value, stored_cas);
+}
+
+// See Storage.h
+Storage::UpdateResult Storage::Decrement(const std::string &key, uint64_t delta, uint64_t &value,
+                                         uint64_t *stored_cas) {
+    return increment(*this, key, delta, true, value, stored_cas);
+}
+
+// See Storage.h
+Storage::UpdateResult Storage::CompareAndSwap(const std::string &key, const std::string &value, uint32_t flags,
+                                              int32_t ttl, uint64_t cas, uint64_t *stored_cas) {
+    uint64_t current = 0;
+    if (!Get(key, ItemReader([&current](const ItemHeader &header, const char *) { current = header.cas; }))) {
+        return UpdateResult::NotFound;
+    }
+    if (current != cas) {
+        return UpdateResult::Exists;
+    }
+    if (!Set(key, value, flags, ttl, stored_cas)) {
+        return UpdateResult::NotFound;
+    }
+    return UpdateResult::Stored;
+}
+
+} // namespace Afina
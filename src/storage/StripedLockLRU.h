@@ -1,59 +1,233 @@
 #ifndef AFINA_STORAGE_STRIPED_LRU_H
 #define AFINA_STORAGE_STRIPED_LRU_H
 
-#include <map>
+#include <algorithm>
+#include <cstdint>
 #include <memory>
-#include <mutex>
+#include <new>
+#include <stdexcept>
 #include <string>
+#include <thread>
 
+#include "Hash.h"
+#include "Reaper.h"
+#include "SharedLockLRU.h"
+#include "ThreadSafeCompactLRU.h"
 #include "ThreadSafeSimpleLRU.h"
 
 namespace Afina {
 namespace Backend {
 
-class StripedLockLRU : public Afina::Storage {
+/**
+ * # Storage split into independent shards
+ * Each key belongs to exactly one shard, Shard is a thread safe storage guarding itself.
+ *
+ * Key hash is computed once per request: its high bits select the shard and the whole value is
+ * passed down to the shard's index. Shards are placed on separate cache lines, so that locks of
+ * neighbour shards don't false-share.
+ *
+ * Shard has to provide every operation for the key which hash is known, so that each command is
+ * executed by the shard under its own lock. There is no fallback to the emulation of Afina::Storage,
+ * shard missing one of them doesn't compile.
+ *
+ * Expiration is up to the shards, they are reaped by ReapExpired(Shard::reap_batch) from one
+ * background thread shared by all shards, see Start
+ */
+template <typename Shard> class StripedLock : public Afina::Storage {
 public:
-    explicit StripedLockLRU(size_t max_size = 1024) : _max_size(max_size) {
+    /**
+     * @param max_size total size of all shards
+     * @param num_shards number of shards, must be power of two and leave each shard at least
+     * min_shard_size bytes, otherwise std::invalid_argument is thrown. By default 4 shards per core,
+     * as many of them as the size allows
+     */
+    explicit StripedLock(size_t max_size = 1024, size_t num_shards = 0)
+        : _max_size(max_size), _reaper([this]() { _reap(); }) {
+        if (num_shards == 0) {
+            size_t wanted = 4 * std::max(1u, std::thread::hardware_concurrency());
+            num_shards = 1;
+            while (num_shards < wanted && _max_size / (2 * num_shards) >= min_shard_size) {
+                num_shards *= 2;
+            }
+        } else if ((num_shards & (num_shards - 1)) != 0) {
+            throw std::invalid_argument("Number of shards must be power of two: " + std::to_string(num_shards));
+        } else if (_max_size / num_shards < min_shard_size) {
+            throw std::invalid_argument("Shards would be smaller than " + std::to_string(min_shard_size) +
+                                        " bytes: " + std::to_string(num_shards));
+        }
+        _num_shards = num_shards;
+        _shard_mask = _num_shards - 1;
+
+        // operator new doesn't respect over-aligned types before c++17
+        _raw.reset(new char[_num_shards * sizeof(padded_shard) + cache_line]);
+        uintptr_t addr = reinterpret_cast<uintptr_t>(_raw.get());
+        _shards = reinterpret_cast<padded_shard *>((addr + cache_line - 1) & ~uintptr_t(cache_line - 1));
+
         size_t shard_size = _max_size / _num_shards;
         for (size_t i = 0; i < _num_shards; ++i) {
-            _shards.emplace_back(new ThreadSafeSimplLRU(shard_size));
+            new (&_shards[i]) padded_shard(shard_size);
         }
     }
 
-    ~StripedLockLRU() override = default;
+    ~StripedLock() override {
+        _reaper.Stop();
+        for (size_t i = 0; i < _num_shards; ++i) {
+            _shards[i].~padded_shard();
+        }
+    }
 
     // Implements Afina::Storage interface
     bool Put(const std::string &key, const std::string &value) override {
-        return _shards[std::hash<std::string>{}(key) % _num_shards]->Put(key, value);
+        size_t hash = key_hash(key);
+        return _shard(hash).Put(key, hash, value);
+    }
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).PutIfAbsent(key, hash, value);
+    }
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).Set(key, hash, value);
+    }
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).Put(key, hash, value, flags, ttl, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas = nullptr) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).PutIfAbsent(key, hash, value, flags, ttl, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).Set(key, hash, value, flags, ttl, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).Delete(key, hash);
+    }
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).Get(key, hash, value);
+    }
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, const ItemReader &reader) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).Get(key, hash, reader);
+    }
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, ItemView &view) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).Get(key, hash, view);
+    }
+
+    // Implements Afina::Storage interface
+    bool Touch(const std::string &key, int32_t ttl) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).Touch(key, hash, ttl);
+    }
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).Append(key, hash, data, stored_cas);
     }
 
     // Implements Afina::Storage interface
-    bool PutIfAbsent(const std::string &key, const std::string &value) override{
-        return _shards[std::hash<std::string>{}(key) % _num_shards]->PutIfAbsent(key, value);
+    bool Prepend(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).Prepend(key, hash, data, stored_cas);
     }
 
     // Implements Afina::Storage interface
-    bool Set(const std::string &key, const std::string &value) override{
-        return _shards[std::hash<std::string>{}(key) % _num_shards]->Set(key, value);
+    UpdateResult Increment(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).Increment(key, hash, delta, value, stored_cas);
     }
 
     // Implements Afina::Storage interface
-    bool Delete(const std::string &key) override{
-        return _shards[std::hash<std::string>{}(key) % _num_shards]->Delete(key);
+    UpdateResult Decrement(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).Decrement(key, hash, delta, value, stored_cas);
     }
 
     // Implements Afina::Storage interface
-    bool Get(const std::string &key, std::string &value) override{
-        return _shards[std::hash<std::string>{}(key) % _num_shards]->Get(key, value);
+    UpdateResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                                uint64_t cas, uint64_t *stored_cas = nullptr) override {
+        size_t hash = key_hash(key);
+        return _shard(hash).CompareAndSwap(key, hash, value, flags, ttl, cas, stored_cas);
     }
 
+    // Implements Afina::Storage interface
+    void Start() override { _reaper.Start(); }
+
+    // Implements Afina::Storage interface
+    void Stop() override { _reaper.Stop(); }
+
+    // Number of shards storage consists of
+    inline size_t shards() const { return _num_shards; }
+
+    // Smallest shard storage could be split into
+    static const size_t min_shard_size = 256;
+
 private:
+    static const size_t cache_line = 64;
+
+    struct alignas(cache_line) padded_shard {
+        explicit padded_shard(size_t max_size) : shard(max_size) {}
+        Shard shard;
+    };
+
+    // Index uses low bits of the hash, so shard is selected by high ones
+    inline Shard &_shard(size_t hash) { return _shards[(uint64_t(hash) >> 32) & _shard_mask].shard; }
+
     std::size_t _max_size;
 
-    static const size_t _num_shards = 4;
-    std::vector<std::unique_ptr<ThreadSafeSimplLRU>> _shards;
+    std::size_t _num_shards;
+    std::size_t _shard_mask;
+    std::unique_ptr<char[]> _raw;
+    padded_shard *_shards;
+
+    Reaper _reaper;
+
+    void _reap() {
+        for (size_t i = 0; i < _num_shards; ++i) {
+            Shard &shard = _shards[i].shard;
+            while (shard.ReapExpired(Shard::reap_batch) == Shard::reap_batch) {
+            }
+        }
+    }
 };
 
+// Shards keep nodes in the global heap
+using StripedLockLRU = StripedLock<ThreadSafeSimplLRU>;
+
+// Shards keep items in the slab arenas, each shard has its own one
+using StripedCompactLRU = StripedLock<ThreadSafeCompactLRU>;
+
+// Shards serve reads under shared lock
+using StripedSharedLockLRU = StripedLock<SharedLockLRU>;
+
 } // namespace Backend
 } // namespace Afina
 
@@ -0,0 +1,205 @@
+#ifndef AFINA_STORAGE_THREAD_SAFE_COMPACT_LRU_H
+#define AFINA_STORAGE_THREAD_SAFE_COMPACT_LRU_H
+
+#include <mutex>
+#include <string>
+
+#include "CompactLRU.h"
+#include "Reaper.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # CompactLRU thread safe version
+ * Slab allocator is guarded by the same lock as the list, so each item allocation is already
+ * serialized with the rest of the update. Once started, background thread reaps expired items holding
+ * the lock for one batch at a time
+ */
+class ThreadSafeCompactLRU : public CompactLRU {
+public:
+    ThreadSafeCompactLRU(size_t max_size = 1 << 20)
+        : CompactLRU(max_size), _reaper([this]() { while (ReapExpired(reap_batch) == reap_batch) {} }) {}
+    ~ThreadSafeCompactLRU() { _reaper.Stop(); }
+
+    // Implements Afina::Storage interface
+    void Start() override { _reaper.Start(); }
+
+    // Implements Afina::Storage interface
+    void Stop() override { _reaper.Stop(); }
+
+    // see CompactLRU.h
+    bool Put(const std::string &key, const std::string &value) override { return Put(key, key_hash(key), value); }
+
+    // see CompactLRU.h
+    bool Put(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::Put(key, hash, value, flags, ttl, stored_cas);
+    }
+
+    // see CompactLRU.h
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        return Put(key, key_hash(key), value, flags, ttl, stored_cas);
+    }
+
+    // see CompactLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        return PutIfAbsent(key, key_hash(key), value);
+    }
+
+    // see CompactLRU.h
+    bool PutIfAbsent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0,
+                     int32_t ttl = 0, uint64_t *stored_cas = nullptr) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::PutIfAbsent(key, hash, value, flags, ttl, stored_cas);
+    }
+
+    // see CompactLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas = nullptr) override {
+        return PutIfAbsent(key, key_hash(key), value, flags, ttl, stored_cas);
+    }
+
+    // see CompactLRU.h
+    bool Set(const std::string &key, const std::string &value) override { return Set(key, key_hash(key), value); }
+
+    // see CompactLRU.h
+    bool Set(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::Set(key, hash, value, flags, ttl, stored_cas);
+    }
+
+    // see CompactLRU.h
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        return Set(key, key_hash(key), value, flags, ttl, stored_cas);
+    }
+
+    // see CompactLRU.h
+    bool Delete(const std::string &key) override { return Delete(key, key_hash(key)); }
+
+    // see CompactLRU.h
+    bool Delete(const std::string &key, std::size_t hash) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::Delete(key, hash);
+    }
+
+    // see CompactLRU.h
+    bool Get(const std::string &key, std::string &value) override { return Get(key, key_hash(key), value); }
+
+    // see CompactLRU.h
+    bool Get(const std::string &key, std::size_t hash, std::string &value) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::Get(key, hash, value);
+    }
+
+    // see CompactLRU.h
+    bool Get(const std::string &key, const ItemReader &reader) override { return Get(key, key_hash(key), reader); }
+
+    // see CompactLRU.h
+    bool Get(const std::string &key, std::size_t hash, const ItemReader &reader) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::Get(key, hash, reader);
+    }
+
+    // see CompactLRU.h
+    bool Get(const std::string &key, ItemView &view) override { return Get(key, key_hash(key), view); }
+
+    // see CompactLRU.h
+    bool Get(const std::string &key, std::size_t hash, ItemView &view) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::Get(key, hash, view);
+    }
+
+    // see CompactLRU.h
+    bool Touch(const std::string &key, int32_t ttl) override { return Touch(key, key_hash(key), ttl); }
+
+    // see CompactLRU.h
+    bool Touch(const std::string &key, std::size_t hash, int32_t ttl) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::Touch(key, hash, ttl);
+    }
+
+    // see CompactLRU.h
+    bool Append(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override {
+        return Append(key, key_hash(key), data, stored_cas);
+    }
+
+    // see CompactLRU.h
+    bool Append(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::Append(key, hash, data, stored_cas);
+    }
+
+    // see CompactLRU.h
+    bool Prepend(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override {
+        return Prepend(key, key_hash(key), data, stored_cas);
+    }
+
+    // see CompactLRU.h
+    bool Prepend(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::Prepend(key, hash, data, stored_cas);
+    }
+
+    // see CompactLRU.h
+    UpdateResult Increment(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override {
+        return Increment(key, key_hash(key), delta, value, stored_cas);
+    }
+
+    // see CompactLRU.h
+    UpdateResult Increment(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::Increment(key, hash, delta, value, stored_cas);
+    }
+
+    // see CompactLRU.h
+    UpdateResult Decrement(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override {
+        return Decrement(key, key_hash(key), delta, value, stored_cas);
+    }
+
+    // see CompactLRU.h
+    UpdateResult Decrement(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::Decrement(key, hash, delta, value, stored_cas);
+    }
+
+    // see CompactLRU.h
+    UpdateResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                                uint64_t cas, uint64_t *stored_cas = nullptr) override {
+        return CompareAndSwap(key, key_hash(key), value, flags, ttl, cas, stored_cas);
+    }
+
+    // see CompactLRU.h
+    UpdateResult CompareAndSwap(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                                int32_t ttl, uint64_t cas, uint64_t *stored_cas = nullptr) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::CompareAndSwap(key, hash, value, flags, ttl, cas, stored_cas);
+    }
+
+    // see CompactLRU.h
+    std::size_t ReapExpired(std::size_t budget) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return CompactLRU::ReapExpired(budget);
+    }
+
+    // Number of expired items background thread removes under the lock at once
+    static const std::size_t reap_batch = 256;
+
+private:
+    std::mutex storage_mutex;
+
+    Reaper _reaper;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_THREAD_SAFE_COMPACT_LRU_H
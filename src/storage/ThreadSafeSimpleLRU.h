@@ -5,6 +5,7 @@
 #include <mutex>
 #include <string>
 
+#include "Reaper.h"
 #include "SimpleLRU.h"
 
 namespace Afina {
@@ -12,52 +13,195 @@ namespace Backend {
 
 /**
  * # SimpleLRU thread safe version
- *
- *
+ * Once started, background thread reaps expired items holding the lock for one batch at a time
  */
 class ThreadSafeSimplLRU : public SimpleLRU {
 public:
-    ThreadSafeSimplLRU(size_t max_size = 1024) : SimpleLRU(max_size) {}
-    ~ThreadSafeSimplLRU() {}
+    ThreadSafeSimplLRU(size_t max_size = 1024)
+        : SimpleLRU(max_size), _reaper([this]() { while (ReapExpired(reap_batch) == reap_batch) {} }) {}
+    ~ThreadSafeSimplLRU() { _reaper.Stop(); }
+
+    // Implements Afina::Storage interface
+    void Start() override { _reaper.Start(); }
+
+    // Implements Afina::Storage interface
+    void Stop() override { _reaper.Stop(); }
+
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value) override { return Put(key, key_hash(key), value); }
 
     // see SimpleLRU.h
-    bool Put(const std::string &key, const std::string &value) override {
+    bool Put(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr) {
         // TODO: sinchronization
         std::lock_guard<std::mutex> guard(storage_mutex);
-        return SimpleLRU::Put(key, value);
+        return SimpleLRU::Put(key, hash, value, flags, ttl, stored_cas);
+    }
+
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        return Put(key, key_hash(key), value, flags, ttl, stored_cas);
     }
 
     // see SimpleLRU.h
     bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        return PutIfAbsent(key, key_hash(key), value);
+    }
+
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0,
+                     int32_t ttl = 0, uint64_t *stored_cas = nullptr) {
         // TODO: sinchronization
         std::lock_guard<std::mutex> guard(storage_mutex);
-        return SimpleLRU::PutIfAbsent(key, value);
+        return SimpleLRU::PutIfAbsent(key, hash, value, flags, ttl, stored_cas);
     }
 
     // see SimpleLRU.h
-    bool Set(const std::string &key, const std::string &value) override {
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas = nullptr) override {
+        return PutIfAbsent(key, key_hash(key), value, flags, ttl, stored_cas);
+    }
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value) override { return Set(key, key_hash(key), value); }
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr) {
         // TODO: sinchronization
         std::lock_guard<std::mutex> guard(storage_mutex);
-        return SimpleLRU::Set(key, value);
+        return SimpleLRU::Set(key, hash, value, flags, ttl, stored_cas);
+    }
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        return Set(key, key_hash(key), value, flags, ttl, stored_cas);
     }
 
     // see SimpleLRU.h
-    bool Delete(const std::string &key) override {
+    bool Delete(const std::string &key) override { return Delete(key, key_hash(key)); }
+
+    // see SimpleLRU.h
+    bool Delete(const std::string &key, std::size_t hash) {
         // TODO: sinchronization
         std::lock_guard<std::mutex> guard(storage_mutex);
-        return SimpleLRU::Delete(key);
+        return SimpleLRU::Delete(key, hash);
     }
 
     // see SimpleLRU.h
-    bool Get(const std::string &key, std::string &value) override {
+    bool Get(const std::string &key, std::string &value) override { return Get(key, key_hash(key), value); }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::size_t hash, std::string &value) {
         // TODO: sinchronization
         std::lock_guard<std::mutex> guard(storage_mutex);
-        return SimpleLRU::Get(key, value);
+        return SimpleLRU::Get(key, hash, value);
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, const ItemReader &reader) override { return Get(key, key_hash(key), reader); }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::size_t hash, const ItemReader &reader) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return SimpleLRU::Get(key, hash, reader);
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, ItemView &view) override { return Get(key, key_hash(key), view); }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::size_t hash, ItemView &view) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return SimpleLRU::Get(key, hash, view);
+    }
+
+    // see SimpleLRU.h
+    bool Touch(const std::string &key, int32_t ttl) override { return Touch(key, key_hash(key), ttl); }
+
+    // see SimpleLRU.h
+    bool Touch(const std::string &key, std::size_t hash, int32_t ttl) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return SimpleLRU::Touch(key, hash, ttl);
     }
 
+    // see SimpleLRU.h
+    bool Append(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override {
+        return Append(key, key_hash(key), data, stored_cas);
+    }
+
+    // see SimpleLRU.h
+    bool Append(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return SimpleLRU::Append(key, hash, data, stored_cas);
+    }
+
+    // see SimpleLRU.h
+    bool Prepend(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override {
+        return Prepend(key, key_hash(key), data, stored_cas);
+    }
+
+    // see SimpleLRU.h
+    bool Prepend(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return SimpleLRU::Prepend(key, hash, data, stored_cas);
+    }
+
+    // see SimpleLRU.h
+    UpdateResult Increment(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override {
+        return Increment(key, key_hash(key), delta, value, stored_cas);
+    }
+
+    // see SimpleLRU.h
+    UpdateResult Increment(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return SimpleLRU::Increment(key, hash, delta, value, stored_cas);
+    }
+
+    // see SimpleLRU.h
+    UpdateResult Decrement(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override {
+        return Decrement(key, key_hash(key), delta, value, stored_cas);
+    }
+
+    // see SimpleLRU.h
+    UpdateResult Decrement(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return SimpleLRU::Decrement(key, hash, delta, value, stored_cas);
+    }
+
+    // see SimpleLRU.h
+    UpdateResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                                uint64_t cas, uint64_t *stored_cas = nullptr) override {
+        return CompareAndSwap(key, key_hash(key), value, flags, ttl, cas, stored_cas);
+    }
+
+    // see SimpleLRU.h
+    UpdateResult CompareAndSwap(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                                int32_t ttl, uint64_t cas, uint64_t *stored_cas = nullptr) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return SimpleLRU::CompareAndSwap(key, hash, value, flags, ttl, cas, stored_cas);
+    }
+
+    // see SimpleLRU.h
+    std::size_t ReapExpired(std::size_t budget) {
+        std::lock_guard<std::mutex> guard(storage_mutex);
+        return SimpleLRU::ReapExpired(budget);
+    }
+
+    // Number of expired items background thread removes under the lock at once
+    static const std::size_t reap_batch = 256;
+
 private:
     // TODO: sinchronization primitives
     std::mutex storage_mutex;
+
+    Reaper _reaper;
 };
 
 } // namespace Backend
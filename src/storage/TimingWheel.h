@@ -0,0 +1,200 @@
+#ifndef AFINA_STORAGE_TIMING_WHEEL_H
+#define AFINA_STORAGE_TIMING_WHEEL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Hierarchical timing wheel
+ * Keeps timers sorted by deadline with O(1) schedule/cancel and without scanning all of them.
+ * There are 4 levels of 64 slots each: level 0 slot is one second, level 1 slot is 64 seconds and so
+ * on, so the wheel covers 2^24 seconds (~194 days), timers beyond that are parked in the last level.
+ * When time passes slot boundary of upper level, timers from that slot are spread over the levels
+ * below (cascade), so each timer is moved at most 4 times during its life.
+ *
+ * Timers are intrusive: storage embeds timer into its item, so wheel never allocates memory.
+ * Expired timers are collected into the due list and handed out by advance in batches of limited
+ * size, so expiring million items at once doesn't stall the caller.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class TimingWheel {
+public:
+    // Timer embedded into the item
+    struct timer {
+        timer *prev = nullptr;
+        timer *next = nullptr;
+
+        // Absolute deadline in seconds of clock(), 0 if timer is not scheduled
+        uint32_t deadline = 0;
+
+        inline bool scheduled() const { return prev != nullptr; }
+    };
+
+    /**
+     * Seconds of monotonic clock, never 0 so that 0 could mean "no deadline"
+     */
+    static uint32_t clock() {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return uint32_t(std::chrono::duration_cast<std::chrono::seconds>(now).count()) + 1;
+    }
+
+    /**
+     * Deadline of the item with the given time to live, see Afina::Storage
+     */
+    static inline uint32_t deadline(uint32_t now, int32_t ttl) {
+        return ttl == 0 ? 0 : (ttl < 0 ? now : now + uint32_t(ttl));
+    }
+
+    /**
+     * Timer has deadline and it has come
+     */
+    static inline bool expired(const timer &t, uint32_t now) {
+        return t.deadline != 0 && int32_t(t.deadline - now) <= 0;
+    }
+
+    explicit TimingWheel(uint32_t now = clock()) : _now(now) {
+        for (auto &level : _slots) {
+            for (auto &slot : level) {
+                _init(slot);
+            }
+        }
+        _init(_due);
+    }
+
+    TimingWheel(const TimingWheel &) = delete;
+    TimingWheel &operator=(const TimingWheel &) = delete;
+
+    // Current time of the wheel
+    inline uint32_t now() const { return _now; }
+
+    // Moves the wheel to the given time without expiring anything, wheel must be empty
+    inline void reset(uint32_t now) { _now = now; }
+
+    /**
+     * Places timer into the wheel, timer with deadline in the past becomes due immediately. Scheduled
+     * timer gets rescheduled
+     */
+    void schedule(timer &t, uint32_t deadline) {
+        cancel(t);
+        t.deadline = deadline;
+        _place(t);
+    }
+
+    // Removes timer from the wheel if it is there
+    void cancel(timer &t) {
+        if (t.scheduled()) {
+            _unlink(t);
+        }
+        t.deadline = 0;
+    }
+
+    /**
+     * Moves the wheel forward to now and calls fn(timer &) for up to budget due timers, each of them is
+     * removed from the wheel before the call. Returns number of calls made
+     */
+    template <typename F> std::size_t advance(uint32_t now, std::size_t budget, F fn) {
+        while (int32_t(now - _now) > 0) {
+            _tick();
+        }
+
+        std::size_t done = 0;
+        while (done < budget && _due.next != &_due) {
+            timer *t = _due.next;
+            _unlink(*t);
+            t->deadline = 0;
+            fn(*t);
+            done++;
+        }
+        return done;
+    }
+
+private:
+    static const unsigned levels = 4;
+    static const unsigned slot_bits = 6;
+    static const unsigned slots = 1 << slot_bits;
+
+    static inline void _init(timer &head) {
+        head.prev = &head;
+        head.next = &head;
+    }
+
+    static inline void _unlink(timer &t) {
+        t.prev->next = t.next;
+        t.next->prev = t.prev;
+        t.prev = t.next = nullptr;
+    }
+
+    static inline void _link(timer &head, timer &t) {
+        t.next = &head;
+        t.prev = head.prev;
+        head.prev->next = &t;
+        head.prev = &t;
+    }
+
+    void _place(timer &t) {
+        int32_t delta = int32_t(t.deadline - _now);
+        if (delta <= 0) {
+            _link(_due, t);
+            return;
+        }
+
+        for (unsigned level = 0; level < levels; level++) {
+            if (uint32_t(delta) < (1u << (slot_bits * (level + 1)))) {
+                _link(_slots[level][(t.deadline >> (slot_bits * level)) & (slots - 1)], t);
+                return;
+            }
+        }
+
+        // Too far, park it in the slot of the last level which is visited last
+        unsigned shift = slot_bits * (levels - 1);
+        _link(_slots[levels - 1][((_now >> shift) + slots - 1) & (slots - 1)], t);
+    }
+
+    void _tick() {
+        _now++;
+
+        // Upper levels are cascaded first, timers could land in the current slot of level 0
+        for (unsigned level = levels - 1; level > 0; level--) {
+            uint32_t mask = (1u << (slot_bits * level)) - 1;
+            if ((_now & mask) == 0) {
+                _cascade(_slots[level][(_now >> (slot_bits * level)) & (slots - 1)]);
+            }
+        }
+
+        timer &slot = _slots[0][_now & (slots - 1)];
+        while (slot.next != &slot) {
+            timer *t = slot.next;
+            _unlink(*t);
+            _link(_due, *t);
+        }
+    }
+
+    void _cascade(timer &slot) {
+        timer list;
+        _init(list);
+        while (slot.next != &slot) {
+            timer *t = slot.next;
+            _unlink(*t);
+            _link(list, *t);
+        }
+        while (list.next != &list) {
+            timer *t = list.next;
+            _unlink(*t);
+            _place(*t);
+        }
+    }
+
+    uint32_t _now;
+    timer _slots[levels][slots];
+    timer _due;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_TIMING_WHEEL_H
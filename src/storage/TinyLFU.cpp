@@ -0,0 +1,331 @@
+#include "TinyLFU.h"
+
+#include "Counter.h"
+
+namespace Afina {
+namespace Backend {
+
+// See TinyLFU.h
+TinyLFU::TinyLFU(size_t max_size)
+    : _max_size(max_size), _window_max(max_size / 100), _protected_max((max_size - max_size / 100) / 5 * 4),
+      _sketch(max_size / 64) {}
+
+// See TinyLFU.h
+TinyLFU::~TinyLFU() {
+    _index.clear();
+    for (lfu_queue &queue : _queues) {
+        while (!queue.empty()) {
+            lfu_node *node = queue.oldest();
+            _unlink(*node);
+            delete node;
+        }
+    }
+}
+
+// See TinyLFU.h
+bool TinyLFU::Put(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags, int32_t ttl,
+                  uint64_t *stored_cas) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    lfu_node *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        _put_absent(key, hash, value, flags, TimingWheel::deadline(now, ttl));
+    } else {
+        _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
+    }
+    return report_cas(stored_cas, _cas, true);
+}
+
+// See TinyLFU.h
+bool TinyLFU::PutIfAbsent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                          int32_t ttl, uint64_t *stored_cas) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    if (_find_alive(key, hash, now) == nullptr) {
+        _put_absent(key, hash, value, flags, TimingWheel::deadline(now, ttl));
+        return report_cas(stored_cas, _cas, true);
+    }
+    return false;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Set(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags, int32_t ttl,
+                  uint64_t *stored_cas) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = _clock();
+    _reap(now, _reap_batch);
+    lfu_node *in_cache = _find_alive(key, hash, now);
+    if (in_cache != nullptr) {
+        _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
+        return report_cas(stored_cas, _cas, true);
+    }
+    return false;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Delete(const std::string &key, std::size_t hash) {
+    lfu_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        _delete(*in_cache);
+        return true;
+    }
+    return false;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Get(const std::string &key, std::size_t hash, std::string &value) {
+    // Misses count as well: key requested again soon after the miss deserves admission
+    _sketch.increment(hash);
+    lfu_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        value = in_cache->value;
+        _touch(*in_cache);
+        return true;
+    }
+    return false;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Get(const std::string &key, std::size_t hash, const ItemReader &reader) {
+    _sketch.increment(hash);
+    lfu_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache != nullptr) {
+        reader(ItemHeader{in_cache->flags, in_cache->cas, in_cache->value.size()}, in_cache->value.data());
+        _touch(*in_cache);
+        return true;
+    }
+    return false;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Touch(const std::string &key, std::size_t hash, int32_t ttl) {
+    uint32_t now = _clock();
+    lfu_node *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        return false;
+    }
+    _expire_at(*in_cache, TimingWheel::deadline(now, ttl));
+    _touch(*in_cache);
+    return true;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Append(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas) {
+    lfu_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr || in_cache->key.size() + in_cache->value.size() + data.size() > _max_size) {
+        return false;
+    }
+    _set_existing(*in_cache, in_cache->value + data, in_cache->flags, in_cache->deadline);
+    return report_cas(stored_cas, _cas, true);
+}
+
+// See TinyLFU.h
+bool TinyLFU::Prepend(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas) {
+    lfu_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr || in_cache->key.size() + in_cache->value.size() + data.size() > _max_size) {
+        return false;
+    }
+    _set_existing(*in_cache, data + in_cache->value, in_cache->flags, in_cache->deadline);
+    return report_cas(stored_cas, _cas, true);
+}
+
+// See TinyLFU.h
+Storage::UpdateResult TinyLFU::Increment(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                                         uint64_t *stored_cas) {
+    return _increment(key, hash, delta, false, value, stored_cas);
+}
+
+// See TinyLFU.h
+Storage::UpdateResult TinyLFU::Decrement(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                                         uint64_t *stored_cas) {
+    return _increment(key, hash, delta, true, value, stored_cas);
+}
+
+// See TinyLFU.h
+Storage::UpdateResult TinyLFU::CompareAndSwap(const std::string &key, std::size_t hash, const std::string &value,
+                                              uint32_t flags, int32_t ttl, uint64_t cas, uint64_t *stored_cas) {
+    // Value that could never fit is not stored, same as by Set
+    if (key.size() + value.size() > _max_size) {
+        return UpdateResult::NotFound;
+    }
+    uint32_t now = _clock();
+    lfu_node *in_cache = _find_alive(key, hash, now);
+    if (in_cache == nullptr) {
+        return UpdateResult::NotFound;
+    }
+    if (in_cache->cas != cas) {
+        return UpdateResult::Exists;
+    }
+    _set_existing(*in_cache, value, flags, TimingWheel::deadline(now, ttl));
+    return report_cas(stored_cas, _cas, UpdateResult::Stored);
+}
+
+// See TinyLFU.h
+std::size_t TinyLFU::ReapExpired(std::size_t budget) { return _reap(_clock(), budget); }
+
+std::size_t TinyLFU::_reap(uint32_t now, std::size_t budget) {
+    return _wheel.advance(now, budget, [this](TimingWheel::timer &t) { _delete(static_cast<lfu_node &>(t)); });
+}
+
+TinyLFU::lfu_node *TinyLFU::_find_alive(const std::string &key, std::size_t hash, uint32_t now) {
+    lfu_node *in_cache = _index.find(hash, key);
+    if (in_cache != nullptr && TimingWheel::expired(*in_cache, now)) {
+        _delete(*in_cache);
+        return nullptr;
+    }
+    return in_cache;
+}
+
+Storage::UpdateResult TinyLFU::_increment(const std::string &key, std::size_t hash, uint64_t delta, bool decrement,
+                                          uint64_t &value, uint64_t *stored_cas) {
+    lfu_node *in_cache = _find_alive(key, hash, _clock());
+    if (in_cache == nullptr) {
+        return UpdateResult::NotFound;
+    }
+    uint64_t number;
+    if (!Counter::parse(in_cache->value.data(), in_cache->value.size(), number)) {
+        return UpdateResult::NotNumber;
+    }
+    value = Counter::apply(number, delta, decrement);
+
+    std::string formatted = Counter::format(value);
+    if (key.size() + formatted.size() > _max_size) {
+        return UpdateResult::NotFound;
+    }
+    _set_existing(*in_cache, formatted, in_cache->flags, in_cache->deadline);
+    return report_cas(stored_cas, _cas, UpdateResult::Stored);
+}
+
+void TinyLFU::_put_absent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                          uint32_t deadline) {
+    _sketch.increment(hash);
+    lfu_node *node = new lfu_node(key, hash, value);
+    node->flags = flags;
+    node->cas = ++_cas;
+    _index.insert(hash, node);
+    _link_fresh(*node, WINDOW);
+    _cache_size += node->size();
+    _expire_at(*node, deadline);
+
+    // Sketch follows the number of entries, so that counters don't get saturated by collisions. Collected
+    // frequencies are kept, otherwise admission would be random for a while after each growth
+    if (++_count > _sketch.width()) {
+        _sketch.grow(2 * _count);
+    }
+    _maintain();
+}
+
+void TinyLFU::_set_existing(lfu_node &node, const std::string &value, uint32_t flags, uint32_t deadline) {
+    _sketch.increment(node.hash);
+    _queues[node.queue].size -= node.value.size();
+    _cache_size -= node.value.size();
+    node.value = value;
+    node.flags = flags;
+    node.cas = ++_cas;
+    _queues[node.queue].size += node.value.size();
+    _cache_size += node.value.size();
+    _expire_at(node, deadline);
+    _touch(node);
+    _maintain();
+}
+
+void TinyLFU::_expire_at(lfu_node &node, uint32_t deadline) {
+    if (deadline != 0) {
+        _wheel.schedule(node, deadline);
+    } else {
+        _wheel.cancel(node);
+    }
+}
+
+void TinyLFU::_touch(lfu_node &node) {
+    queue_id queue = node.queue;
+    _unlink(node);
+    _link_fresh(node, queue == PROBATION ? PROTECTED : queue);
+
+    // Protected queue got too big, its oldest entries get one more chance on probation
+    while (_queues[PROTECTED].size > _protected_max) {
+        lfu_node *demoted = _queues[PROTECTED].oldest();
+        _unlink(*demoted);
+        _link_fresh(*demoted, PROBATION);
+    }
+}
+
+void TinyLFU::_maintain() {
+    while (_queues[WINDOW].size > _window_max) {
+        lfu_node *candidate = _queues[WINDOW].oldest();
+        _unlink(*candidate);
+        _link_fresh(*candidate, PROBATION);
+
+        // Admission: candidate has to be requested more often than each entry it displaces
+        while (_cache_size > _max_size) {
+            lfu_node *victim = _main_victim(candidate);
+            if (victim == nullptr) {
+                break;
+            }
+            if (_sketch.estimate(candidate->hash) > _sketch.estimate(victim->hash)) {
+                _delete(*victim);
+            } else {
+                _delete(*candidate);
+                break;
+            }
+        }
+    }
+
+    // Window is within its limit but main part is full
+    while (_cache_size > _max_size) {
+        lfu_node *victim = _main_victim(nullptr);
+        if (victim == nullptr) {
+            victim = _queues[WINDOW].oldest();
+        }
+        _delete(*victim);
+    }
+}
+
+TinyLFU::lfu_node *TinyLFU::_main_victim(lfu_node *skip) {
+    for (queue_id queue : {PROBATION, PROTECTED}) {
+        lfu_node *node = _queues[queue].oldest();
+        if (node == skip && node != nullptr) {
+            node = node->next != &_queues[queue].head ? node->next : nullptr;
+        }
+        if (node != nullptr) {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+void TinyLFU::_delete(lfu_node &node) {
+    _index.erase(node.hash, &node);
+    _wheel.cancel(node);
+    _unlink(node);
+    _cache_size -= node.size();
+    _count--;
+    delete &node;
+}
+
+void TinyLFU::_unlink(lfu_node &node) {
+    node.prev->next = node.next;
+    node.next->prev = node.prev;
+    _queues[node.queue].size -= node.size();
+}
+
+void TinyLFU::_link_fresh(lfu_node &node, queue_id queue) {
+    lfu_node &head = _queues[queue].head;
+    node.next = &head;
+    node.prev = head.prev;
+    head.prev->next = &node;
+    head.prev = &node;
+    node.queue = queue;
+    _queues[queue].size += node.size();
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,239 @@
+#ifndef AFINA_STORAGE_TINY_LFU_H
+#define AFINA_STORAGE_TINY_LFU_H
+
+#include <string>
+
+#include <afina/Storage.h>
+
+#include "FrequencySketch.h"
+#include "Hash.h"
+#include "HashIndex.h"
+#include "TimingWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # W-TinyLFU cache
+ * Cache is split into three LRU queues:
+ * - window: about 1% of the size, every new entry starts here
+ * - probation: entries that passed admission but were not requested since
+ * - protected: about 80% of the main part, entries requested while on probation
+ *
+ * Entry pushed out of the window becomes candidate for the main part. If there is no room, it has to
+ * beat the main part's victim (oldest on probation) in estimated frequency of recent requests, otherwise
+ * candidate is evicted instead. Frequencies come from the count-min sketch updated on every request, so
+ * one-hit keys of a large scan lose to the hot set and never displace it. Window lets new keys collect
+ * some history before they have to compete.
+ *
+ * Put succeeds even if the entry is rejected later by admission, same as it could be evicted by LRU.
+ * Size accounting and expiration are the same as in SimpleLRU.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class TinyLFU : public Afina::Storage {
+public:
+    TinyLFU(size_t max_size = 1024);
+    ~TinyLFU();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override { return Put(key, key_hash(key), value); }
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        return PutIfAbsent(key, key_hash(key), value);
+    }
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override { return Set(key, key_hash(key), value); }
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override { return Delete(key, key_hash(key)); }
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override { return Get(key, key_hash(key), value); }
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        return Put(key, key_hash(key), value, flags, ttl, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas = nullptr) override {
+        return PutIfAbsent(key, key_hash(key), value, flags, ttl, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        return Set(key, key_hash(key), value, flags, ttl, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, const ItemReader &reader) override { return Get(key, key_hash(key), reader); }
+
+    // Implements Afina::Storage interface
+    bool Touch(const std::string &key, int32_t ttl) override { return Touch(key, key_hash(key), ttl); }
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override {
+        return Append(key, key_hash(key), data, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data, uint64_t *stored_cas = nullptr) override {
+        return Prepend(key, key_hash(key), data, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    UpdateResult Increment(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override {
+        return Increment(key, key_hash(key), delta, value, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    UpdateResult Decrement(const std::string &key, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr) override {
+        return Decrement(key, key_hash(key), delta, value, stored_cas);
+    }
+
+    // Implements Afina::Storage interface
+    UpdateResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                                uint64_t cas, uint64_t *stored_cas = nullptr) override {
+        return CompareAndSwap(key, key_hash(key), value, flags, ttl, cas, stored_cas);
+    }
+
+    // Same operations for the key which hash is already known, see key_hash
+    bool Put(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr);
+    bool PutIfAbsent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0,
+                     int32_t ttl = 0, uint64_t *stored_cas = nullptr);
+    bool Set(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags = 0, int32_t ttl = 0,
+             uint64_t *stored_cas = nullptr);
+    bool Delete(const std::string &key, std::size_t hash);
+    bool Get(const std::string &key, std::size_t hash, std::string &value);
+    bool Get(const std::string &key, std::size_t hash, const ItemReader &reader);
+    bool Touch(const std::string &key, std::size_t hash, int32_t ttl);
+    bool Append(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr);
+    bool Prepend(const std::string &key, std::size_t hash, const std::string &data, uint64_t *stored_cas = nullptr);
+    UpdateResult Increment(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr);
+    UpdateResult Decrement(const std::string &key, std::size_t hash, uint64_t delta, uint64_t &value,
+                           uint64_t *stored_cas = nullptr);
+    UpdateResult CompareAndSwap(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                                int32_t ttl, uint64_t cas, uint64_t *stored_cas = nullptr);
+
+    /**
+     * Removes up to budget expired entries from memory, returns number of removed ones
+     */
+    std::size_t ReapExpired(std::size_t budget);
+
+    /**
+     * Replaces source of time for expiration, storage must be empty
+     */
+    void SetClock(uint32_t (*clock)()) {
+        _clock = clock;
+        _wheel.reset(_clock());
+    }
+
+private:
+    enum queue_id { WINDOW = 0, PROBATION = 1, PROTECTED = 2 };
+
+    // Timer of the node is scheduled if node has expiration time
+    struct lfu_node : public TimingWheel::timer {
+        lfu_node(const std::string &k, std::size_t h, const std::string &v)
+            : key(k), value(v), hash(h), flags(0), cas(0), prev(this), next(this), queue(WINDOW) {}
+
+        const std::string key;
+        std::string value;
+        const std::size_t hash;
+        uint32_t flags;
+        uint64_t cas;
+
+        // Neighbours in the queue, prev is older, next is fresher
+        lfu_node *prev;
+        lfu_node *next;
+
+        queue_id queue;
+
+        inline std::size_t size() const { return key.size() + value.size(); }
+    };
+
+    // Compares key owned by the node with the one requested
+    struct lfu_key_equal {
+        bool operator()(const lfu_node &node, const std::string &key) const { return node.key == key; }
+    };
+
+    // Queue is a circular list with sentinel, head.next is the oldest node and head.prev the freshest
+    struct lfu_queue {
+        lfu_queue() : head("", 0, "") {}
+        lfu_node head;
+        std::size_t size = 0;
+
+        inline bool empty() const { return head.next == &head; }
+        inline lfu_node *oldest() { return empty() ? nullptr : head.next; }
+    };
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be less the _max_size
+    std::size_t _max_size;
+    std::size_t _window_max;
+    std::size_t _protected_max;
+
+    // Current size of cache, sum over all queues
+    std::size_t _cache_size = 0;
+
+    // Number of entries in all queues
+    std::size_t _count = 0;
+
+    lfu_queue _queues[3];
+
+    HashIndex<lfu_node, lfu_key_equal> _index;
+
+    FrequencySketch _sketch;
+
+    // Version assigned to the last updated node
+    uint64_t _cas = 0;
+
+    // Expiration times of nodes
+    TimingWheel _wheel;
+    uint32_t (*_clock)() = &TimingWheel::clock;
+
+    // Number of expired items each update removes on the way
+    static const std::size_t _reap_batch = 16;
+
+    std::size_t _reap(uint32_t now, std::size_t budget);
+
+    // Returns node for the key unless it is absent or expired, expired one gets deleted
+    lfu_node *_find_alive(const std::string &key, std::size_t hash, uint32_t now);
+
+    // Both schedule expiration before admission runs, as it may evict the node right away
+    void _put_absent(const std::string &key, std::size_t hash, const std::string &value, uint32_t flags,
+                     uint32_t deadline);
+    void _set_existing(lfu_node &node, const std::string &value, uint32_t flags, uint32_t deadline);
+    void _expire_at(lfu_node &node, uint32_t deadline);
+
+    // Update keeps flags and expiration time of the node
+    UpdateResult _increment(const std::string &key, std::size_t hash, uint64_t delta, bool decrement, uint64_t &value,
+                            uint64_t *stored_cas);
+
+    // Marks node as requested: moves it to fresh end or promotes it from probation to protected
+    void _touch(lfu_node &node);
+
+    // Restores size limits of queues and the whole cache, running admission for window overflow
+    void _maintain();
+
+    // Oldest node of the main part other than skip, nullptr if there is none
+    lfu_node *_main_victim(lfu_node *skip);
+
+    void _delete(lfu_node &node);
+    void _unlink(lfu_node &node);
+    void _link_fresh(lfu_node &node, queue_id queue);
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_TINY_LFU_H
@@ -0,0 +1,73 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <afina/allocator/ConcurrentSlab.h>
+#include <afina/allocator/Slab.h>
+
+using namespace std;
+using namespace Afina::Allocator;
+static char cslab_buf[1 << 20];
+
+template <typename Alloc, typename Free> static double churn(size_t threads, size_t ops, Alloc alloc, Free free) {
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            mt19937 rnd(t);
+            vector<void *> live(128, nullptr);
+            for (size_t i = 0; i < ops; i++) {
+                void *&p = live[rnd() % live.size()];
+                if (p != nullptr) {
+                    free(p);
+                    p = nullptr;
+                } else {
+                    p = alloc(16 + rnd() % 200);
+                }
+            }
+            for (void *p : live) {
+                if (p != nullptr) {
+                    free(p);
+                }
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    return double(threads * ops) / ns * 1000;
+}
+
+// Throughput compared with single Slab behind a mutex
+TEST(ConcurrentSlabBenchmark, Throughput) {
+    const size_t ops = 200000;
+    size_t max_threads = max(4u, thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double locked, cached;
+        {
+            Slab slab(cslab_buf, sizeof(cslab_buf), 48, 1.25, 4096);
+            mutex lock;
+            locked = churn(threads, ops,
+                           [&](size_t n) {
+                               lock_guard<mutex> g(lock);
+                               return slab.alloc(n);
+                           },
+                           [&](void *p) {
+                               lock_guard<mutex> g(lock);
+                               slab.free(p);
+                           });
+        }
+        {
+            ConcurrentSlab slab(cslab_buf, sizeof(cslab_buf), 48, 1.25, 4096);
+            cached = churn(threads, ops, [&](size_t n) { return slab.alloc(n); }, [&](void *p) { slab.free(p); });
+        }
+        cerr << threads << " threads: locked Slab " << locked << " Mops/s, ConcurrentSlab " << cached << " Mops/s"
+             << endl;
+    }
+}
@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <afina/allocator/ConcurrentSlab.h>
+#include <afina/allocator/Error.h>
+
+using namespace std;
+using namespace Afina::Allocator;
+static char cslab_buf[1 << 20];
+
+TEST(ConcurrentSlabTest, AllocInRange) {
+    ConcurrentSlab a(cslab_buf, sizeof(cslab_buf), 48, 1.25, 4096, 8, 2);
+
+    for (size_t size : {1, 48, 49, 100, 1000, 4096}) {
+        char *v = static_cast<char *>(a.alloc(size));
+        EXPECT_GE(v, cslab_buf);
+        EXPECT_LE(v + size, cslab_buf + sizeof(cslab_buf));
+        EXPECT_GE(a.chunk_size(size), size);
+        a.free(v);
+    }
+    EXPECT_EQ(4096, a.max_alloc());
+    EXPECT_EQ(0, a.chunk_size(4097));
+}
+
+TEST(ConcurrentSlabTest, NoMemory) {
+    ConcurrentSlab a(cslab_buf, 16 * 4096, 48, 1.25, 4096, 8, 1);
+
+    vector<void *> ptrs;
+    try {
+        for (size_t i = 0; i <= 16; i++) {
+            ptrs.push_back(a.alloc(4096));
+        }
+        EXPECT_TRUE(false);
+    } catch (AllocError &e) {
+        EXPECT_EQ(e.getType(), AllocErrorType::NoMemory);
+    }
+    EXPECT_EQ(16, ptrs.size());
+
+    // Freed chunk is reused by the same class
+    a.free(ptrs.back());
+    EXPECT_EQ(ptrs.back(), a.try_alloc(4096));
+}
+
+TEST(ConcurrentSlabTest, InvalidFree) {
+    ConcurrentSlab a(cslab_buf, sizeof(cslab_buf), 48, 1.25, 4096, 8, 1);
+    char other;
+
+    try {
+        a.free(&other);
+        EXPECT_TRUE(false);
+    } catch (AllocError &e) {
+        EXPECT_EQ(e.getType(), AllocErrorType::InvalidFree);
+    }
+}
+
+// Threads allocate, fill and check chunks, and release them through other threads, so that
+// chunks travel across core caches and depots
+TEST(ConcurrentSlabTest, CrossThreadFree) {
+    ConcurrentSlab a(cslab_buf, sizeof(cslab_buf), 48, 1.25, 4096, 8, 4);
+
+    const size_t threads = 4, rounds = 50, per_round = 64;
+    vector<vector<char *>> handoff(threads);
+    vector<mutex> locks(threads);
+    vector<thread> workers;
+    bool ok = true;
+    mutex ok_lock;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            mt19937 rnd(t);
+            for (size_t r = 0; r < rounds; r++) {
+                vector<char *> mine;
+                for (size_t i = 0; i < per_round; i++) {
+                    size_t size = 16 + rnd() % 100;
+                    char *p = static_cast<char *>(a.alloc(size));
+                    memset(p, int(t), size);
+                    p[0] = char(size);
+                    mine.push_back(p);
+                }
+                for (char *p : mine) {
+                    size_t size = static_cast<unsigned char>(p[0]);
+                    for (size_t j = 1; j < size; j++) {
+                        if (p[j] != char(t)) {
+                            lock_guard<mutex> lock(ok_lock);
+                            ok = false;
+                        }
+                    }
+                }
+
+                // Give chunks to the neighbour, release ones got from the other side
+                {
+                    lock_guard<mutex> lock(locks[(t + 1) % threads]);
+                    auto &next = handoff[(t + 1) % threads];
+                    next.insert(next.end(), mine.begin(), mine.end());
+                }
+                vector<char *> got;
+                {
+                    lock_guard<mutex> lock(locks[t]);
+                    got.swap(handoff[t]);
+                }
+                for (char *p : got) {
+                    a.free(p);
+                }
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    for (auto &rest : handoff) {
+        for (char *p : rest) {
+            a.free(p);
+        }
+    }
+    EXPECT_TRUE(ok);
+}
@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Pointer.h>
+#include <afina/allocator/Simple.h>
+
+using namespace std;
+using namespace Afina::Allocator;
+static char buf[65536];
+
+static void writeTo(Pointer &p, size_t size) {
+    char *v = reinterpret_cast<char *>(p.get());
+
+    for (int i = 0; i < size; i++) {
+        v[i] = i % 31;
+    }
+}
+
+static bool isDataOk(Pointer &p, size_t size) {
+    char *v = reinterpret_cast<char *>(p.get());
+
+    for (int i = 0; i < size; i++) {
+        if (v[i] != i % 31) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Alloc/free throughput under random churn
+TEST(SimpleBenchmark, Throughput) {
+    Simple a(buf, sizeof(buf));
+
+    mt19937 rnd(0);
+    uniform_int_distribution<size_t> size_dist(16, 512);
+    vector<Pointer> live(64);
+
+    const size_t ops = 200000;
+    size_t defrags = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < ops; i++) {
+        Pointer &p = live[rnd() % live.size()];
+        if (p.get() != nullptr) {
+            a.free(p);
+            continue;
+        }
+
+        size_t size = size_dist(rnd);
+        try {
+            p = a.alloc(size);
+        } catch (AllocError &) {
+            a.defrag();
+            defrags++;
+            p = a.alloc(size);
+        }
+    }
+    auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+    for (Pointer &p : live) {
+        a.free(p);
+    }
+    cerr << "alloc/free: " << ns / ops << " ns/op, " << defrags << " defrags in " << ops << " ops" << endl;
+}
+
+// How much of free memory is usable as a single block before/after defrag
+TEST(SimpleBenchmark, Fragmentation) {
+    Simple a(buf, sizeof(buf));
+
+    mt19937 rnd(0);
+    uniform_int_distribution<size_t> size_dist(16, 256);
+    vector<Pointer> ptrs;
+    try {
+        for (;;) {
+            size_t size = size_dist(rnd);
+            ptrs.push_back(a.alloc(size));
+            writeTo(ptrs.back(), size);
+        }
+    } catch (AllocError &) {
+    }
+
+    // Heavy churn: every other block goes away
+    for (size_t i = 0; i < ptrs.size(); i += 2) {
+        a.free(ptrs[i]);
+    }
+
+    size_t largest = a.largest_free(), total = a.total_free();
+    EXPECT_LT(largest, total);
+    cerr << "before defrag: largest free block " << largest << " of " << total << " free bytes" << endl;
+
+    a.defrag();
+    largest = a.largest_free();
+    total = a.total_free();
+    EXPECT_EQ(largest, total);
+    cerr << "after defrag: largest free block " << largest << " of " << total << " free bytes" << endl;
+
+    Pointer big = a.alloc(largest);
+    writeTo(big, largest);
+    EXPECT_TRUE(isDataOk(big, largest));
+    a.free(big);
+    for (Pointer &p : ptrs) {
+        a.free(p);
+    }
+}
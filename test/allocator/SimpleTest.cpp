@@ -322,3 +322,48 @@ TEST(SimpleTest, ReallocGrow) {
     a.free(p);
     a.free(p2);
 }
+
+TEST(SimpleTest, FreeEmpty) {
+    Simple a(buf, sizeof(buf));
+
+    Pointer p;
+    a.free(p);
+    EXPECT_EQ(p.get(), nullptr);
+
+    Pointer p1 = a.alloc(100);
+    Pointer copy = p1;
+    a.free(p1);
+    EXPECT_EQ(copy.get(), nullptr);
+}
+
+TEST(SimpleTest, AllocHoleWithoutSlot) {
+    char small[1024];
+    Simple a(small, sizeof(small));
+
+    Pointer p1 = a.alloc(64);
+    Pointer p2 = a.alloc(64);
+    Pointer p3 = a.alloc(16);
+    a.free(p2);
+    Pointer p4 = a.alloc(8);
+
+    // Last block takes all the space up to the table
+    try {
+        for (size_t size = 16;; size += 8) {
+            a.realloc(p3, size);
+        }
+    } catch (AllocError &e) {
+        EXPECT_EQ(e.getType(), AllocErrorType::NoMemory);
+    }
+
+    // There is a hole, but no room for one more slot
+    try {
+        Pointer p5 = a.alloc(16);
+        EXPECT_TRUE(false);
+    } catch (AllocError &e) {
+        EXPECT_EQ(e.getType(), AllocErrorType::NoMemory);
+    }
+
+    a.free(p1);
+    Pointer p5 = a.alloc(16);
+    EXPECT_NE(p5.get(), nullptr);
+}
@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Slab.h>
+
+using namespace std;
+using namespace Afina::Allocator;
+static char slab_buf[65536];
+
+TEST(SlabTest, AllocInRange) {
+    Slab a(slab_buf, sizeof(slab_buf), 48, 1.25, 4096);
+
+    for (size_t size : {1, 48, 49, 100, 1000, 4096}) {
+        char *v = static_cast<char *>(a.alloc(size));
+        EXPECT_GE(v, slab_buf);
+        EXPECT_LE(v + size, slab_buf + sizeof(slab_buf));
+        EXPECT_GE(a.chunk_size(size), size);
+        a.free(v);
+    }
+    EXPECT_EQ(0, a.used());
+    EXPECT_EQ(4096, a.max_alloc());
+    EXPECT_EQ(0, a.chunk_size(4097));
+}
+
+TEST(SlabTest, ChunksDoNotOverlap) {
+    Slab a(slab_buf, sizeof(slab_buf), 48, 1.25, 4096);
+
+    vector<char *> ptrs;
+    for (size_t i = 0; i < 100; i++) {
+        char *p = static_cast<char *>(a.alloc(100));
+        memset(p, int(i), 100);
+        ptrs.push_back(p);
+    }
+    for (size_t i = 0; i < ptrs.size(); i++) {
+        for (size_t j = 0; j < 100; j++) {
+            ASSERT_EQ(char(i), ptrs[i][j]);
+        }
+    }
+    EXPECT_EQ(100 * a.chunk_size(100), a.used());
+    for (char *p : ptrs) {
+        a.free(p);
+    }
+    EXPECT_EQ(0, a.used());
+}
+
+TEST(SlabTest, NoMemory) {
+    Slab a(slab_buf, sizeof(slab_buf), 48, 1.25, 4096);
+
+    vector<void *> ptrs;
+    try {
+        for (size_t i = 0; i <= sizeof(slab_buf) / 4096; i++) {
+            ptrs.push_back(a.alloc(4096));
+        }
+        EXPECT_TRUE(false);
+    } catch (AllocError &e) {
+        EXPECT_EQ(e.getType(), AllocErrorType::NoMemory);
+    }
+    EXPECT_EQ(nullptr, a.try_alloc(10));
+
+    // Once page released it could serve any class
+    a.free(ptrs.back());
+    EXPECT_NE(nullptr, a.try_alloc(10));
+}
+
+TEST(SlabTest, PagesReturnToPool) {
+    Slab a(slab_buf, sizeof(slab_buf), 48, 1.25, 4096);
+
+    // Fill whole area with small chunks, then release them
+    vector<void *> ptrs;
+    void *p;
+    while ((p = a.try_alloc(64)) != nullptr) {
+        ptrs.push_back(p);
+    }
+    EXPECT_EQ(nullptr, a.try_alloc(1000));
+    for (void *p : ptrs) {
+        a.free(p);
+    }
+
+    // Now all pages are available for large chunks
+    ptrs.clear();
+    while ((p = a.try_alloc(3000)) != nullptr) {
+        ptrs.push_back(p);
+    }
+    EXPECT_EQ(sizeof(slab_buf) / 4096, ptrs.size());
+}
+
+TEST(SlabTest, InvalidFree) {
+    Slab a(slab_buf, sizeof(slab_buf), 48, 1.25, 4096);
+    char other;
+
+    try {
+        a.free(&other);
+        EXPECT_TRUE(false);
+    } catch (AllocError &e) {
+        EXPECT_EQ(e.getType(), AllocErrorType::InvalidFree);
+    }
+}
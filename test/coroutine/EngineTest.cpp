@@ -62,3 +62,34 @@ TEST(CoroutineTest, Printer) {
     engine.start(_printer, engine, result);
     ASSERT_STREQ("A1 B1 A2 B2 A3 B3 END", result.c_str());
 }
+
+struct Sleeper {
+    void *routine = nullptr;
+    int unblocks = 0;
+    std::string out;
+};
+
+void sleeper(Afina::Coroutine::Engine &pe, Sleeper &s) {
+    s.out += "S1 ";
+    pe.block();
+    s.out += "S2 ";
+}
+
+void _sleeper_main(Afina::Coroutine::Engine &pe, Sleeper &s) {
+    s.routine = pe.run(sleeper, pe, s);
+    pe.sched(s.routine);
+    s.out += "M ";
+}
+
+// Blocked routine is not scheduled until unblocker, called once nobody else could run, unblocks it
+TEST(CoroutineTest, BlockUntilUnblocked) {
+    Sleeper s;
+    Afina::Coroutine::Engine engine([&s](Afina::Coroutine::Engine &pe) {
+        s.unblocks++;
+        pe.unblock(s.routine);
+    });
+    engine.start(_sleeper_main, engine, s);
+
+    EXPECT_EQ("S1 M S2 ", s.out);
+    EXPECT_EQ(1, s.unblocks);
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <afina/execute/Get.h>
+#include <afina/execute/Response.h>
+
+#include <storage/SimpleLRU.h>
+
+using namespace Afina;
+
+// Response of the get command built the old way: copy out of storage and stringstream
+static void get_stringstream(Storage &storage, const std::vector<std::string> &keys, std::string &out) {
+    std::stringstream outStream;
+    std::string value;
+    for (auto &key : keys) {
+        if (!storage.Get(key, value))
+            continue;
+        outStream << "VALUE " << key << " 0 " << value.size() << "\r\n";
+        outStream << value << "\r\n";
+    }
+    outStream << "END\r\n";
+    out = outStream.str();
+}
+
+// Compares get response built with stringstream and with Response
+TEST(ResponseBenchmark, Get) {
+    for (size_t value_size : {size_t(100), size_t(100 * 1024)}) {
+        Backend::SimpleLRU storage(64 * (value_size + 16));
+        std::vector<std::string> keys;
+        for (int i = 0; i < 10; i++) {
+            keys.push_back("key" + std::to_string(i));
+            storage.Put(keys.back(), std::string(value_size, 'v'));
+        }
+        Execute::Get command(keys);
+        const int rounds = value_size > 1024 ? 200 : 20000;
+
+        auto start = std::chrono::steady_clock::now();
+        std::string old_out;
+        for (int i = 0; i < rounds; i++) {
+            get_stringstream(storage, keys, old_out);
+        }
+        auto old_time = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        Execute::Response out;
+        for (int i = 0; i < rounds; i++) {
+            out.Clear();
+            command.Execute(storage, "", out);
+        }
+        auto new_time = std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(old_out.size(), out.Size());
+
+        std::cerr << "get of 10 values " << value_size << " bytes: stringstream "
+                  << std::chrono::duration_cast<std::chrono::nanoseconds>(old_time).count() / rounds
+                  << " ns/op, response "
+                  << std::chrono::duration_cast<std::chrono::nanoseconds>(new_time).count() / rounds << " ns/op"
+                  << std::endl;
+    }
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <ctime>
+#include <iterator>
+#include <string>
+
+#include <afina/execute/Add.h>
+#include <afina/execute/Append.h>
+#include <afina/execute/Cas.h>
+#include <afina/execute/Decr.h>
+#include <afina/execute/Delete.h>
+#include <afina/execute/Get.h>
+#include <afina/execute/Gets.h>
+#include <afina/execute/Incr.h>
+#include <afina/execute/Prepend.h>
+#include <afina/execute/Replace.h>
+#include <afina/execute/Response.h>
+#include <afina/execute/Set.h>
+#include <afina/execute/Touch.h>
+
+#include <storage/SimpleLRU.h>
+
+using namespace Afina;
+
+// Runs command alone and returns its response
+static std::string run(Execute::Command &&command, Storage &storage, const std::string &args = "") {
+    Execute::Response out;
+    command.Execute(storage, args, out);
+    return out.str();
+}
+
+TEST(CommandTest, GetReturnsFlags) {
+    Backend::SimpleLRU storage;
+
+    EXPECT_EQ("STORED\r\n", run(Execute::Set("foo", 42, 0), storage, "fooval"));
+    EXPECT_EQ("STORED\r\n", run(Execute::Add("bar", 7, 0), storage, "barval"));
+    EXPECT_EQ("NOT_STORED\r\n", run(Execute::Add("bar", 7, 0), storage, "barval"));
+
+    EXPECT_EQ("VALUE foo 42 6\r\nfooval\r\nVALUE bar 7 6\r\nbarval\r\nEND\r\n",
+              run(Execute::Get({"foo", "missing", "bar"}), storage));
+}
+
+TEST(CommandTest, AppendKeepsFlags) {
+    Backend::SimpleLRU storage;
+
+    run(Execute::Set("foo", 42, 0), storage, "foo");
+    EXPECT_EQ("STORED\r\n", run(Execute::Append("foo", 1, 0), storage, "val"));
+    EXPECT_EQ("VALUE foo 42 6\r\nfooval\r\nEND\r\n", run(Execute::Get({"foo"}), storage));
+}
+
+TEST(CommandTest, UpdateCommands) {
+    Backend::SimpleLRU storage;
+
+    EXPECT_EQ("NOT_STORED\r\n", run(Execute::Replace("foo", 0, 0), storage, "1"));
+    EXPECT_EQ("NOT_STORED\r\n", run(Execute::Prepend("foo", 0, 0), storage, "1"));
+    EXPECT_EQ("NOT_FOUND\r\n", run(Execute::Incr("foo", 1), storage));
+    EXPECT_EQ("NOT_FOUND\r\n", run(Execute::Touch("foo", 10), storage));
+    EXPECT_EQ("NOT_FOUND\r\n", run(Execute::Delete("foo"), storage));
+
+    run(Execute::Set("foo", 0, 0), storage, "2");
+    EXPECT_EQ("STORED\r\n", run(Execute::Replace("foo", 5, 0), storage, "5"));
+    EXPECT_EQ("STORED\r\n", run(Execute::Prepend("foo", 0, 0), storage, "1"));
+    EXPECT_EQ("17\r\n", run(Execute::Incr("foo", 2), storage));
+    EXPECT_EQ("0\r\n", run(Execute::Decr("foo", 100), storage));
+    EXPECT_EQ("TOUCHED\r\n", run(Execute::Touch("foo", 10), storage));
+    EXPECT_EQ("VALUE foo 5 1\r\n0\r\nEND\r\n", run(Execute::Get({"foo"}), storage));
+
+    run(Execute::Set("foo", 0, 0), storage, "bar");
+    EXPECT_EQ("CLIENT_ERROR cannot increment or decrement non-numeric value\r\n",
+              run(Execute::Incr("foo", 1), storage));
+    EXPECT_EQ("DELETED\r\n", run(Execute::Delete("foo"), storage));
+    EXPECT_EQ("END\r\n", run(Execute::Get({"foo"}), storage));
+}
+
+TEST(CommandTest, GetsAndCas) {
+    Backend::SimpleLRU storage;
+
+    run(Execute::Set("foo", 3, 0), storage, "bar");
+    ItemView item;
+    ASSERT_TRUE(storage.Get("foo", item));
+    uint64_t cas = item.header.cas;
+    EXPECT_EQ("VALUE foo 3 3 " + std::to_string(cas) + "\r\nbar\r\nEND\r\n", run(Execute::Gets({"foo"}), storage));
+
+    EXPECT_EQ("NOT_FOUND\r\n", run(Execute::Cas("baz", 0, 0, cas), storage, "new"));
+    EXPECT_EQ("STORED\r\n", run(Execute::Cas("foo", 4, 0, cas), storage, "new"));
+    EXPECT_EQ("EXISTS\r\n", run(Execute::Cas("foo", 4, 0, cas), storage, "newer"));
+    EXPECT_EQ("VALUE foo 4 3\r\nnew\r\nEND\r\n", run(Execute::Get({"foo"}), storage));
+}
+
+TEST(CommandTest, ExpireTime) {
+    EXPECT_EQ(0, Execute::Set("foo", 0, 0).ttl());
+    EXPECT_EQ(100, Execute::Set("foo", 0, 100).ttl());
+    EXPECT_EQ(-1, Execute::Set("foo", 0, -5).ttl());
+
+    // Absolute time
+    int32_t now = int32_t(std::time(nullptr));
+    EXPECT_EQ(-1, Execute::Set("foo", 0, now - 10).ttl());
+    EXPECT_NEAR(1000, Execute::Set("foo", 0, now + 1000).ttl(), 2);
+
+    Backend::SimpleLRU storage;
+    run(Execute::Set("foo", 0, -1), storage, "fooval");
+    EXPECT_EQ("END\r\n", run(Execute::Get({"foo"}), storage));
+}
+
+TEST(ResponseTest, FormatUint) {
+    char buf[20];
+    for (uint64_t n : {uint64_t(0), uint64_t(7), uint64_t(10), uint64_t(99), uint64_t(100), uint64_t(12345),
+                       uint64_t(18446744073709551615ull)}) {
+        EXPECT_EQ(std::to_string(n), std::string(buf, Execute::format_uint(n, buf)));
+    }
+}
+
+TEST(ResponseTest, SegmentsAndConsume) {
+    Execute::Response out;
+    std::string large(2000, 'x');
+    auto pinned = std::make_shared<std::string>(large);
+    ItemView view{ItemHeader{0, 0, large.size()}, std::shared_ptr<const char>(pinned, pinned->data())};
+
+    out.Append("VALUE ").Append(uint64_t(2000)).Append("\r\n").Append(view).Append("\r\nEND");
+    EXPECT_EQ(3, out.IovCount());
+    EXPECT_EQ(6 + 4 + 2 + 2000 + 5, out.Size());
+    EXPECT_EQ(pinned->data(), out.Iov()[1].iov_base);
+
+    // Large value is not copied and stays alive as long as response references it
+    pinned.reset();
+    view.value.reset();
+    EXPECT_EQ("VALUE 2000\r\n" + large + "\r\nEND", out.str());
+
+    out.Consume(10);
+    EXPECT_EQ("\r\n" + large + "\r\nEND", out.str());
+    out.Consume(1000);
+    EXPECT_EQ(2, out.IovCount());
+    out.Append("!");
+    EXPECT_EQ(std::string(1002, 'x') + "\r\nEND!", out.str());
+    out.Consume(out.Size());
+    EXPECT_TRUE(out.Empty());
+    EXPECT_EQ(0, out.IovCount());
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <storage/ThreadSafeSimpleLRU.h>
+
+#include "Connections.h"
+
+using namespace Afina;
+
+// Idle connections must not slow down the active ones. Full scale is 100k idle and 1k active
+// connections, test takes as many as file descriptor limit allows: each connection costs two of them
+static void idle_and_active(server_factory make_server) {
+    struct rlimit limit;
+    ASSERT_EQ(0, getrlimit(RLIMIT_NOFILE, &limit));
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    const std::size_t budget = limit.rlim_cur > 1024 ? (limit.rlim_cur - 1024) / 2 : 0;
+    const std::size_t active = std::min<std::size_t>(1000, budget / 2);
+    const std::size_t idle = std::min<std::size_t>(100000, budget - active);
+    ASSERT_GT(active, 0);
+
+    auto storage = std::make_shared<Backend::ThreadSafeSimplLRU>(1 << 20);
+    ASSERT_TRUE(storage->Put("key", std::string(100, 'v')));
+    auto server = make_server(storage);
+    uint16_t port = free_port();
+    ASSERT_NE(0, port);
+    server->Start(port, 1, 2);
+
+    std::vector<int> sockets;
+    sockets.reserve(idle + active);
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < idle + active; i++) {
+        int s = connect_to(port, i);
+        ASSERT_NE(-1, s) << "connection " << i << ": " << strerror(errno);
+        sockets.push_back(s);
+    }
+    double connect_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Every active connection sends a batch of pipelined gets, then all the responses are read
+    const int rounds = 20, batch = 10;
+    std::string request, response;
+    for (int i = 0; i < batch; i++) {
+        request += "get key\r\n";
+    }
+    const std::size_t response_size = batch * (std::string("VALUE key 0 100\r\n").size() + 100 + 2 + 5);
+
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (std::size_t i = idle; i < idle + active; i++) {
+            ASSERT_EQ(ssize_t(request.size()), write(sockets[i], request.data(), request.size()));
+        }
+        for (std::size_t i = idle; i < idle + active; i++) {
+            ASSERT_TRUE(read_exactly(sockets[i], response, response_size));
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Idle ones are still served
+    for (std::size_t i = 0; i < idle; i += std::max<std::size_t>(1, idle / 16)) {
+        ASSERT_EQ(ssize_t(request.size()), write(sockets[i], request.data(), request.size()));
+        ASSERT_TRUE(read_exactly(sockets[i], response, response_size));
+    }
+
+    std::cerr << idle << " idle + " << active << " active connections: connect " << connect_ms << " ms, "
+              << rounds * active * batch / elapsed << " gets/s" << std::endl;
+
+    // Connections are reset, so that their ports don't stay in TIME_WAIT for the next test
+    struct linger reset = {1, 0};
+    for (int s : sockets) {
+        setsockopt(s, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+        close(s);
+    }
+    server->Stop();
+    server->Join();
+}
+
+TEST(ConnectionBenchmark, IdleAndActive) { idle_and_active(mt_nonblocking(false)); }
+
+// Same load, workers have own epolls and listening sockets
+TEST(ConnectionBenchmark, ReusePort) { idle_and_active(mt_nonblocking(true)); }
+
+// Same load, workers have own rings
+TEST(ConnectionBenchmark, IOUring) { idle_and_active(io_uring); }
+
+// Same load, every connection is a coroutine of the single thread
+TEST(ConnectionBenchmark, Coroutine) { idle_and_active(st_coroutine); }
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <storage/ThreadSafeSimpleLRU.h>
+
+#include "Connections.h"
+
+using namespace Afina;
+
+// Few busy connections among idle ones, every command is split between writes. Responses must come
+// complete and in order
+static void split_pipelines(Network::Server &server, uint32_t workers, std::size_t busy) {
+    uint16_t port = free_port();
+    ASSERT_NE(0, port);
+    server.Start(port, 1, workers);
+
+    const std::size_t total = 64;
+    std::vector<int> sockets;
+    for (std::size_t i = 0; i < total; i++) {
+        int s = connect_to(port, i);
+        ASSERT_NE(-1, s) << "connection " << i << ": " << strerror(errno);
+        sockets.push_back(s);
+    }
+
+    std::vector<std::string> requests, responses;
+    for (std::size_t i = 0; i < busy; i++) {
+        std::string key = "key" + std::to_string(i), request, response;
+        for (int j = 0; j < 4; j++) {
+            std::string value = std::to_string(i * 1000 + j);
+            request += "set " + key + " 0 0 " + std::to_string(value.size()) + "\r\n" + value + "\r\nget " + key +
+                       "\r\n";
+            response +=
+                "STORED\r\nVALUE " + key + " 0 " + std::to_string(value.size()) + "\r\n" + value + "\r\nEND\r\n";
+        }
+        requests.push_back(request);
+        responses.push_back(response);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::string response;
+    std::size_t rounds = 0;
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1500)) {
+        std::size_t split = 1 + rounds % (requests[0].size() - 1);
+        for (std::size_t i = 0; i < busy; i++) {
+            ASSERT_EQ(ssize_t(split), write(sockets[i], requests[i].data(), split));
+        }
+        for (std::size_t i = 0; i < busy; i++) {
+            std::size_t rest = requests[i].size() - split;
+            ASSERT_EQ(ssize_t(rest), write(sockets[i], requests[i].data() + split, rest));
+        }
+        for (std::size_t i = 0; i < busy; i++) {
+            ASSERT_TRUE(read_exactly(sockets[i], response, responses[i].size()));
+            ASSERT_EQ(responses[i], response) << "round " << rounds;
+        }
+        rounds++;
+    }
+    std::cerr << busy << " busy connections of " << total << ": " << rounds << " rounds" << std::endl;
+
+    struct linger reset = {1, 0};
+    for (int s : sockets) {
+        setsockopt(s, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+        close(s);
+    }
+    server.Stop();
+    server.Join();
+}
+
+// Kernel spreads connections between workers at random. With as many busy connections as workers some
+// worker is left idle and some serves more than one, so there is always something to hand over, and
+// connections get moved between workers with the commands half-read
+TEST(ConnectionScalingTest, RebalanceKeepsPipelines) {
+    Network::MTnonblock::ServerImpl server(std::make_shared<Backend::ThreadSafeSimplLRU>(1 << 20),
+                                           std::make_shared<NullLogging>(), true, 1);
+    split_pipelines(server, 16, 16);
+    EXPECT_LT(0, server.Migrated());
+}
+
+TEST(ConnectionScalingTest, IOUringKeepsPipelines) {
+    auto server = io_uring(std::make_shared<Backend::ThreadSafeSimplLRU>(1 << 20));
+    split_pipelines(*server, 4, 8);
+}
+
+TEST(ConnectionScalingTest, CoroutineKeepsPipelines) {
+    auto server = st_coroutine(std::make_shared<Backend::ThreadSafeSimplLRU>(1 << 20));
+    split_pipelines(*server, 4, 8);
+}
+
+// Response which doesn't fit into socket buffer is sent while client reads it slowly
+static void large_response(server_factory make_server) {
+    auto storage = std::make_shared<Backend::ThreadSafeSimplLRU>(16 << 20);
+    ASSERT_TRUE(storage->Put("big", std::string(1 << 20, 'x')));
+    auto server = make_server(storage);
+    uint16_t port = free_port();
+    ASSERT_NE(0, port);
+    server->Start(port, 1, 1);
+
+    int s = connect_to(port, 0);
+    ASSERT_NE(-1, s) << strerror(errno);
+    std::string request;
+    for (int i = 0; i < 8; i++) {
+        request += "get big\r\n";
+    }
+    ASSERT_EQ(ssize_t(request.size()), write(s, request.data(), request.size()));
+
+    // Client is done with writing, but still waits for all the responses
+    ASSERT_EQ(0, shutdown(s, SHUT_WR));
+
+    const std::string header = "VALUE big 0 1048576\r\n";
+    std::string response;
+    for (int i = 0; i < 8; i++) {
+        usleep(10000);
+        ASSERT_TRUE(read_exactly(s, response, header.size() + (1 << 20) + 2 + 5));
+        ASSERT_EQ(header, response.substr(0, header.size()));
+        ASSERT_EQ("\r\nEND\r\n", response.substr(response.size() - 7));
+    }
+
+    // Server closes connection once everything is sent
+    char rest;
+    ASSERT_EQ(0, read(s, &rest, 1));
+
+    close(s);
+    server->Stop();
+    server->Join();
+}
+
+TEST(ConnectionScalingTest, NonblockingLargeResponse) { large_response(mt_nonblocking(false)); }
+
+TEST(ConnectionScalingTest, ReusePortLargeResponse) { large_response(mt_nonblocking(true)); }
+
+TEST(ConnectionScalingTest, IOUringLargeResponse) { large_response(io_uring); }
+
+// Coroutine gets blocked in the middle of the response
+TEST(ConnectionScalingTest, CoroutineLargeResponse) { large_response(st_coroutine); }
@@ -0,0 +1,121 @@
+#ifndef AFINA_TEST_NETWORK_CONNECTIONS_H
+#define AFINA_TEST_NETWORK_CONNECTIONS_H
+
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/logging/Service.h>
+#include <network/io_uring/ServerImpl.h>
+#include <network/mt_nonblocking/ServerImpl.h>
+#include <network/st_coroutine/ServerImpl.h>
+
+// Loggers that write nowhere
+class NullLogging : public Afina::Logging::Service {
+public:
+    void Start() override {}
+    void Stop() override {}
+    void reopen_all() override {}
+
+    std::shared_ptr<spdlog::logger> select(const std::string &name) noexcept override { return _logger; }
+
+    std::unique_ptr<spdlog::logger> create(const std::string &name,
+                                           const std::map<std::string, std::string> &) noexcept override {
+        return std::unique_ptr<spdlog::logger>(new spdlog::logger(name, spdlog::sinks_init_list{}));
+    }
+
+private:
+    std::shared_ptr<spdlog::logger> _logger = std::make_shared<spdlog::logger>("null", spdlog::sinks_init_list{});
+};
+
+// Connects to the server, every 16k connections come from the next loopback address so that client
+// ports never run out
+inline int connect_to(uint16_t port, std::size_t n) {
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s == -1) {
+        return -1;
+    }
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK + 1 + n / 16384);
+    if (bind(s, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+        close(s);
+        return -1;
+    }
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(s, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+        close(s);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return s;
+}
+
+// Reads until exactly size bytes came
+inline bool read_exactly(int s, std::string &buf, std::size_t size) {
+    buf.resize(size);
+    std::size_t pos = 0;
+    while (pos < size) {
+        ssize_t n = read(s, &buf[pos], size - pos);
+        if (n <= 0) {
+            return false;
+        }
+        pos += n;
+    }
+    return true;
+}
+
+// Server of the given kind
+typedef std::function<std::unique_ptr<Afina::Network::Server>(std::shared_ptr<Afina::Storage>)> server_factory;
+
+inline server_factory mt_nonblocking(bool reuseport) {
+    return [reuseport](std::shared_ptr<Afina::Storage> storage) {
+        return std::unique_ptr<Afina::Network::Server>(
+            new Afina::Network::MTnonblock::ServerImpl(storage, std::make_shared<NullLogging>(), reuseport));
+    };
+}
+
+inline std::unique_ptr<Afina::Network::Server> io_uring(std::shared_ptr<Afina::Storage> storage) {
+    return std::unique_ptr<Afina::Network::Server>(
+        new Afina::Network::IOuring::ServerImpl(storage, std::make_shared<NullLogging>()));
+}
+
+inline std::unique_ptr<Afina::Network::Server> st_coroutine(std::shared_ptr<Afina::Storage> storage) {
+    return std::unique_ptr<Afina::Network::Server>(
+        new Afina::Network::STcoroutine::ServerImpl(storage, std::make_shared<NullLogging>()));
+}
+
+// Port nobody listens on: kernel picks it for a socket bound to port 0, which is closed right away. Such
+// socket never connected, so the port is free again at once and parallel runs of the tests don't collide
+inline uint16_t free_port() {
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s == -1) {
+        return 0;
+    }
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    socklen_t len = sizeof(addr);
+    uint16_t port = 0;
+    if (bind(s, (struct sockaddr *)&addr, sizeof(addr)) == 0 && getsockname(s, (struct sockaddr *)&addr, &len) == 0) {
+        port = ntohs(addr.sin_port);
+    }
+    close(s);
+    return port;
+}
+
+#endif // AFINA_TEST_NETWORK_CONNECTIONS_H
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <network/Session.h>
+#include <storage/SimpleLRU.h>
+
+using namespace Afina;
+
+static std::shared_ptr<spdlog::logger> quiet_logger() {
+    return std::make_shared<spdlog::logger>("session", spdlog::sinks_init_list{});
+}
+
+// Pipelined stream of sets and gets along with the responses server must send
+static void pipeline(int count, std::string &input, std::string &expected) {
+    for (int i = 0; i < count; i++) {
+        std::string key = "key" + std::to_string(i), value = "value" + std::to_string(i);
+        input += "set " + key + " 0 0 " + std::to_string(value.size()) + "\r\n" + value + "\r\nget " + key + "\r\n";
+        expected += "STORED\r\nVALUE " + key + " 0 " + std::to_string(value.size()) + "\r\n" + value + "\r\nEND\r\n";
+    }
+}
+
+TEST(SessionTest, WholeBurstAtOnce) {
+    Network::Session session(std::make_shared<Backend::SimpleLRU>(), quiet_logger());
+
+    std::string input, expected;
+    pipeline(100, input, expected);
+    ASSERT_TRUE(session.Process(input.data(), input.size()));
+    EXPECT_EQ(expected, session.Output().str());
+}
+
+// Commands split between reads at every possible place are continued by the next read
+TEST(SessionTest, SplitReads) {
+    std::string input, expected;
+    pipeline(10, input, expected);
+
+    for (std::size_t chunk = 1; chunk < 64; chunk++) {
+        Network::Session session(std::make_shared<Backend::SimpleLRU>(), quiet_logger());
+        for (std::size_t pos = 0; pos < input.size(); pos += chunk) {
+            ASSERT_TRUE(session.Process(&input[pos], std::min(chunk, input.size() - pos)));
+        }
+        EXPECT_EQ(expected, session.Output().str()) << "chunk " << chunk;
+    }
+}
+
+// Responses of the commands before the broken one are still there
+TEST(SessionTest, BrokenInput) {
+    Network::Session session(std::make_shared<Backend::SimpleLRU>(), quiet_logger());
+
+    std::string input = "set foo 0 0 3\r\nbar\r\nbogus foo\r\nget foo\r\n";
+    EXPECT_FALSE(session.Process(input.data(), input.size()));
+    EXPECT_NE("", session.Error());
+    EXPECT_EQ("STORED\r\n", session.Output().str());
+
+    session.Reset();
+    EXPECT_TRUE(session.Output().Empty());
+    input = "get foo\r\n";
+    EXPECT_TRUE(session.Process(input.data(), input.size()));
+    EXPECT_EQ("VALUE foo 0 3\r\nbar\r\nEND\r\n", session.Output().str());
+}
+
+TEST(SessionTest, Flush) {
+    int sockets[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sockets));
+    ASSERT_EQ(0, fcntl(sockets[0], F_SETFL, O_NONBLOCK));
+
+    // Large values, so that socket buffer gets full
+    auto storage = std::make_shared<Backend::SimpleLRU>(16 << 20);
+    ASSERT_TRUE(storage->Put("big", std::string(1 << 20, 'x')));
+    Network::Session session(storage, quiet_logger());
+    std::string input;
+    for (int i = 0; i < 8; i++) {
+        input += "get big\r\n";
+    }
+    ASSERT_TRUE(session.Process(input.data(), input.size()));
+    std::size_t total = session.Output().Size();
+
+    // Whatever didn't fit is kept until the peer reads
+    EXPECT_FALSE(session.Flush(sockets[0]));
+    std::size_t received = 0;
+    char buf[1 << 16];
+    while (!session.Flush(sockets[0]) || received < total) {
+        ssize_t n = read(sockets[1], buf, sizeof(buf));
+        ASSERT_GT(n, 0);
+        received += n;
+    }
+    EXPECT_EQ(total, received);
+    EXPECT_TRUE(session.Output().Empty());
+
+    close(sockets[0]);
+    close(sockets[1]);
+}
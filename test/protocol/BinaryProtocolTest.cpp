@@ -0,0 +1,302 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <endian.h>
+
+#include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
+
+#include <protocol/Binary.h>
+#include <protocol/Parser.h>
+#include <storage/SimpleLRU.h>
+
+using namespace Afina;
+using namespace Afina::Protocol;
+
+// Encodes binary request
+static std::string request(uint8_t opcode, const std::string &key, const std::string &value = "",
+                           const std::string &extras = "", uint32_t opaque = 0) {
+    Binary::Header header;
+    header.magic = Binary::request_magic;
+    header.opcode = opcode;
+    header.key_length = uint16_t(key.size());
+    header.extras_length = uint8_t(extras.size());
+    header.data_type = 0;
+    header.status = 0;
+    header.body_length = uint32_t(extras.size() + key.size() + value.size());
+    header.opaque = opaque;
+    header.cas = 0;
+
+    char buf[Binary::header_size];
+    header.encode(buf);
+    return std::string(buf, sizeof(buf)) + extras + key + value;
+}
+
+// Extras of set, add and replace
+static std::string store_extras(uint32_t flags, uint32_t exptime) {
+    uint32_t be[2] = {htobe32(flags), htobe32(exptime)};
+    return std::string(reinterpret_cast<const char *>(be), sizeof(be));
+}
+
+// Parses and executes every request of the stream, returns all the responses
+static std::string run(Parser &parser, Storage &storage, const std::string &stream) {
+    Execute::Response out;
+    std::size_t pos = 0;
+    while (pos < stream.size()) {
+        std::size_t parsed = 0;
+        EXPECT_TRUE(parser.Parse(&stream[pos], stream.size() - pos, parsed));
+        pos += parsed;
+
+        std::size_t body_size = 0;
+        std::unique_ptr<Execute::Command> command = parser.Build(body_size);
+        EXPECT_EQ(0, parser.Trailer());
+        command->Execute(storage, stream.substr(pos, body_size), out);
+        pos += body_size;
+        parser.Reset();
+    }
+    return out.str();
+}
+
+TEST(BinaryProtocolTest, HeaderRoundTrip) {
+    std::string wire = request(Binary::SetQ, "key", "value", store_extras(42, 100), 0xdeadbeef);
+    ASSERT_EQ(Binary::header_size + 8 + 3 + 5, wire.size());
+
+    Binary::Header header = Binary::Header::decode(wire.data());
+    EXPECT_EQ(Binary::request_magic, header.magic);
+    EXPECT_EQ(Binary::SetQ, header.opcode);
+    EXPECT_EQ(3, header.key_length);
+    EXPECT_EQ(8, header.extras_length);
+    EXPECT_EQ(16, header.body_length);
+    EXPECT_EQ(0xdeadbeef, header.opaque);
+    EXPECT_EQ(5, header.value_length());
+}
+
+TEST(BinaryProtocolTest, SetThenGetK) {
+    Parser parser;
+    Backend::SimpleLRU storage;
+
+    std::size_t parsed = 0, body_size = 0;
+    std::string set = request(Binary::Set, "foo", "fooval", store_extras(42, 0), 7);
+    ASSERT_TRUE(parser.Parse(set, parsed));
+    EXPECT_EQ(set.size() - 6, parsed);
+    EXPECT_EQ("set", parser.Name());
+    ASSERT_EQ(1, parser.Keys().size());
+    EXPECT_EQ("foo", parser.Keys()[0].str());
+    parser.Build(body_size);
+    EXPECT_EQ(6, body_size);
+    parser.Reset();
+
+    std::string response = run(parser, storage, set);
+    ASSERT_EQ(Binary::header_size, response.size());
+    Binary::Header header = Binary::Header::decode(response.data());
+    EXPECT_EQ(Binary::response_magic, header.magic);
+    EXPECT_EQ(Binary::Set, header.opcode);
+    EXPECT_EQ(Binary::NoError, header.status);
+    EXPECT_EQ(7, header.opaque);
+
+    response = run(parser, storage, request(Binary::GetK, "foo", "", "", 8));
+    header = Binary::Header::decode(response.data());
+    EXPECT_EQ(Binary::NoError, header.status);
+    EXPECT_EQ(4, header.extras_length);
+    EXPECT_EQ(3, header.key_length);
+    EXPECT_EQ(4 + 3 + 6, header.body_length);
+    EXPECT_EQ(8, header.opaque);
+    EXPECT_NE(0, header.cas);
+    ASSERT_EQ(Binary::header_size + header.body_length, response.size());
+    EXPECT_EQ(store_extras(42, 0).substr(0, 4), response.substr(Binary::header_size, 4));
+    EXPECT_EQ("foofooval", response.substr(Binary::header_size + 4));
+
+    // Plain get doesn't return the key, miss is reported
+    response = run(parser, storage, request(Binary::Get, "foo") + request(Binary::Get, "bar"));
+    header = Binary::Header::decode(response.data());
+    EXPECT_EQ(0, header.key_length);
+    EXPECT_EQ(4 + 6, header.body_length);
+    header = Binary::Header::decode(response.data() + Binary::header_size + 10);
+    EXPECT_EQ(Binary::KeyNotFound, header.status);
+    EXPECT_EQ(Binary::header_size * 2 + 10, response.size());
+}
+
+TEST(BinaryProtocolTest, StoreFailures) {
+    Parser parser;
+    Backend::SimpleLRU storage;
+
+    run(parser, storage, request(Binary::Set, "foo", "fooval", store_extras(0, 0)));
+
+    std::string response = run(parser, storage, request(Binary::AddQ, "foo", "x", store_extras(0, 0)));
+    ASSERT_EQ(Binary::header_size, response.size());
+    EXPECT_EQ(Binary::KeyExists, Binary::Header::decode(response.data()).status);
+
+    response = run(parser, storage, request(Binary::Replace, "bar", "x", store_extras(0, 0)));
+    EXPECT_EQ(Binary::KeyNotFound, Binary::Header::decode(response.data()).status);
+
+    response = run(parser, storage, request(Binary::Append, "bar", "x"));
+    EXPECT_EQ(Binary::ItemNotStored, Binary::Header::decode(response.data()).status);
+}
+
+TEST(BinaryProtocolTest, CounterAndCas) {
+    Parser parser;
+    Backend::SimpleLRU storage;
+
+    // Missing counter is created with the initial value unless expiration is all ones
+    uint64_t extras[3] = {htobe64(5), htobe64(100), 0};
+    std::string incr_extras(reinterpret_cast<const char *>(extras), 20);
+    std::string response = run(parser, storage, request(Binary::Increment, "cnt", "", incr_extras));
+    ASSERT_EQ(Binary::header_size + 8, response.size());
+    uint64_t value;
+    std::memcpy(&value, &response[Binary::header_size], 8);
+    EXPECT_EQ(100, be64toh(value));
+
+    response = run(parser, storage, request(Binary::Decrement, "cnt", "", incr_extras));
+    std::memcpy(&value, &response[Binary::header_size], 8);
+    EXPECT_EQ(95, be64toh(value));
+
+    std::memset(&incr_extras[16], 0xff, 4);
+    response = run(parser, storage, request(Binary::Increment, "missing", "", incr_extras));
+    EXPECT_EQ(Binary::KeyNotFound, Binary::Header::decode(response.data()).status);
+
+    // Set with version of the item is check and set
+    Afina::ItemView item;
+    ASSERT_TRUE(storage.Get("cnt", item));
+    std::string set = request(Binary::Set, "cnt", "new", store_extras(0, 0));
+    uint64_t cas = htobe64(item.header.cas + 1);
+    std::memcpy(&set[16], &cas, 8);
+    response = run(parser, storage, set);
+    EXPECT_EQ(Binary::KeyExists, Binary::Header::decode(response.data()).status);
+
+    cas = htobe64(item.header.cas);
+    std::memcpy(&set[16], &cas, 8);
+    response = run(parser, storage, set);
+    EXPECT_EQ(Binary::NoError, Binary::Header::decode(response.data()).status);
+
+    response = run(parser, storage, request(Binary::DeleteQ, "cnt") + request(Binary::Delete, "cnt"));
+    ASSERT_EQ(Binary::header_size, response.size());
+    EXPECT_EQ(Binary::KeyNotFound, Binary::Header::decode(response.data()).status);
+}
+
+// Every successful update tells the new version of the item, so client could cas it without get
+TEST(BinaryProtocolTest, UpdatesReturnCas) {
+    Parser parser;
+    Backend::SimpleLRU storage;
+
+    auto stored_cas = [&storage](const std::string &key) {
+        Afina::ItemView item;
+        EXPECT_TRUE(storage.Get(key, item));
+        return item.header.cas;
+    };
+
+    std::string response = run(parser, storage, request(Binary::Set, "foo", "val", store_extras(0, 0)));
+    Binary::Header header = Binary::Header::decode(response.data());
+    EXPECT_EQ(Binary::NoError, header.status);
+    EXPECT_NE(0, header.cas);
+    EXPECT_EQ(stored_cas("foo"), header.cas);
+
+    // Version from the set response is good for the next cas, the stale one isn't
+    std::string set = request(Binary::Set, "foo", "new", store_extras(0, 0));
+    uint64_t cas = htobe64(header.cas);
+    std::memcpy(&set[16], &cas, 8);
+    response = run(parser, storage, set);
+    header = Binary::Header::decode(response.data());
+    EXPECT_EQ(Binary::NoError, header.status);
+    EXPECT_EQ(stored_cas("foo"), header.cas);
+
+    response = run(parser, storage, set);
+    header = Binary::Header::decode(response.data());
+    EXPECT_EQ(Binary::KeyExists, header.status);
+    EXPECT_EQ(0, header.cas);
+
+    response = run(parser, storage, request(Binary::Append, "foo", "x"));
+    EXPECT_EQ(stored_cas("foo"), Binary::Header::decode(response.data()).cas);
+    response = run(parser, storage, request(Binary::Add, "bar", "5", store_extras(0, 0)));
+    EXPECT_EQ(stored_cas("bar"), Binary::Header::decode(response.data()).cas);
+    response = run(parser, storage, request(Binary::Replace, "bar", "7", store_extras(0, 0)));
+    EXPECT_EQ(stored_cas("bar"), Binary::Header::decode(response.data()).cas);
+
+    // Counter reports version of the item both when it is updated and when it is created
+    uint64_t extras[3] = {htobe64(1), htobe64(100), 0};
+    std::string incr_extras(reinterpret_cast<const char *>(extras), 20);
+    response = run(parser, storage, request(Binary::Increment, "bar", "", incr_extras));
+    EXPECT_EQ(stored_cas("bar"), Binary::Header::decode(response.data()).cas);
+    response = run(parser, storage, request(Binary::Increment, "cnt", "", incr_extras));
+    EXPECT_EQ(stored_cas("cnt"), Binary::Header::decode(response.data()).cas);
+}
+
+// Quiet requests answer only hits, noop closes the batch
+TEST(BinaryProtocolTest, QuietPipeline) {
+    Parser parser;
+    Backend::SimpleLRU storage;
+
+    std::string batch = request(Binary::SetQ, "foo", "fooval", store_extras(1, 0), 1) +
+                        request(Binary::SetQ, "bar", "barval", store_extras(2, 0), 2) +
+                        request(Binary::GetQ, "missing", "", "", 3) + request(Binary::GetKQ, "bar", "", "", 4) +
+                        request(Binary::Noop, "", "", "", 5);
+    std::string response = run(parser, storage, batch);
+
+    Binary::Header hit = Binary::Header::decode(response.data());
+    EXPECT_EQ(Binary::GetKQ, hit.opcode);
+    EXPECT_EQ(4, hit.opaque);
+    EXPECT_EQ("barbarval", response.substr(Binary::header_size + 4, hit.body_length - 4));
+
+    ASSERT_EQ(Binary::header_size * 2 + hit.body_length, response.size());
+    Binary::Header noop = Binary::Header::decode(response.data() + Binary::header_size + hit.body_length);
+    EXPECT_EQ(Binary::Noop, noop.opcode);
+    EXPECT_EQ(Binary::NoError, noop.status);
+    EXPECT_EQ(5, noop.opaque);
+}
+
+// Request split over many reads is parsed the same way, text command could follow it
+TEST(BinaryProtocolTest, ByteByByte) {
+    Parser parser;
+
+    std::string input = request(Binary::Add, "key", "value", store_extras(3, 60)) + "get key\r\n";
+    std::size_t consumed = 0, pos = 0;
+    while (!parser.Parse(&input[pos], 1, consumed)) {
+        ASSERT_EQ(1, consumed);
+        pos++;
+    }
+    pos += consumed;
+    EXPECT_EQ(Binary::header_size + 8 + 3, pos);
+    EXPECT_EQ("add", parser.Name());
+    EXPECT_EQ("key", parser.Keys()[0].str());
+
+    std::size_t body_size = 0;
+    ASSERT_TRUE(parser.Build(body_size) != nullptr);
+    EXPECT_EQ(5, body_size);
+    EXPECT_EQ(0, parser.Trailer());
+
+    pos += body_size;
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse(&input[pos], input.size() - pos, consumed));
+    EXPECT_EQ("get", parser.Name());
+    EXPECT_EQ(2, parser.Trailer());
+}
+
+TEST(BinaryProtocolTest, Errors) {
+    Parser parser;
+    std::size_t consumed = 0;
+
+    // Unknown opcode
+    EXPECT_THROW(parser.Parse(request(0x7f, "key"), consumed), std::runtime_error);
+    parser.Reset();
+
+    // Set without extras
+    EXPECT_THROW(parser.Parse(request(Binary::Set, "key", "value"), consumed), std::runtime_error);
+    parser.Reset();
+
+    // Get without key
+    EXPECT_THROW(parser.Parse(request(Binary::Get, ""), consumed), std::runtime_error);
+    parser.Reset();
+
+    // Key is too long
+    EXPECT_THROW(parser.Parse(request(Binary::Get, std::string(Binary::max_key + 1, 'k')), consumed),
+                 std::runtime_error);
+    parser.Reset();
+
+    // Body is shorter than key
+    std::string broken = request(Binary::Get, "key");
+    broken[11] = 1;
+    EXPECT_THROW(parser.Parse(broken, consumed), std::runtime_error);
+}
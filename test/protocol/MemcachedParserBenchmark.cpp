@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <afina/execute/Command.h>
+
+#include <protocol/Parser.h>
+
+using namespace Afina;
+
+// Parse pipelined stream of commands the way connection does
+TEST(MemcachedParserBenchmark, Throughput) {
+    std::string input;
+    size_t commands = 0;
+    while (input.size() < (1 << 20)) {
+        input += "get user:profile:" + std::to_string(commands) + " session:" + std::to_string(commands) + "\r\n";
+        input += "set user:counter:" + std::to_string(commands) + " 0 3600 0\r\n";
+        commands += 2;
+    }
+
+    Protocol::Parser parser;
+    const int rounds = 5;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        size_t pos = 0, parsed = 0, body_size = 0;
+        while (pos < input.size()) {
+            ASSERT_TRUE(parser.Parse(&input[pos], input.size() - pos, parsed));
+            ASSERT_TRUE(parser.Build(body_size) != nullptr);
+            parser.Reset();
+            pos += parsed;
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+    std::cerr << "parse and build: " << ns / (rounds * commands) << " ns/command, "
+              << rounds * input.size() / (ns / 1e9) / (1 << 20) << " MiB/s" << std::endl;
+}
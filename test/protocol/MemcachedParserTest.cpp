@@ -1,14 +1,24 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 #include <afina/execute/Add.h>
+#include <afina/execute/Cas.h>
+#include <afina/execute/Decr.h>
+#include <afina/execute/Delete.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Gets.h>
+#include <afina/execute/Incr.h>
+#include <afina/execute/Prepend.h>
+#include <afina/execute/Replace.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
+#include <afina/execute/Touch.h>
 
 #include <protocol/Parser.h>
+#include <storage/SimpleLRU.h>
 
 using namespace Afina;
 
@@ -98,3 +108,138 @@ TEST(MemcachedParserTest, Stats) {
     Execute::Stats *tmp = reinterpret_cast<Execute::Stats *>(cmd.get());
     ASSERT_FALSE(tmp == nullptr);
 }
+
+// Command split over many reads is parsed the same way
+TEST(MemcachedParserTest, ByteByByte) {
+    Protocol::Parser parser;
+
+    std::string input = "get ke key2 super_long_key\r\nset foo 0 0 6\r\n";
+    size_t consumed = 0, pos = 0;
+    while (!parser.Parse(&input[pos], 1, consumed)) {
+        ASSERT_EQ(1, consumed);
+        pos++;
+    }
+    ASSERT_EQ(1, consumed);
+    ASSERT_EQ(28, pos + consumed);
+    ASSERT_EQ("get", parser.Name());
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    Execute::Get *tmp = reinterpret_cast<Execute::Get *>(cmd.get());
+    ASSERT_EQ(3, tmp->keys().size());
+    ASSERT_EQ("super_long_key", tmp->keys()[2]);
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse(&input[28], input.size() - 28, consumed));
+    ASSERT_EQ(input.size() - 28, consumed);
+    ASSERT_EQ("set", parser.Name());
+}
+
+// Every command of the set is built
+TEST(MemcachedParserTest, CommandSet) {
+    Protocol::Parser parser;
+    size_t consumed = 0, value_size = 0;
+
+    ASSERT_TRUE(parser.Parse("cas foo 1 2 3 18446744073709551615\r\n", consumed));
+    EXPECT_EQ("cas", parser.Name());
+    auto cmd = parser.Build(value_size);
+    EXPECT_EQ(3, value_size);
+    EXPECT_EQ(18446744073709551615ull, dynamic_cast<Execute::Cas &>(*cmd).cas());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("gets foo bar\r\n", consumed));
+    EXPECT_EQ(2, dynamic_cast<Execute::Gets &>(*parser.Build(value_size)).keys().size());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("prepend foo 0 0 1\r\n", consumed));
+    EXPECT_NE(nullptr, dynamic_cast<Execute::Prepend *>(parser.Build(value_size).get()));
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("replace foo 0 0 1\r\n", consumed));
+    EXPECT_NE(nullptr, dynamic_cast<Execute::Replace *>(parser.Build(value_size).get()));
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("delete foo\r\n", consumed));
+    EXPECT_EQ("foo", dynamic_cast<Execute::Delete &>(*parser.Build(value_size)).key());
+    EXPECT_EQ(0, value_size);
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("incr foo 18446744073709551615\r\n", consumed));
+    EXPECT_EQ(18446744073709551615ull, dynamic_cast<Execute::Incr &>(*parser.Build(value_size)).delta());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("decr foo 5\r\n", consumed));
+    EXPECT_EQ(5, dynamic_cast<Execute::Decr &>(*parser.Build(value_size)).delta());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("touch foo 100\r\n", consumed));
+    EXPECT_EQ(100, dynamic_cast<Execute::Touch &>(*parser.Build(value_size)).expire());
+
+    parser.Reset();
+    EXPECT_THROW(parser.Parse("incr foo -1\r\n", consumed), std::runtime_error);
+    parser.Reset();
+    EXPECT_THROW(parser.Parse("cas foo 1 2 3\r\n", consumed), std::runtime_error);
+    parser.Reset();
+    EXPECT_THROW(parser.Parse("touch foo\r\n", consumed), std::runtime_error);
+}
+
+TEST(MemcachedParserTest, NoReply) {
+    Protocol::Parser parser;
+    Backend::SimpleLRU storage;
+    Execute::Response out;
+    size_t consumed = 0, value_size = 0;
+
+    ASSERT_TRUE(parser.Parse("set foo 0 0 6 noreply\r\n", consumed));
+    EXPECT_TRUE(parser.NoReply());
+    EXPECT_EQ("foo", parser.Keys()[0].str());
+    parser.Build(value_size)->Execute(storage, "fooval", out);
+    EXPECT_EQ(6, value_size);
+    EXPECT_TRUE(out.Empty());
+
+    // Failures are not reported either
+    const char *updates[] = {"add foo 0 0 1 noreply\r\n", "cas foo 0 0 1 1 noreply\r\n", "incr foo 1 noreply\r\n",
+                             "touch foo 10 noreply\r\n", "delete bar noreply\r\n", "delete foo noreply\r\n"};
+    for (const char *update : updates) {
+        parser.Reset();
+        ASSERT_TRUE(parser.Parse(update, consumed)) << update;
+        EXPECT_TRUE(parser.NoReply());
+        parser.Build(value_size)->Execute(storage, "x", out);
+        EXPECT_TRUE(out.Empty()) << update;
+    }
+    std::string value;
+    EXPECT_FALSE(storage.Get("foo", value));
+
+    // Flag doesn't outlive the command, get takes it as a key
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("get noreply\r\n", consumed));
+    EXPECT_FALSE(parser.NoReply());
+    EXPECT_EQ("noreply", parser.Keys()[0].str());
+    parser.Build(value_size)->Execute(storage, "", out);
+    EXPECT_EQ("END\r\n", out.str());
+
+    parser.Reset();
+    EXPECT_THROW(parser.Parse("set foo 0 0 6 reply\r\n", consumed), std::runtime_error);
+    parser.Reset();
+    EXPECT_THROW(parser.Parse("delete noreply\r\n", consumed), std::runtime_error);
+}
+
+TEST(MemcachedParserTest, Errors) {
+    Protocol::Parser parser;
+    size_t consumed = 0;
+
+    EXPECT_THROW(parser.Parse("sett foo 0 0 6\r\n", consumed), std::runtime_error);
+    parser.Reset();
+    EXPECT_THROW(parser.Parse("get\r\n", consumed), std::runtime_error);
+    parser.Reset();
+    EXPECT_THROW(parser.Parse("set foo 4294967296 0 6\r\n", consumed), std::runtime_error);
+    parser.Reset();
+    EXPECT_THROW(parser.Parse("set foo 0 0 6x\r\n", consumed), std::runtime_error);
+    parser.Reset();
+    EXPECT_THROW(parser.Parse("set foo 0 0\r\n", consumed), std::runtime_error);
+    parser.Reset();
+    EXPECT_THROW(parser.Parse(std::string(Protocol::Parser::max_line + 1, 'a'), consumed), std::runtime_error);
+
+    // Limits are still fine
+    parser.Reset();
+    EXPECT_TRUE(parser.Parse("set foo 4294967295 -2147483648 6\r\n", consumed));
+}
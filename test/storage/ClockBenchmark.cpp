@@ -0,0 +1,35 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <string>
+
+#include "storage/ClockLRU.h"
+#include "storage/SimpleLRU.h"
+#include "storage/StripedLockLRU.h"
+
+#include "Trace.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+// Reports hit ratio and speed on zipfian traces
+TEST(ClockBenchmark, Zipf) {
+    const size_t keys = 100000, length = 1000000;
+    const string value(100, 'v');
+
+    for (double skew : {0.8, 0.99, 1.2}) {
+        auto trace = zipf_trace(keys, length, skew);
+        // Cache keeps about 10% of keys
+        size_t size = keys / 10 * (value.size() + 10);
+
+        SimpleLRU lru(size);
+        StripedLockLRU striped(size, 4);
+        ClockLRU clock(size);
+        auto r_lru = replay(lru, trace, value);
+        auto r_striped = replay(striped, trace, value);
+        auto r_clock = replay(clock, trace, value);
+
+        cerr << "zipf " << skew << ": st_lru hits " << r_lru.hit_ratio << " " << r_lru.ns_per_op << " ns/op"
+             << ", striped_lru hits " << r_striped.hit_ratio << " " << r_striped.ns_per_op << " ns/op"
+             << ", clock hits " << r_clock.hit_ratio << " " << r_clock.ns_per_op << " ns/op" << endl;
+    }
+}
@@ -0,0 +1,82 @@
+#include "gtest/gtest.h"
+#include <string>
+
+#include "storage/ClockLRU.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+TEST(ClockTest, PutGetDelete) {
+    ClockLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY2", "other"));
+    EXPECT_TRUE(storage.Set("KEY1", "val11"));
+    EXPECT_FALSE(storage.Set("KEY3", "val3"));
+
+    string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val11", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val2", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+}
+
+TEST(ClockTest, ReferencedSurvive) {
+    // Room for 4 items of 8 bytes
+    ClockLRU storage(32);
+
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(storage.Put("Key" + to_string(i), "Val" + to_string(i)));
+    }
+
+    string value;
+    EXPECT_TRUE(storage.Get("Key0", value));
+    EXPECT_TRUE(storage.Get("Key2", value));
+    EXPECT_TRUE(storage.Put("Key4", "Val4"));
+    EXPECT_TRUE(storage.Put("Key5", "Val5"));
+
+    EXPECT_TRUE(storage.Get("Key0", value));
+    EXPECT_TRUE(storage.Get("Key2", value));
+    EXPECT_FALSE(storage.Get("Key1", value));
+    EXPECT_FALSE(storage.Get("Key3", value));
+    EXPECT_TRUE(storage.Get("Key4", value));
+    EXPECT_TRUE(storage.Get("Key5", value));
+}
+
+TEST(ClockTest, SetDoesNotEvictItself) {
+    ClockLRU storage(32);
+
+    EXPECT_TRUE(storage.Put("Key0", "Val0"));
+    EXPECT_TRUE(storage.Put("Key1", "Val1"));
+    EXPECT_TRUE(storage.Set("Key0", string(28, 'a')));
+
+    string value;
+    EXPECT_TRUE(storage.Get("Key0", value));
+    EXPECT_EQ(string(28, 'a'), value);
+    EXPECT_FALSE(storage.Get("Key1", value));
+}
+
+TEST(ClockTest, MaxTest) {
+    ClockLRU storage(2 * 1000 * 10);
+
+    for (int i = 0; i < 100000; i++) {
+        string key = "Key " + to_string(i);
+        key.resize(10, ' ');
+        string val = "Val " + to_string(i);
+        val.resize(10, ' ');
+        EXPECT_TRUE(storage.Put(key, val));
+    }
+
+    // Without reads the hand evicts in insertion order
+    string value;
+    for (int i = 99000; i < 100000; i++) {
+        string key = "Key " + to_string(i);
+        key.resize(10, ' ');
+        EXPECT_TRUE(storage.Get(key, value));
+    }
+}
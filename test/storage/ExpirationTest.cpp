@@ -0,0 +1,249 @@
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+#include "storage/ClockLRU.h"
+#include "storage/CompactLRU.h"
+#include "storage/SharedLockLRU.h"
+#include "storage/SimpleLRU.h"
+#include "storage/StripedLockLRU.h"
+#include "storage/ThreadSafeCompactLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TimingWheel.h"
+#include "storage/TinyLFU.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+static uint32_t fake_now = 1000;
+static uint32_t fake_clock() { return fake_now; }
+
+struct test_timer : public TimingWheel::timer {
+    int id;
+};
+
+TEST(TimingWheelTest, ExpiresInOrder) {
+    TimingWheel wheel(100);
+    vector<test_timer> timers(5);
+    uint32_t deadlines[] = {101, 150, 100 + 64 * 3, 100 + 4096 * 2, 100 + 300000};
+    for (int i = 0; i < 5; i++) {
+        timers[i].id = i;
+        wheel.schedule(timers[i], deadlines[i]);
+    }
+
+    for (int i = 0; i < 5; i++) {
+        vector<int> fired;
+        auto collect = [&fired](TimingWheel::timer &t) { fired.push_back(static_cast<test_timer &>(t).id); };
+        EXPECT_EQ(0, wheel.advance(deadlines[i] - 1, 10, collect));
+        EXPECT_EQ(1, wheel.advance(deadlines[i], 10, collect));
+        ASSERT_EQ(1, fired.size());
+        EXPECT_EQ(i, fired[0]);
+        EXPECT_FALSE(timers[i].scheduled());
+    }
+}
+
+TEST(TimingWheelTest, CancelAndBudget) {
+    TimingWheel wheel(0);
+    vector<test_timer> timers(10);
+    for (auto &t : timers) {
+        wheel.schedule(t, 5);
+    }
+    wheel.cancel(timers[0]);
+    EXPECT_FALSE(timers[0].scheduled());
+
+    size_t fired = 0;
+    auto count = [&fired](TimingWheel::timer &) { fired++; };
+    EXPECT_EQ(4, wheel.advance(10, 4, count));
+    EXPECT_EQ(5, wheel.advance(10, 100, count));
+    EXPECT_EQ(9, fired);
+}
+
+TEST(ExpirationTest, HiddenAfterDeadline) {
+    SimpleLRU storage;
+    storage.SetClock(&fake_clock);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1", 0, 10));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY3", "val3", 0, 20));
+
+    string value;
+    fake_now += 10;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_FALSE(storage.Set("KEY1", "val11"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY1", "val11"));
+
+    // Update without ttl makes item permanent
+    EXPECT_TRUE(storage.Set("KEY3", "val33"));
+    fake_now += 100;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_EQ("val33", value);
+}
+
+TEST(ExpirationTest, TouchAndUpdatesKeepTtl) {
+    SimpleLRU storage;
+    storage.SetClock(&fake_clock);
+
+    EXPECT_TRUE(storage.Put("KEY1", "1", 0, 10));
+    EXPECT_TRUE(storage.Put("KEY2", "val2", 0, 10));
+    EXPECT_TRUE(storage.Put("KEY3", "val3", 0, 10));
+    EXPECT_FALSE(storage.Touch("KEY4", 10));
+
+    // Touch moves deadline, updates in place keep it
+    EXPECT_TRUE(storage.Touch("KEY1", 30));
+    EXPECT_TRUE(storage.Touch("KEY2", 0));
+    uint64_t number;
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, storage.Increment("KEY1", 1, number));
+    EXPECT_TRUE(storage.Append("KEY3", "3"));
+
+    string value;
+    fake_now += 10;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("2", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_FALSE(storage.Get("KEY3", value));
+
+    fake_now += 20;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+}
+
+TEST(ExpirationTest, NegativeTtl) {
+    SimpleLRU storage;
+    EXPECT_TRUE(storage.Put("KEY1", "val1", 0, -1));
+
+    string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+}
+
+TEST(ExpirationTest, ReapFreesSpace) {
+    SimpleLRU storage(100);
+    storage.SetClock(&fake_clock);
+
+    // Expired items get removed before anything else
+    for (int i = 0; i < 9; i++) {
+        EXPECT_TRUE(storage.Put("KEY" + to_string(i), "val" + to_string(i), 0, 5));
+    }
+    EXPECT_TRUE(storage.Put("LAST", "value"));
+    fake_now += 5;
+    EXPECT_EQ(9, storage.ReapExpired(100));
+    EXPECT_EQ(0, storage.ReapExpired(100));
+
+    string value;
+    EXPECT_TRUE(storage.Get("LAST", value));
+    EXPECT_EQ("value", value);
+}
+
+// Other backends expire the same way as SimpleLRU
+template <typename T> class BackendExpirationTest : public ::testing::Test {
+protected:
+    BackendExpirationTest() { storage.SetClock(&fake_clock); }
+    T storage;
+};
+
+typedef ::testing::Types<CompactLRU, SharedLockLRU, ClockLRU, TinyLFU> ExpiringBackends;
+TYPED_TEST_CASE(BackendExpirationTest, ExpiringBackends);
+
+TYPED_TEST(BackendExpirationTest, HiddenAfterDeadline) {
+    EXPECT_TRUE(this->storage.Put("KEY1", "val1", 0, 10));
+    EXPECT_TRUE(this->storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(this->storage.PutIfAbsent("KEY3", "val3", 0, 20));
+
+    string value;
+    fake_now += 10;
+    EXPECT_FALSE(this->storage.Get("KEY1", value));
+    EXPECT_TRUE(this->storage.Get("KEY2", value));
+    EXPECT_TRUE(this->storage.Get("KEY3", value));
+    EXPECT_FALSE(this->storage.Set("KEY1", "val11"));
+    EXPECT_TRUE(this->storage.PutIfAbsent("KEY1", "val11"));
+
+    EXPECT_TRUE(this->storage.Set("KEY3", "val33"));
+    fake_now += 100;
+    EXPECT_TRUE(this->storage.Get("KEY1", value));
+    EXPECT_TRUE(this->storage.Get("KEY3", value));
+    EXPECT_EQ("val33", value);
+}
+
+TYPED_TEST(BackendExpirationTest, Touch) {
+    EXPECT_TRUE(this->storage.Put("KEY1", "val1", 0, 10));
+    EXPECT_TRUE(this->storage.Put("KEY2", "val2", 0, 10));
+    EXPECT_FALSE(this->storage.Touch("KEY3", 10));
+    EXPECT_TRUE(this->storage.Touch("KEY1", 30));
+    EXPECT_TRUE(this->storage.Touch("KEY2", 0));
+
+    string value;
+    fake_now += 10;
+    EXPECT_TRUE(this->storage.Get("KEY1", value));
+    EXPECT_TRUE(this->storage.Get("KEY2", value));
+    fake_now += 20;
+    EXPECT_FALSE(this->storage.Get("KEY1", value));
+    EXPECT_FALSE(this->storage.Touch("KEY1", 10));
+    EXPECT_TRUE(this->storage.Get("KEY2", value));
+}
+
+TYPED_TEST(BackendExpirationTest, UpdatesKeepTtl) {
+    EXPECT_TRUE(this->storage.Put("KEY1", "1", 0, 10));
+    EXPECT_TRUE(this->storage.Put("KEY2", "val2", 0, 10));
+
+    uint64_t number;
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, this->storage.Increment("KEY1", 1, number));
+    EXPECT_TRUE(this->storage.Append("KEY2", "2"));
+
+    string value;
+    fake_now += 5;
+    EXPECT_TRUE(this->storage.Get("KEY1", value));
+    EXPECT_EQ("2", value);
+    fake_now += 5;
+    EXPECT_FALSE(this->storage.Get("KEY1", value));
+    EXPECT_FALSE(this->storage.Get("KEY2", value));
+    EXPECT_EQ(Afina::Storage::UpdateResult::NotFound, this->storage.Decrement("KEY1", 1, number));
+}
+
+TYPED_TEST(BackendExpirationTest, NegativeTtl) {
+    EXPECT_TRUE(this->storage.Put("KEY1", "val1", 0, -1));
+
+    string value;
+    EXPECT_FALSE(this->storage.Get("KEY1", value));
+    EXPECT_FALSE(this->storage.Delete("KEY1"));
+}
+
+TYPED_TEST(BackendExpirationTest, Reap) {
+    // Enough items to make ClockLRU move its array while timers are scheduled
+    for (int i = 0; i < 40; i++) {
+        EXPECT_TRUE(this->storage.Put("KEY" + to_string(i), "val" + to_string(i), 0, 5));
+    }
+    EXPECT_TRUE(this->storage.Put("LAST", "value"));
+    fake_now += 5;
+    EXPECT_EQ(40, this->storage.ReapExpired(100));
+    EXPECT_EQ(0, this->storage.ReapExpired(100));
+
+    string value;
+    EXPECT_TRUE(this->storage.Get("LAST", value));
+    EXPECT_EQ("value", value);
+}
+
+TEST(ExpirationTest, ThreadSafeAndStriped) {
+    ThreadSafeSimplLRU simple;
+    StripedLockLRU striped(4096, 4);
+    ThreadSafeCompactLRU compact;
+    StripedCompactLRU striped_compact(1 << 16, 4);
+    SharedLockLRU shared;
+    StripedSharedLockLRU striped_shared(4096, 4);
+    for (Afina::Storage *storage : std::vector<Afina::Storage *>{&simple, &striped, &compact, &striped_compact,
+                                                                 &shared, &striped_shared}) {
+        storage->Start();
+        EXPECT_TRUE(storage->Put("KEY1", "val1", 0, -1));
+        EXPECT_TRUE(storage->Put("KEY2", "val2", 0, 1000));
+        EXPECT_TRUE(storage->PutIfAbsent("KEY1", "val11", 0, 1000));
+
+        string value;
+        EXPECT_TRUE(storage->Get("KEY1", value));
+        EXPECT_EQ("val11", value);
+        EXPECT_TRUE(storage->Set("KEY2", "val22", 0, -1));
+        EXPECT_FALSE(storage->Get("KEY2", value));
+        storage->Stop();
+    }
+}
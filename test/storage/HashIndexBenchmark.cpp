@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "storage/HashIndex.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+struct TestNode {
+    string key;
+    size_t hash;
+};
+
+struct TestNodeEqual {
+    bool operator()(const TestNode &node, const string &key) const { return node.key == key; }
+};
+
+using TestIndex = HashIndex<TestNode, TestNodeEqual>;
+
+static size_t std_hash(const string &key) { return std::hash<string>{}(key); }
+
+static vector<unique_ptr<TestNode>> make_nodes(size_t count) {
+    vector<unique_ptr<TestNode>> result;
+    for (size_t i = 0; i < count; i++) {
+        string key = "Key " + to_string(i);
+        result.emplace_back(new TestNode{key, std_hash(key)});
+    }
+    return result;
+}
+
+// Lookup cost compared with the std::map index SimpleLRU used to have
+TEST(HashIndexBenchmark, Lookup) {
+    const size_t count = 200000;
+    const size_t lookups = 1000000;
+    auto nodes = make_nodes(count);
+
+    map<reference_wrapper<const string>, reference_wrapper<TestNode>, less<string>> tree;
+    TestIndex index;
+    for (auto &n : nodes) {
+        tree.emplace(cref(n->key), ref(*n));
+        index.insert(n->hash, n.get());
+    }
+
+    mt19937 rnd(0);
+    uniform_int_distribution<size_t> dist(0, count - 1);
+    vector<const TestNode *> requests;
+    for (size_t i = 0; i < lookups; i++) {
+        requests.push_back(nodes[dist(rnd)].get());
+    }
+
+    size_t found = 0;
+    auto start = chrono::steady_clock::now();
+    for (auto r : requests) {
+        found += tree.find(r->key) != tree.end();
+    }
+    auto tree_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (auto r : requests) {
+        found += index.find(std_hash(r->key), r->key) != nullptr;
+    }
+    auto index_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(2 * lookups, found);
+    cerr << "lookup over " << count << " keys: std::map " << tree_ns / lookups << " ns/op, HashIndex "
+         << index_ns / lookups << " ns/op (hash included)" << endl;
+}
@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storage/HashIndex.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+struct TestNode {
+    string key;
+    size_t hash;
+};
+
+struct TestNodeEqual {
+    bool operator()(const TestNode &node, const string &key) const { return node.key == key; }
+};
+
+using TestIndex = HashIndex<TestNode, TestNodeEqual>;
+
+static vector<unique_ptr<TestNode>> make_nodes(size_t count, size_t (*hash)(const string &)) {
+    vector<unique_ptr<TestNode>> result;
+    for (size_t i = 0; i < count; i++) {
+        string key = "Key " + to_string(i);
+        size_t h = hash(key);
+        result.emplace_back(new TestNode{key, h});
+    }
+    return result;
+}
+
+static size_t std_hash(const string &key) { return std::hash<string>{}(key); }
+
+// All keys land into the same slot, index must still tell them apart
+static size_t bad_hash(const string &key) { return 42; }
+
+TEST(HashIndexTest, InsertFind) {
+    TestIndex index;
+    auto nodes = make_nodes(1000, std_hash);
+    for (auto &n : nodes) {
+        index.insert(n->hash, n.get());
+    }
+    EXPECT_EQ(1000, index.size());
+
+    for (auto &n : nodes) {
+        EXPECT_EQ(n.get(), index.find(n->hash, n->key));
+    }
+    EXPECT_EQ(nullptr, index.find(std_hash("absent"), "absent"));
+}
+
+TEST(HashIndexTest, EraseKeepsOthers) {
+    TestIndex index;
+    auto nodes = make_nodes(1000, std_hash);
+    for (auto &n : nodes) {
+        index.insert(n->hash, n.get());
+    }
+
+    for (size_t i = 0; i < nodes.size(); i += 2) {
+        EXPECT_EQ(nodes[i].get(), index.erase(nodes[i]->hash, nodes[i]->key));
+    }
+    for (size_t i = 1; i < nodes.size(); i += 4) {
+        EXPECT_TRUE(index.erase(nodes[i]->hash, nodes[i].get()));
+    }
+    EXPECT_EQ(250, index.size());
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+        TestNode *expected = (i % 4 == 3) ? nodes[i].get() : nullptr;
+        EXPECT_EQ(expected, index.find(nodes[i]->hash, nodes[i]->key));
+    }
+}
+
+TEST(HashIndexTest, Collisions) {
+    TestIndex index;
+    auto nodes = make_nodes(100, bad_hash);
+    for (auto &n : nodes) {
+        index.insert(n->hash, n.get());
+    }
+
+    EXPECT_EQ(nodes[50].get(), index.erase(42, nodes[50]->key));
+    EXPECT_EQ(nullptr, index.find(42, nodes[50]->key));
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (i != 50) {
+            EXPECT_EQ(nodes[i].get(), index.find(42, nodes[i]->key));
+        }
+    }
+}
+
+TEST(HashIndexTest, Replace) {
+    TestIndex index;
+    TestNode a{"key", std_hash("key")};
+    TestNode b{"key", std_hash("key")};
+
+    index.insert(a.hash, &a);
+    EXPECT_TRUE(index.replace(a.hash, &a, &b));
+    EXPECT_EQ(&b, index.find(a.hash, "key"));
+    EXPECT_FALSE(index.replace(a.hash, &a, &b));
+}
@@ -0,0 +1,49 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/SharedLockLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+template <typename Storage> static double read_throughput(Storage &storage, size_t threads, size_t ops) {
+    auto start = chrono::steady_clock::now();
+    vector<thread> readers;
+    for (size_t t = 0; t < threads; t++) {
+        readers.emplace_back([&storage, ops, t]() {
+            std::string value;
+            for (size_t i = 0; i < ops; i++) {
+                storage.Get("Key " + std::to_string((i * 7 + t) % 1000), value);
+            }
+        });
+    }
+    for (auto &r : readers) {
+        r.join();
+    }
+    auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    return double(threads * ops) / ns * 1000;
+}
+
+// Compares Get throughput of exclusive and shared locking
+TEST(SharedLockBenchmark, Read) {
+    ThreadSafeSimplLRU exclusive(1 << 20);
+    SharedLockLRU shared(1 << 20);
+    for (int i = 0; i < 1000; i++) {
+        exclusive.Put("Key " + std::to_string(i), "Val " + std::to_string(i));
+        shared.Put("Key " + std::to_string(i), "Val " + std::to_string(i));
+    }
+
+    const size_t ops = 200000;
+    size_t max_threads = max(4u, thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double ex = read_throughput(exclusive, threads, ops);
+        double sh = read_throughput(shared, threads, ops);
+        cerr << threads << " readers: mt_lru " << ex << " Mops/s, rw_lru " << sh << " Mops/s" << endl;
+    }
+}
@@ -1,7 +1,11 @@
 #include "gtest/gtest.h"
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <set>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
 #include <afina/execute/Add.h>
@@ -10,7 +14,14 @@
 #include <afina/execute/Get.h>
 #include <afina/execute/Set.h>
 
+#include "storage/ClockLRU.h"
+#include "storage/CompactLRU.h"
+#include "storage/SharedLockLRU.h"
 #include "storage/SimpleLRU.h"
+#include "storage/StripedLockLRU.h"
+#include "storage/ThreadSafeCompactLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TinyLFU.h"
 
 using namespace Afina::Backend;
 using namespace Afina::Execute;
@@ -195,3 +206,650 @@ TEST(StorageTest, MaxTest) {
         EXPECT_FALSE(storage.Get(key, res));
     }
 }
+
+TEST(CompactStorageTest, PutGetOverwrite) {
+    CompactLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Put("KEY1", "value1"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY2", "value2"));
+    EXPECT_TRUE(storage.Set("KEY2", "val3"));
+    EXPECT_FALSE(storage.Set("KEY3", "val3"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "value1");
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(value == "val3");
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_EQ(storage.item_size(4, 4), storage.size());
+}
+
+TEST(CompactStorageTest, MaxTest) {
+    // Arena is cut into 16 pages, capacity is a multiple of that so that no page has unused tail
+    const size_t length = 20, capacity = 1024;
+    const size_t item_size = CompactLRU(1 << 20).item_size(length, length);
+    CompactLRU storage(capacity * item_size);
+
+    for (long i = 0; i < capacity + 100; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        auto val = pad_space("Val " + std::to_string(i), length);
+        EXPECT_TRUE(storage.Put(key, val));
+    }
+
+    // Recently used item must survive next eviction
+    std::string res;
+    EXPECT_TRUE(storage.Get(pad_space("Key 100", length), res));
+    EXPECT_TRUE(storage.Put(pad_space("Key " + std::to_string(capacity + 100), length),
+                            pad_space("Val " + std::to_string(capacity + 100), length)));
+    EXPECT_TRUE(storage.Get(pad_space("Key 100", length), res));
+    EXPECT_FALSE(storage.Get(pad_space("Key 101", length), res));
+
+    for (long i = 0; i < 100; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        EXPECT_FALSE(storage.Get(key, res));
+    }
+
+    for (long i = 102; i < capacity + 101; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        auto val = pad_space("Val " + std::to_string(i), length);
+        EXPECT_TRUE(storage.Get(key, res));
+        EXPECT_TRUE(val == res);
+    }
+    EXPECT_EQ(capacity * item_size, storage.size());
+}
+
+TEST(CompactStorageTest, ItemTooLarge) {
+    // 16 pages of 1 KB
+    CompactLRU storage(16 << 10);
+
+    EXPECT_TRUE(storage.Put("KEY1", std::string(100, 'a')));
+    EXPECT_FALSE(storage.Put("KEY2", std::string(1024, 'b')));
+    EXPECT_TRUE(storage.Put("KEY3", std::string(900, 'c')));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_EQ(std::string(900, 'c'), value);
+}
+
+TEST(CompactStorageTest, AlternatingSizes) {
+    CompactLRU storage(1 << 20);
+
+    // Items of different classes get pages of their own instead of evicting each other
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(storage.Put("small" + std::to_string(i), std::string(10, 's')));
+        EXPECT_TRUE(storage.Put("large" + std::to_string(i), std::string(2000, 'l')));
+    }
+
+    // Same for the value of one item changing its class back and forth
+    for (int i = 0; i < 100; i++) {
+        std::string value(i % 2 == 0 ? 3000 : 5, 'a' + i % 26);
+        EXPECT_TRUE(storage.Put("changing", value));
+        std::string stored;
+        EXPECT_TRUE(storage.Get("changing", stored));
+        EXPECT_EQ(value, stored);
+    }
+
+    std::string value;
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(storage.Get("small" + std::to_string(i), value));
+        EXPECT_EQ(std::string(10, 's'), value);
+        EXPECT_TRUE(storage.Get("large" + std::to_string(i), value));
+        EXPECT_EQ(std::string(2000, 'l'), value);
+    }
+}
+
+TEST(StripedStorageTest, ShardsCount) {
+    EXPECT_EQ(8, StripedLockLRU(1 << 20, 8).shards());
+    EXPECT_EQ(1, StripedLockLRU(1 << 20, 1).shards());
+    EXPECT_THROW(StripedLockLRU(1 << 20, 5), std::invalid_argument);
+    EXPECT_THROW(StripedLockLRU(1024, 8), std::invalid_argument);
+
+    // By default 4 shards per core, but each keeps some reasonable amount of data
+    EXPECT_EQ(4, StripedLockLRU(1024).shards());
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    EXPECT_LE(4 * cores, StripedLockLRU(64 << 20).shards());
+}
+
+TEST(StripedStorageTest, PutGetDelete) {
+    StripedCompactLRU storage(1 << 20, 16);
+
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), "Val " + std::to_string(i)));
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        EXPECT_TRUE(storage.Delete("Key " + std::to_string(i)));
+    }
+
+    std::string value;
+    for (int i = 0; i < 1000; i++) {
+        if (i % 2 == 0) {
+            EXPECT_FALSE(storage.Get("Key " + std::to_string(i), value));
+        } else {
+            EXPECT_TRUE(storage.Get("Key " + std::to_string(i), value));
+            EXPECT_EQ("Val " + std::to_string(i), value);
+        }
+    }
+}
+
+TEST(ItemViewTest, OutlivesUpdate) {
+    StripedLockLRU storage(1024, 2);
+    EXPECT_TRUE(storage.Put("KEY1", "val1", 5, 0));
+
+    Afina::ItemView view;
+    EXPECT_TRUE(storage.Get("KEY1", view));
+    EXPECT_EQ(5, view.header.flags);
+    EXPECT_EQ("val1", std::string(view.value.get(), view.header.size));
+
+    // View keeps old value while storage moves on
+    EXPECT_TRUE(storage.Put("KEY1", "other", 0, 0));
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_EQ("val1", std::string(view.value.get(), view.header.size));
+
+    EXPECT_FALSE(storage.Get("KEY1", view));
+    EXPECT_EQ("val1", std::string(view.value.get(), view.header.size));
+}
+
+TEST(ItemViewTest, DefaultCopies) {
+    CompactLRU storage;
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+
+    Afina::ItemView view;
+    EXPECT_TRUE(static_cast<Afina::Storage &>(storage).Get("KEY1", view));
+    EXPECT_EQ(0, view.header.flags);
+    EXPECT_EQ("val1", std::string(view.value.get(), view.header.size));
+}
+
+TEST(AtomicUpdateTest, AppendPrependKeepFlags) {
+    SimpleLRU storage(64);
+    EXPECT_TRUE(storage.Put("KEY1", "val", 7, 0));
+    EXPECT_TRUE(storage.Append("KEY1", "ue"));
+    EXPECT_TRUE(storage.Prepend("KEY1", "the "));
+    EXPECT_FALSE(storage.Append("KEY2", "x"));
+    EXPECT_FALSE(storage.Prepend("KEY2", "x"));
+
+    Afina::ItemView view;
+    EXPECT_TRUE(storage.Get("KEY1", view));
+    EXPECT_EQ(7, view.header.flags);
+    EXPECT_EQ("the value", std::string(view.value.get(), view.header.size));
+
+    // Value that doesn't fit is not stored
+    EXPECT_FALSE(storage.Append("KEY1", std::string(64, 'x')));
+    EXPECT_TRUE(storage.Get("KEY1", view));
+    EXPECT_EQ(9, view.header.size);
+}
+
+TEST(AtomicUpdateTest, IncrementDecrement) {
+    StripedLockLRU storage(1024, 2);
+    uint64_t value = 0;
+    EXPECT_EQ(Afina::Storage::UpdateResult::NotFound, storage.Increment("KEY1", 1, value));
+
+    EXPECT_TRUE(storage.Put("KEY1", "10", 3, 0));
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, storage.Increment("KEY1", 5, value));
+    EXPECT_EQ(15, value);
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, storage.Decrement("KEY1", 20, value));
+    EXPECT_EQ(0, value);
+
+    EXPECT_TRUE(storage.Put("KEY1", "18446744073709551615"));
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, storage.Increment("KEY1", 2, value));
+    EXPECT_EQ(1, value);
+
+    std::string stored;
+    EXPECT_TRUE(storage.Get("KEY1", stored));
+    EXPECT_EQ("1", stored);
+
+    EXPECT_TRUE(storage.Put("KEY2", "12a"));
+    EXPECT_EQ(Afina::Storage::UpdateResult::NotNumber, storage.Increment("KEY2", 1, value));
+    EXPECT_TRUE(storage.Put("KEY2", "18446744073709551616"));
+    EXPECT_EQ(Afina::Storage::UpdateResult::NotNumber, storage.Decrement("KEY2", 1, value));
+}
+
+TEST(AtomicUpdateTest, CompareAndSwap) {
+    ThreadSafeSimplLRU storage;
+    EXPECT_EQ(Afina::Storage::UpdateResult::NotFound, storage.CompareAndSwap("KEY1", "val", 0, 0, 1));
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    Afina::ItemView view;
+    EXPECT_TRUE(storage.Get("KEY1", view));
+    uint64_t cas = view.header.cas;
+
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, storage.CompareAndSwap("KEY1", "val2", 4, 0, cas));
+    EXPECT_EQ(Afina::Storage::UpdateResult::Exists, storage.CompareAndSwap("KEY1", "val3", 0, 0, cas));
+
+    EXPECT_TRUE(storage.Get("KEY1", view));
+    EXPECT_EQ(4, view.header.flags);
+    EXPECT_NE(cas, view.header.cas);
+    EXPECT_EQ("val2", std::string(view.value.get(), view.header.size));
+}
+
+TEST(AtomicUpdateTest, CompactCompareAndSwap) {
+    ThreadSafeCompactLRU storage;
+    Afina::Storage &base = storage;
+    EXPECT_EQ(Afina::Storage::UpdateResult::NotFound, base.CompareAndSwap("KEY1", "val", 0, 0, 1));
+    EXPECT_TRUE(base.Put("KEY1", "0", 5, 0));
+
+    // Each round reads the version and retries until nobody else updated the value in between
+    const int threads = 4, rounds = 2000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&base]() {
+            for (int i = 0; i < rounds; i++) {
+                Afina::Storage::UpdateResult result;
+                do {
+                    Afina::ItemView view;
+                    ASSERT_TRUE(base.Get("KEY1", view));
+                    int number = std::stoi(std::string(view.value.get(), view.header.size));
+                    result = base.CompareAndSwap("KEY1", std::to_string(number + 1), view.header.flags, 0,
+                                                 view.header.cas);
+                } while (result == Afina::Storage::UpdateResult::Exists);
+                EXPECT_EQ(Afina::Storage::UpdateResult::Stored, result);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    Afina::ItemView view;
+    EXPECT_TRUE(base.Get("KEY1", view));
+    EXPECT_EQ(5, view.header.flags);
+    EXPECT_EQ(std::to_string(threads * rounds), std::string(view.value.get(), view.header.size));
+    EXPECT_EQ(Afina::Storage::UpdateResult::Exists, base.CompareAndSwap("KEY1", "val", 0, 0, view.header.cas + 1));
+}
+
+TEST(AtomicUpdateTest, ConcurrentIncrements) {
+    StripedLockLRU storage(1024, 2);
+    EXPECT_TRUE(storage.Put("counter", "0"));
+
+    const int threads = 4, rounds = 10000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&storage]() {
+            uint64_t value;
+            for (int i = 0; i < rounds; i++) {
+                storage.Increment("counter", 1, value);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("counter", value));
+    EXPECT_EQ(std::to_string(threads * rounds), value);
+}
+
+TEST(AtomicUpdateTest, SharedLockConcurrentUpdates) {
+    SharedLockLRU shared(1 << 20);
+    StripedSharedLockLRU striped(1 << 20, 4);
+    for (Afina::Storage *storage : std::vector<Afina::Storage *>{&shared, &striped}) {
+        EXPECT_TRUE(storage->Put("counter", "0"));
+        EXPECT_TRUE(storage->Put("log", ""));
+
+        const int threads = 4, rounds = 2000;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([storage]() {
+                uint64_t value;
+                for (int i = 0; i < rounds; i++) {
+                    storage->Increment("counter", 1, value);
+                    storage->Append("log", "x");
+                }
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+
+        std::string value;
+        EXPECT_TRUE(storage->Get("counter", value));
+        EXPECT_EQ(std::to_string(threads * rounds), value);
+        EXPECT_TRUE(storage->Get("log", value));
+        EXPECT_EQ(threads * rounds, value.size());
+    }
+}
+
+TEST(AtomicUpdateTest, InPlaceKeepsViews) {
+    SimpleLRU storage(64);
+    EXPECT_TRUE(storage.Put("KEY1", "val", 7, 0));
+
+    // Value pinned by the view is copied, the view keeps the old one
+    Afina::ItemView view;
+    EXPECT_TRUE(storage.Get("KEY1", view));
+    EXPECT_TRUE(storage.Append("KEY1", "ue"));
+    EXPECT_EQ("val", std::string(view.value.get(), view.header.size));
+
+    // Once view is gone, value changes in place
+    view = Afina::ItemView();
+    EXPECT_TRUE(storage.Append("KEY1", "s"));
+    EXPECT_TRUE(storage.Prepend("KEY1", "5 "));
+    uint64_t value;
+    EXPECT_EQ(Afina::Storage::UpdateResult::NotNumber, storage.Increment("KEY1", 1, value));
+    EXPECT_TRUE(storage.Get("KEY1", view));
+    EXPECT_EQ("5 values", std::string(view.value.get(), view.header.size));
+    EXPECT_EQ(7, view.header.flags);
+
+    // Growing item evicts others but never itself
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Append("KEY1", std::string(48, 'x')));
+    std::string stored;
+    EXPECT_FALSE(storage.Get("KEY2", stored));
+    EXPECT_TRUE(storage.Get("KEY1", stored));
+    EXPECT_EQ("5 values" + std::string(48, 'x'), stored);
+}
+
+TEST(AtomicUpdateTest, CompactGrowsInPlace) {
+    // Few pages, so that item could move to another one. Smallest chunk leaves room for the small updates
+    // whatever the header size is
+    CompactLRU storage(4 << 20, 128);
+    EXPECT_TRUE(storage.Put("KEY1", "1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.Append("KEY3", "x"));
+
+    // Small updates stay in the same chunk
+    uint64_t value;
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, storage.Increment("KEY1", 9, value));
+    EXPECT_EQ(10, value);
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, storage.Decrement("KEY1", 3, value));
+    EXPECT_EQ(7, value);
+    EXPECT_EQ(Afina::Storage::UpdateResult::NotNumber, storage.Increment("KEY2", 1, value));
+    EXPECT_TRUE(storage.Append("KEY2", "a"));
+    EXPECT_TRUE(storage.Prepend("KEY2", "p"));
+    EXPECT_EQ(storage.item_size(4, 1) + storage.item_size(4, 4), storage.size());
+
+    // Large ones move item to the bigger chunk
+    EXPECT_TRUE(storage.Append("KEY2", std::string(200, 'x')));
+    EXPECT_TRUE(storage.Prepend("KEY2", std::string(300, 'y')));
+    EXPECT_EQ(storage.item_size(4, 1) + storage.item_size(4, 506), storage.size());
+
+    std::string stored;
+    EXPECT_TRUE(storage.Get("KEY1", stored));
+    EXPECT_EQ("7", stored);
+    EXPECT_TRUE(storage.Get("KEY2", stored));
+    EXPECT_EQ(std::string(300, 'y') + "pval2a" + std::string(200, 'x'), stored);
+
+    // Item too large to be stored is kept as is
+    EXPECT_FALSE(storage.Append("KEY2", std::string(2 << 20, 'z')));
+    EXPECT_TRUE(storage.Get("KEY2", stored));
+    EXPECT_EQ(506, stored.size());
+}
+
+TEST(AtomicUpdateTest, CompactGrowthEvicts) {
+    const size_t item_size = CompactLRU(1 << 20).item_size(5, 4);
+    // Arena of a single page
+    CompactLRU storage(1024);
+
+    // Fill the arena with small items
+    int count = 0;
+    while (storage.size() + item_size <= 1024 && storage.Put("K" + std::to_string(1000 + count), "vals")) {
+        count++;
+    }
+    ASSERT_GT(count, 2);
+
+    // Growing the oldest one evicts others, but not the item itself, even if its page is the only one
+    EXPECT_TRUE(storage.Append("K1000", std::string(600, 'x')));
+    std::string stored;
+    EXPECT_TRUE(storage.Get("K1000", stored));
+    EXPECT_EQ("vals" + std::string(600, 'x'), stored);
+    EXPECT_FALSE(storage.Get("K1001", stored));
+}
+
+// Storage implementing only what Afina::Storage requires and flags, updates are left to defaults
+class MapStorage : public Afina::Storage {
+public:
+    bool Put(const std::string &key, const std::string &value) override { return Put(key, value, 0, 0); }
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        return PutIfAbsent(key, value, 0, 0);
+    }
+    bool Set(const std::string &key, const std::string &value) override { return Set(key, value, 0, 0); }
+    bool Delete(const std::string &key) override { return _items.erase(key) > 0; }
+    bool Get(const std::string &key, std::string &value) override {
+        auto it = _items.find(key);
+        if (it == _items.end()) {
+            return false;
+        }
+        value = it->second.second;
+        return true;
+    }
+
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        _items[key] = std::make_pair(flags, value);
+        return report_cas(stored_cas, 0, true);
+    }
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+                     uint64_t *stored_cas = nullptr) override {
+        return report_cas(stored_cas, 0, _items.insert(std::make_pair(key, std::make_pair(flags, value))).second);
+    }
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t ttl,
+             uint64_t *stored_cas = nullptr) override {
+        auto it = _items.find(key);
+        if (it == _items.end()) {
+            return false;
+        }
+        it->second = std::make_pair(flags, value);
+        return report_cas(stored_cas, 0, true);
+    }
+    bool Get(const std::string &key, const ItemReader &reader) override {
+        auto it = _items.find(key);
+        if (it == _items.end()) {
+            return false;
+        }
+        reader(Afina::ItemHeader{it->second.first, 0, it->second.second.size()}, it->second.second.data());
+        return true;
+    }
+
+private:
+    std::map<std::string, std::pair<uint32_t, std::string>> _items;
+};
+
+TEST(AtomicUpdateTest, DefaultEmulation) {
+    MapStorage storage;
+    Afina::Storage &base = storage;
+    EXPECT_TRUE(base.Put("KEY1", "5", 7, 0));
+    EXPECT_TRUE(base.Touch("KEY1", 10));
+    EXPECT_FALSE(base.Touch("KEY2", 10));
+    EXPECT_TRUE(base.Append("KEY1", "0"));
+    EXPECT_TRUE(base.Prepend("KEY1", "1"));
+
+    uint64_t value;
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, base.Increment("KEY1", 1, value));
+    EXPECT_EQ(151, value);
+
+    // Updates keep flags
+    uint32_t flags = 0;
+    auto read = [&flags](const Afina::ItemHeader &header, const char *) { flags = header.flags; };
+    EXPECT_TRUE(base.Get("KEY1", Afina::Storage::ItemReader(read)));
+    EXPECT_EQ(7, flags);
+
+    // Versions are not tracked, zero cas matches
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, base.CompareAndSwap("KEY1", "val", 0, 0, 0));
+    EXPECT_EQ(Afina::Storage::UpdateResult::Exists, base.CompareAndSwap("KEY1", "val", 0, 0, 1));
+    std::string stored;
+    EXPECT_TRUE(base.Get("KEY1", stored));
+    EXPECT_EQ("val", stored);
+}
+
+// Flags and versions are kept by every backend, not only by SimpleLRU
+template <typename T> class ItemMetadataTest : public ::testing::Test {
+protected:
+    T storage;
+
+    Afina::ItemHeader header(const std::string &key, std::string &value) {
+        Afina::ItemHeader result{0, 0, 0};
+        auto read = [&result, &value](const Afina::ItemHeader &item, const char *data) {
+            result = item;
+            value.assign(data, item.size);
+        };
+        EXPECT_TRUE(storage.Get(key, Afina::Storage::ItemReader(read)));
+        return result;
+    }
+};
+
+typedef ::testing::Types<CompactLRU, ThreadSafeCompactLRU, SharedLockLRU, ClockLRU, TinyLFU> MetadataBackends;
+TYPED_TEST_CASE(ItemMetadataTest, MetadataBackends);
+
+TYPED_TEST(ItemMetadataTest, FlagsAndCas) {
+    EXPECT_TRUE(this->storage.Put("KEY1", "val1", 7, 0));
+    EXPECT_TRUE(this->storage.PutIfAbsent("KEY2", "val2", 9, 0));
+    EXPECT_FALSE(this->storage.Get("KEY3", Afina::Storage::ItemReader([](const Afina::ItemHeader &, const char *) {
+        ADD_FAILURE() << "Reader called for absent key";
+    })));
+
+    std::string value;
+    Afina::ItemHeader first = this->header("KEY1", value);
+    EXPECT_EQ(7, first.flags);
+    EXPECT_NE(0, first.cas);
+    EXPECT_EQ("val1", value);
+    Afina::ItemHeader second = this->header("KEY2", value);
+    EXPECT_EQ(9, second.flags);
+    EXPECT_NE(first.cas, second.cas);
+
+    // Update replaces flags and gives new version
+    EXPECT_TRUE(this->storage.Set("KEY1", "val11", 3, 0));
+    Afina::ItemHeader updated = this->header("KEY1", value);
+    EXPECT_EQ(3, updated.flags);
+    EXPECT_NE(first.cas, updated.cas);
+    EXPECT_EQ(5, updated.size);
+    EXPECT_EQ("val11", value);
+
+    Afina::ItemView view;
+    EXPECT_TRUE(static_cast<Afina::Storage &>(this->storage).Get("KEY1", view));
+    EXPECT_EQ(3, view.header.flags);
+    EXPECT_EQ(updated.cas, view.header.cas);
+    EXPECT_EQ("val11", std::string(view.value.get(), view.header.size));
+}
+
+// Update reports version of the item it has stored, failed one leaves output as is
+TYPED_TEST(ItemMetadataTest, UpdatesReportCas) {
+    Afina::Storage &base = this->storage;
+    std::string value;
+    uint64_t cas = 0;
+    EXPECT_TRUE(base.Put("KEY1", "val", 7, 0, &cas));
+    EXPECT_EQ(this->header("KEY1", value).cas, cas);
+    EXPECT_TRUE(base.PutIfAbsent("KEY2", "41", 9, 0, &cas));
+    EXPECT_EQ(this->header("KEY2", value).cas, cas);
+    EXPECT_TRUE(base.Set("KEY1", "value", 7, 0, &cas));
+    EXPECT_EQ(this->header("KEY1", value).cas, cas);
+    EXPECT_TRUE(base.Append("KEY1", "s", &cas));
+    EXPECT_EQ(this->header("KEY1", value).cas, cas);
+    EXPECT_TRUE(base.Prepend("KEY1", "the ", &cas));
+    EXPECT_EQ(this->header("KEY1", value).cas, cas);
+
+    uint64_t number;
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, base.Increment("KEY2", 1, number, &cas));
+    EXPECT_EQ(this->header("KEY2", value).cas, cas);
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, base.Decrement("KEY2", 1, number, &cas));
+    EXPECT_EQ(this->header("KEY2", value).cas, cas);
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, base.CompareAndSwap("KEY2", "1", 0, 0, cas, &cas));
+    EXPECT_EQ(this->header("KEY2", value).cas, cas);
+
+    uint64_t untouched = 0;
+    EXPECT_FALSE(base.PutIfAbsent("KEY2", "x", 0, 0, &untouched));
+    EXPECT_FALSE(base.Set("KEY3", "x", 0, 0, &untouched));
+    EXPECT_FALSE(base.Append("KEY3", "x", &untouched));
+    EXPECT_EQ(Afina::Storage::UpdateResult::NotNumber, base.Increment("KEY1", 1, number, &untouched));
+    EXPECT_EQ(Afina::Storage::UpdateResult::Exists, base.CompareAndSwap("KEY2", "x", 0, 0, cas + 1, &untouched));
+    EXPECT_EQ(0, untouched);
+}
+
+TYPED_TEST(ItemMetadataTest, UpdatesKeepFlags) {
+    Afina::Storage &base = this->storage;
+    EXPECT_TRUE(base.Put("KEY1", "val", 7, 0));
+    EXPECT_TRUE(base.Put("KEY2", "41", 9, 0));
+    EXPECT_FALSE(base.Append("KEY3", "x"));
+    EXPECT_FALSE(base.Prepend("KEY3", "x"));
+
+    std::string value;
+    uint64_t cas = this->header("KEY1", value).cas;
+    EXPECT_TRUE(base.Append("KEY1", "ue"));
+    EXPECT_TRUE(base.Prepend("KEY1", "the "));
+    Afina::ItemHeader appended = this->header("KEY1", value);
+    EXPECT_EQ(7, appended.flags);
+    EXPECT_NE(cas, appended.cas);
+    EXPECT_EQ("the value", value);
+
+    uint64_t number;
+    cas = this->header("KEY2", value).cas;
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, base.Increment("KEY2", 1, number));
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, base.Decrement("KEY2", 50, number));
+    EXPECT_EQ(0, number);
+    EXPECT_EQ(Afina::Storage::UpdateResult::NotNumber, base.Increment("KEY1", 1, number));
+    EXPECT_EQ(Afina::Storage::UpdateResult::NotFound, base.Increment("KEY3", 1, number));
+    Afina::ItemHeader incremented = this->header("KEY2", value);
+    EXPECT_EQ(9, incremented.flags);
+    EXPECT_NE(cas, incremented.cas);
+    EXPECT_EQ("0", value);
+
+    // Version has changed since the value was read
+    EXPECT_EQ(Afina::Storage::UpdateResult::Exists, base.CompareAndSwap("KEY2", "1", 3, 0, cas));
+    EXPECT_EQ(Afina::Storage::UpdateResult::Stored, base.CompareAndSwap("KEY2", "1", 3, 0, incremented.cas));
+    EXPECT_EQ(Afina::Storage::UpdateResult::NotFound, base.CompareAndSwap("KEY3", "1", 3, 0, incremented.cas));
+    EXPECT_EQ(3, this->header("KEY2", value).flags);
+    EXPECT_EQ("1", value);
+}
+
+TEST(SharedLockStorageTest, PutGetDelete) {
+    SharedLockLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY2", "other"));
+    EXPECT_TRUE(storage.Set("KEY1", "val11"));
+    EXPECT_FALSE(storage.Set("KEY3", "val3"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val11", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val2", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+}
+
+TEST(SharedLockStorageTest, SecondChance) {
+    // Room for 4 items of 8 bytes
+    SharedLockLRU storage(32);
+
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(storage.Put("Key" + std::to_string(i), "Val" + std::to_string(i)));
+    }
+
+    // Oldest item was read, so the next one gets evicted instead
+    std::string value;
+    EXPECT_TRUE(storage.Get("Key0", value));
+    EXPECT_TRUE(storage.Put("Key4", "Val4"));
+    EXPECT_TRUE(storage.Get("Key0", value));
+    EXPECT_FALSE(storage.Get("Key1", value));
+
+    // Without reads order is the same as in LRU
+    EXPECT_TRUE(storage.Put("Key5", "Val5"));
+    EXPECT_FALSE(storage.Get("Key2", value));
+}
+
+TEST(SharedLockStorageTest, MaxTest) {
+    SharedLockLRU storage(2 * 1000 * 10);
+
+    for (int i = 0; i < 1100; i++) {
+        auto key = pad_space("Key " + std::to_string(i), 10);
+        auto val = pad_space("Val " + std::to_string(i), 10);
+        EXPECT_TRUE(storage.Put(key, val));
+    }
+
+    std::string res;
+    for (int i = 0; i < 100; i++) {
+        EXPECT_FALSE(storage.Get(pad_space("Key " + std::to_string(i), 10), res));
+    }
+    for (int i = 100; i < 1100; i++) {
+        EXPECT_TRUE(storage.Get(pad_space("Key " + std::to_string(i), 10), res));
+        EXPECT_EQ(pad_space("Val " + std::to_string(i), 10), res);
+    }
+}
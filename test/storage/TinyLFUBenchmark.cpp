@@ -0,0 +1,47 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "storage/SimpleLRU.h"
+#include "storage/TinyLFU.h"
+
+#include "Trace.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+// Compares hit ratio with plain LRU on zipf traces, and on the trace where hot set
+// is interrupted by a scan over keys never requested again
+TEST(TinyLFUBenchmark, HitRatio) {
+    const size_t keys = 100000, length = 1000000;
+    const string value(100, 'v');
+    size_t size = keys / 10 * (value.size() + 10);
+
+    for (double skew : {0.8, 0.99, 1.2}) {
+        auto trace = zipf_trace(keys, length, skew);
+        SimpleLRU lru(size);
+        TinyLFU lfu(size);
+        auto r_lru = replay(lru, trace, value);
+        auto r_lfu = replay(lfu, trace, value);
+        cerr << "zipf " << skew << ": st_lru hits " << r_lru.hit_ratio << " " << r_lru.ns_per_op << " ns/op"
+             << ", tinylfu hits " << r_lfu.hit_ratio << " " << r_lfu.ns_per_op << " ns/op" << endl;
+    }
+
+    auto before = zipf_trace(keys, length / 2, 0.99, 1);
+    auto after = zipf_trace(keys, length / 2, 0.99, 2);
+    vector<string> scan;
+    for (size_t i = 0; i < 2 * keys; i++) {
+        scan.push_back("Scan " + to_string(i));
+    }
+
+    SimpleLRU lru(size);
+    TinyLFU lfu(size);
+    replay(lru, before, value);
+    replay(lfu, before, value);
+    replay(lru, scan, value);
+    replay(lfu, scan, value);
+    auto r_lru = replay(lru, after, value);
+    auto r_lfu = replay(lfu, after, value);
+    cerr << "zipf 0.99 after scan: st_lru hits " << r_lru.hit_ratio << ", tinylfu hits " << r_lfu.hit_ratio << endl;
+}
@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+#include "storage/FrequencySketch.h"
+#include "storage/Hash.h"
+#include "storage/SimpleLRU.h"
+#include "storage/TinyLFU.h"
+
+#include "Trace.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+TEST(FrequencySketchTest, CountAndAge) {
+    FrequencySketch sketch(1024);
+
+    size_t hot = key_hash("hot"), cold = key_hash("cold");
+    for (int i = 0; i < 10; i++) {
+        sketch.increment(hot);
+    }
+    sketch.increment(cold);
+    EXPECT_EQ(10, sketch.estimate(hot));
+    EXPECT_EQ(1, sketch.estimate(cold));
+    EXPECT_EQ(0, sketch.estimate(key_hash("absent")));
+
+    // Counters saturate
+    for (int i = 0; i < 10; i++) {
+        sketch.increment(hot);
+    }
+    EXPECT_EQ(15, sketch.estimate(hot));
+
+    // History is halved after sample size increments
+    for (size_t i = 0; i < 10 * sketch.width(); i++) {
+        sketch.increment(key_hash("Key " + to_string(i)));
+    }
+    EXPECT_LE(sketch.estimate(hot), 7);
+}
+
+TEST(FrequencySketchTest, GrowKeepsHistory) {
+    FrequencySketch sketch(16);
+
+    vector<size_t> hashes;
+    for (int i = 0; i < 8; i++) {
+        hashes.push_back(key_hash("Key " + to_string(i)));
+        for (int j = 0; j <= i; j++) {
+            sketch.increment(hashes.back());
+        }
+    }
+    vector<unsigned> before;
+    for (size_t hash : hashes) {
+        before.push_back(sketch.estimate(hash));
+    }
+
+    sketch.grow(1024);
+    EXPECT_EQ(1024, sketch.width());
+    for (size_t i = 0; i < hashes.size(); i++) {
+        EXPECT_EQ(before[i], sketch.estimate(hashes[i]));
+    }
+}
+
+TEST(TinyLFUTest, PutGetDelete) {
+    TinyLFU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY2", "other"));
+    EXPECT_TRUE(storage.Set("KEY1", "val11"));
+    EXPECT_FALSE(storage.Set("KEY3", "val3"));
+
+    string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val11", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val2", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+}
+
+TEST(TinyLFUTest, ScanDoesNotEvictHotSet) {
+    TinyLFU storage(100 * 20);
+
+    // Hot set fills most of the cache and gets requested a few times
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < 80; i++) {
+            string key = "Hot " + to_string(i), value;
+            key.resize(10, ' ');
+            if (!storage.Get(key, value)) {
+                EXPECT_TRUE(storage.Put(key, string(10, 'h')));
+            }
+        }
+    }
+
+    // Scan of keys requested once, ten times larger than the cache
+    for (int i = 0; i < 1000; i++) {
+        string key = "Scan " + to_string(i), value;
+        key.resize(10, ' ');
+        if (!storage.Get(key, value)) {
+            EXPECT_TRUE(storage.Put(key, string(10, 's')));
+        }
+    }
+
+    // Hot entries that were still in the window or on probation compete with the scan as equals once
+    // their counters age, but the protected ones survive; LRU would lose all of them
+    int hits = 0;
+    for (int i = 0; i < 80; i++) {
+        string key = "Hot " + to_string(i), value;
+        key.resize(10, ' ');
+        hits += storage.Get(key, value);
+    }
+    EXPECT_GE(hits, 75);
+}
+
+// Hot set of zipf trace is interrupted by a scan over keys never requested again. LRU forgets the hot set,
+// TinyLFU keeps more of it because scan keys are not frequent enough to be admitted
+TEST(TinyLFUTest, ScanResistance) {
+    const size_t keys = 10000, length = 100000;
+    const string value(100, 'v');
+    size_t size = keys / 10 * (value.size() + 10);
+
+    auto before = zipf_trace(keys, length, 0.99, 1);
+    auto after = zipf_trace(keys, length, 0.99, 2);
+    vector<string> scan;
+    for (size_t i = 0; i < 2 * keys; i++) {
+        scan.push_back("Scan " + to_string(i));
+    }
+
+    SimpleLRU lru(size);
+    TinyLFU lfu(size);
+    replay(lru, before, value);
+    replay(lfu, before, value);
+    replay(lru, scan, value);
+    replay(lfu, scan, value);
+
+    // Only the first requests after the scan show the difference, later both caches refill with the hot set
+    vector<string> head(after.begin(), after.begin() + length / 10);
+    auto r_lru = replay(lru, head, value);
+    auto r_lfu = replay(lfu, head, value);
+    EXPECT_GT(r_lfu.hit_ratio, r_lru.hit_ratio);
+}
@@ -0,0 +1,54 @@
+#ifndef AFINA_TEST_STORAGE_TRACE_H
+#define AFINA_TEST_STORAGE_TRACE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+// Sequence of keys whose popularity follows zipf distribution: key of rank k is requested with
+// probability proportional to 1 / k^skew
+inline std::vector<std::string> zipf_trace(size_t keys, size_t length, double skew, unsigned seed = 0) {
+    std::vector<double> cdf(keys);
+    double sum = 0;
+    for (size_t k = 0; k < keys; k++) {
+        sum += 1.0 / std::pow(double(k + 1), skew);
+        cdf[k] = sum;
+    }
+
+    std::mt19937 rnd(seed);
+    std::uniform_real_distribution<double> dist(0, sum);
+    std::vector<std::string> trace;
+    trace.reserve(length);
+    for (size_t i = 0; i < length; i++) {
+        size_t rank = std::lower_bound(cdf.begin(), cdf.end(), dist(rnd)) - cdf.begin();
+        trace.push_back("Key " + std::to_string(rank));
+    }
+    return trace;
+}
+
+struct trace_result {
+    double hit_ratio;
+    double ns_per_op;
+};
+
+// Replays trace the way cache is normally used: get, and set on miss
+template <typename Storage> trace_result replay(Storage &storage, const std::vector<std::string> &trace,
+                                                const std::string &value) {
+    size_t hits = 0;
+    std::string got;
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string &key : trace) {
+        if (storage.Get(key, got)) {
+            hits++;
+        } else {
+            storage.Put(key, value);
+        }
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return trace_result{double(hits) / trace.size(), double(ns) / trace.size()};
+}
+
+#endif // AFINA_TEST_STORAGE_TRACE_H